@@ -29,11 +29,13 @@
 class BgColorSpecialHandler : public SpecialHandler {
 	public:
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* info () const override {return "background color special";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "bgcolor";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_BEGIN_PAGE;}
 
 	protected:
 		void dviBeginPage (unsigned pageno, SpecialActions &actions) override;
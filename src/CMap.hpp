@@ -80,6 +80,7 @@ struct UnicodeCMap : public CMap {
 
 
 class SegmentedCMap : public CMap {
+	friend class CMapCache;
 	friend class CMapReader;
 
 	public:
@@ -0,0 +1,154 @@
+/*************************************************************************
+** CMapCache.cpp                                                        **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <fstream>
+#include "CMap.hpp"
+#include "CMapCache.hpp"
+#include "CMapManager.hpp"
+#include "CMapReader.hpp"
+#include "FileSystem.hpp"
+#include "StreamReader.hpp"
+#include "StreamWriter.hpp"
+#include "XXHashFunction.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+const uint8_t CMapCache::FORMAT_VERSION = 1;
+
+
+/** Returns the path of the cache file of a CMap.
+ *  @param[in] name name of the CMap
+ *  @param[in] dir directory where the cache files are located */
+string CMapCache::filepath (const string &name, const string &dir) {
+	string dirstr = dir.empty() ? FileSystem::getcwd() : dir;
+	return dirstr + "/" + name + ".cmc";
+}
+
+
+static void write_ranges (const RangeMap &ranges, StreamWriter &sw, HashFunction &hashfunc) {
+	sw.writeUnsigned(ranges.numRanges(), 4, hashfunc);
+	for (size_t i=0; i < ranges.numRanges(); i++) {
+		sw.writeUnsigned(ranges.getRange(i).min(), 4, hashfunc);
+		sw.writeUnsigned(ranges.getRange(i).max(), 4, hashfunc);
+		sw.writeUnsigned(ranges.getRange(i).minval(), 4, hashfunc);
+	}
+}
+
+
+static void read_ranges (RangeMap &ranges, StreamReader &sr) {
+	// the ranges are stored in ascending order, so they are appended to the range vector
+	for (uint32_t num_ranges = sr.readUnsigned(4); num_ranges > 0 && !sr.eof(); num_ranges--) {
+		uint32_t min = sr.readUnsigned(4);
+		uint32_t max = sr.readUnsigned(4);
+		uint32_t minval = sr.readUnsigned(4);
+		ranges.addRange(min, max, minval);
+	}
+}
+
+
+/** Writes the data of a CMap to a stream.
+ *  @param[in] cmap CMap to be written
+ *  @param[in] srchash hash value of the CMap source data
+ *  @param[in] os output stream
+ *  @return true if writing was successful */
+bool CMapCache::write (const SegmentedCMap &cmap, const vector<uint8_t> &srchash, ostream &os) {
+	if (!os)
+		return false;
+	StreamWriter sw(os);
+	XXH32HashFunction hashfunc;
+	sw.writeUnsigned(FORMAT_VERSION, 1, hashfunc);
+	sw.writeBytes(hashfunc.digestBytes());  // space for checksum
+	sw.writeUnsigned(srchash.size(), 1, hashfunc);
+	sw.writeBytes(srchash);
+	hashfunc.update(srchash);
+	sw.writeString(cmap._filename, hashfunc, true);
+	sw.writeString(cmap._registry, hashfunc, true);
+	sw.writeString(cmap._ordering, hashfunc, true);
+	sw.writeString(cmap._cmaptype, hashfunc, true);
+	sw.writeString(cmap._basemap ? cmap._basemap->name() : "", hashfunc, true);
+	sw.writeUnsigned((cmap._vertical ? 1 : 0) | (cmap._mapsToCID ? 2 : 0), 1, hashfunc);
+	write_ranges(cmap._cidranges, sw, hashfunc);
+	write_ranges(cmap._bfranges, sw, hashfunc);
+	os.seekp(1);
+	sw.writeBytes(hashfunc.digestBytes());  // insert checksum
+	os.seekp(0, ios::end);
+	return bool(os);
+}
+
+
+/** Writes the data of a CMap to its cache file.
+ *  @param[in] cmap CMap to be written
+ *  @param[in] srchash hash value of the CMap source data
+ *  @param[in] dir directory where the cache file should go
+ *  @return true if writing was successful */
+bool CMapCache::write (const SegmentedCMap &cmap, const vector<uint8_t> &srchash, const string &dir) {
+	ofstream ofs(filepath(cmap.name(), dir), ios::binary);
+	return write(cmap, srchash, ofs);
+}
+
+
+/** Reads the data of a CMap from a stream. CMaps referenced by the cached
+ *  CMap are retrieved from the CMapManager.
+ *  @param[in] name name of the CMap to read
+ *  @param[in] srchash hash value of the current CMap source data
+ *  @param[in] is input stream to read the CMap from
+ *  @return the CMap read or nullptr if the cache data is invalid or outdated */
+unique_ptr<SegmentedCMap> CMapCache::read (const string &name, const vector<uint8_t> &srchash, istream &is) {
+	if (!is)
+		return nullptr;
+	StreamReader sr(is);
+	XXH32HashFunction hashfunc;
+	if (sr.readUnsigned(1, hashfunc) != FORMAT_VERSION)
+		return nullptr;
+	auto hashcmp = sr.readBytes(hashfunc.digestSize());
+	hashfunc.update(is);
+	if (hashfunc.digestBytes() != hashcmp)
+		return nullptr;
+	is.clear();
+	is.seekg(hashfunc.digestSize()+1);  // continue reading after checksum
+
+	if (sr.readBytes(sr.readUnsigned(1)) != srchash || sr.readString() != name)
+		return nullptr;
+	auto cmap = util::make_unique<SegmentedCMap>(name);
+	cmap->_registry = sr.readString();
+	cmap->_ordering = sr.readString();
+	cmap->_cmaptype = sr.readString();
+	string basename = sr.readString();
+	int flags = sr.readUnsigned(1);
+	cmap->_vertical = (flags & 1) != 0;
+	cmap->_mapsToCID = (flags & 2) != 0;
+	read_ranges(cmap->_cidranges, sr);
+	read_ranges(cmap->_bfranges, sr);
+	if (!basename.empty() && (cmap->_basemap = CMapManager::instance().lookup(basename)) == nullptr)
+		throw CMapReaderException("CMap file '"+basename+"' not found");
+	return cmap;
+}
+
+
+/** Reads the data of a CMap from its cache file.
+ *  @param[in] name name of the CMap to read
+ *  @param[in] srchash hash value of the current CMap source data
+ *  @param[in] dir directory where the cache files are located
+ *  @return the CMap read or nullptr if there's no valid cache file */
+unique_ptr<SegmentedCMap> CMapCache::read (const string &name, const vector<uint8_t> &srchash, const string &dir) {
+	ifstream ifs(filepath(name, dir), ios::binary);
+	return read(name, srchash, ifs);
+}
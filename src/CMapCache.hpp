@@ -0,0 +1,51 @@
+/*************************************************************************
+** CMapCache.hpp                                                        **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef CMAPCACHE_HPP
+#define CMAPCACHE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class SegmentedCMap;
+
+/** Reads and writes precompiled CMap data. Parsing large PostScript CMap files,
+ *  like those of the Adobe-Japan1 collection, is rather slow. Therefore, the
+ *  parsed range tables are stored in a compact binary format that can be loaded
+ *  much faster. Each cache file is tagged with a hash of the CMap source so that
+ *  outdated entries are detected and rebuilt. CMaps referenced by "usecmap" are
+ *  cached separately and only referred to by name. */
+class CMapCache {
+	public:
+		static std::unique_ptr<SegmentedCMap> read (const std::string &name, const std::vector<uint8_t> &srchash, std::istream &is);
+		static std::unique_ptr<SegmentedCMap> read (const std::string &name, const std::vector<uint8_t> &srchash, const std::string &dir);
+		static bool write (const SegmentedCMap &cmap, const std::vector<uint8_t> &srchash, std::ostream &os);
+		static bool write (const SegmentedCMap &cmap, const std::vector<uint8_t> &srchash, const std::string &dir);
+		static std::string filepath (const std::string &name, const std::string &dir);
+
+	private:
+		static const uint8_t FORMAT_VERSION;
+};
+
+#endif
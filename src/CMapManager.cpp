@@ -19,13 +19,15 @@
 *************************************************************************/
 
 #include <array>
-#include <sstream>
+#include <fstream>
 #include "CMap.hpp"
+#include "CMapCache.hpp"
 #include "CMapManager.hpp"
 #include "CMapReader.hpp"
 #include "FileFinder.hpp"
 #include "Font.hpp"
 #include "Message.hpp"
+#include "XXHashFunction.hpp"
 
 using namespace std;
 
@@ -67,8 +69,7 @@ CMap* CMapManager::lookup (const string &name) {
 	_level++;                     // increase nesting level
 	CMap *ret=nullptr;
 	try {
-		CMapReader reader;
-		if (!(cmap_ptr = reader.read(name))) {
+		if (!(cmap_ptr = load(name))) {
 			_level = 1;
 			Message::wstream(true) << "CMap file '" << name << "' not found\n";
 		}
@@ -84,6 +85,37 @@ CMap* CMapManager::lookup (const string &name) {
 }
 
 
+/** Reads a CMap file. If caching is enabled, the CMap is loaded from a precompiled
+ *  cache file if present and up to date. Otherwise, the CMap file is parsed and
+ *  the resulting data is added to the cache. In order to detect outdated cache
+ *  files, the CMap source is hashed on every call. Even for large CMaps, this
+ *  is much faster than parsing the PostScript code, which the cache avoids.
+ *  @param[in] name name of the CMap to load
+ *  @return the CMap read or nullptr if the CMap file could not be found */
+unique_ptr<CMap> CMapManager::load (const string &name) const {
+	if (PhysicalFont::CACHE_PATH.empty())
+		return CMapReader().read(name);
+
+	const char *path = FileFinder::instance().lookup(name, "cmap", false);
+	ifstream ifs;
+	if (path)
+		ifs.open(path);
+	if (!ifs)
+		return nullptr;
+	XXH64HashFunction hashfunc;
+	hashfunc.update(ifs);
+	const auto srchash = hashfunc.digestBytes();
+	if (auto cmap = CMapCache::read(name, srchash, PhysicalFont::CACHE_PATH))
+		return cmap;
+	ifs.clear();
+	ifs.seekg(0);  // parse the CMap source from the beginning
+	auto cmap = CMapReader().read(ifs, name);
+	if (auto segmentedCMap = dynamic_cast<const SegmentedCMap*>(cmap.get()))
+		CMapCache::write(*segmentedCMap, srchash, PhysicalFont::CACHE_PATH);
+	return cmap;
+}
+
+
 /** Looks for a base font CMap and a compatible encoding table in a given font. The CMap describe
  *  the mapping from CIDs to character codes where the latter are relative to the encoding table
  *  identified by charmapID.
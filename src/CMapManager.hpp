@@ -41,6 +41,7 @@ class CMapManager
 
 	protected:
 		CMapManager () : _level(0) {}
+		std::unique_ptr<CMap> load (const std::string &name) const;
 
 	private:
 		std::unordered_map<std::string, std::unique_ptr<CMap>> _cmaps;  ///< loaded cmaps
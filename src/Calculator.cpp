@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
@@ -26,35 +27,55 @@
 using namespace std;
 
 /** Evaluates a given arithmetic expression and returns its value.
- *  The evaluator is implemented as a recursive descent parser.
  *  @param[in] is reads expression from this stream
  *  @return expression value */
 double Calculator::eval (istream &is) const {
-	double ret = expr(is, false);
+	return compile(is).eval();
+}
+
+
+/** Evaluates a given arithmetic expression and returns its value.
+ *  @param[in] expr expression to evaluate
+ *  @return expression value */
+double Calculator::eval (const string &expr) const {
+	istringstream iss;
+	iss.str(expr);
+	return eval(iss);
+}
+
+
+/** Compiles a given arithmetic expression so that it can be evaluated repeatedly.
+ *  The compiler is implemented as a recursive descent parser. Variables whose names are
+ *  listed in slotNames are bound to the slot given by their index in the list. All other
+ *  variables must already be defined, and their current values are compiled into the
+ *  expression as constants.
+ *  @param[in] is reads expression from this stream
+ *  @param[in] slotNames names of the variables to be bound to slots
+ *  @return compiled expression */
+Calculator::Expression Calculator::compile (istream &is, const SlotNames &slotNames) const {
+	Expression e;
+	expr(is, false, e, slotNames);
 	try {
-		// check if expression has been fully evaluated (next token is of type bool)
+		// check if expression has been fully processed (next token is of type bool)
 		mpark::get<bool>(lookAhead(is));
 	}
 	catch (mpark::bad_variant_access &e) {
 		throw CalculatorException("expression syntax error");
 	}
-	return ret;
+	return e;
 }
 
 
-/** Evaluates a given arithmetic expression and returns its value.
- *  @param[in] expr expression to evaluate
- *  @return expression value */
-double Calculator::eval (const string &expr) const {
+Calculator::Expression Calculator::compile (const string &expr, const SlotNames &slotNames) const {
 	istringstream iss;
 	iss.str(expr);
-	return eval(iss);
+	return compile(iss, slotNames);
 }
 
 
-/** Evaluates the root rule of the expression grammar. */
-double Calculator::expr (istream &is, bool skip) const {    // expr:
-	double left = term(is, skip);
+/** Compiles the root rule of the expression grammar. */
+void Calculator::expr (istream &is, bool skip, Expression &e, const SlotNames &slotNames) const {    // expr:
+	term(is, skip, e, slotNames);
 	bool ready=false;
 	while (!ready) {
 		Token token = lookAhead(is);
@@ -63,18 +84,17 @@ double Calculator::expr (istream &is, bool skip) const {    // expr:
 			ready = true;
 		else {
 			switch (*op) {
-				case '+': left += term(is, true); break;  // term '+' term => $1 + $3
-				case '-': left -= term(is, true); break;  // term '-' term => $1 - $3
+				case '+': term(is, true, e, slotNames); e.append(Expression::Opcode::ADD); break;  // term '+' term => $1 + $3
+				case '-': term(is, true, e, slotNames); e.append(Expression::Opcode::SUB); break;  // term '-' term => $1 - $3
 				default : ready = true;
 			}
 		}
 	}
-	return left;  // term => $1
 }
 
 
-double Calculator::term (istream &is, bool skip) const {    // term:
-	double left = prim(is, skip);
+void Calculator::term (istream &is, bool skip, Expression &e, const SlotNames &slotNames) const {    // term:
+	prim(is, skip, e, slotNames);
 	bool ready=false;
 	while (!ready) {
 		Token token = lookAhead(is);
@@ -83,51 +103,44 @@ double Calculator::term (istream &is, bool skip) const {    // term:
 			ready = true;
 		else {
 			switch (*op) {
-				case '*': left *= prim(is, true); break;  // prim '*' prim => $1 * $3
-				case '(': left *= prim(is, false); break; // prim '(' prim => $1 * $3
-				case '/': {                               // prim '/' prim => $1 / $3
-					double denom = prim(is, true);
-					if (denom == 0)
-						throw CalculatorException("division by zero");
-					left /= denom;
-					break;
-				}
-				case '%': {                               // prim '%' prim => $1 mod $3
-					double denom = prim(is, true);
-					if (denom == 0)
-						throw CalculatorException("division by zero");
-					left -= denom * floor(left / denom);
-					break;
-				}
+				case '*': prim(is, true, e, slotNames);  e.append(Expression::Opcode::MUL); break; // prim '*' prim => $1 * $3
+				case '(': prim(is, false, e, slotNames); e.append(Expression::Opcode::MUL); break; // prim '(' prim => $1 * $3
+				case '/': prim(is, true, e, slotNames);  e.append(Expression::Opcode::DIV); break; // prim '/' prim => $1 / $3
+				case '%': prim(is, true, e, slotNames);  e.append(Expression::Opcode::MOD); break; // prim '%' prim => $1 mod $3
 				default:
 					ready = true;
 			}
 		}
 	}
-	return left;
 }
 
 
-/** Evaluates a primary expression of the grammar which doesn't contain any binary operators. */
-double Calculator::prim (istream &is, bool skip) const { // prim:
+/** Compiles a primary expression of the grammar which doesn't contain any binary operators. */
+void Calculator::prim (istream &is, bool skip, Expression &e, const SlotNames &slotNames) const { // prim:
 	if (skip)
 		lex(is);
 	Token token = lookAhead(is);
 	if (mpark::get_if<double>(&token)) {               //  NUMBER => $1
-		double ret = mpark::get<double>(lex(is));
+		e.append(Expression::Opcode::PUSH_CONST, mpark::get<double>(lex(is)));
 		token = lookAhead(is);
-		if (mpark::get_if<string>(&token))              // NUMBER STRING => $1 * $2
-			ret *= getVariable(mpark::get<string>(lex(is)));
-		return ret;
+		if (mpark::get_if<string>(&token)) {            // NUMBER STRING => $1 * $2
+			variable(mpark::get<string>(lex(is)), e, slotNames);
+			e.append(Expression::Opcode::MUL);
+		}
+		return;
+	}
+	if (mpark::get_if<string>(&token)) {               // STRING => getVariable($1)
+		variable(mpark::get<string>(lex(is)), e, slotNames);
+		return;
 	}
-	if (mpark::get_if<string>(&token))                 // STRING => getVariable($1)
-		return getVariable(mpark::get<string>(lex(is)));
 	if (char *op = mpark::get_if<char>(&token)) {
 		switch (*op) {
 			case '-':                                    // '-' prim => -$2
-				return -prim(is, true);
+				prim(is, true, e, slotNames);
+				e.append(Expression::Opcode::NEG);
+				return;
 			case '(': {                                  // '(' expr ')' => $2
-				double e = expr(is, true);
+				expr(is, true, e, slotNames);
 				try {
 					if (mpark::get<char>(lookAhead(is)) != ')')
 						throw CalculatorException("')' expected");
@@ -136,7 +149,7 @@ double Calculator::prim (istream &is, bool skip) const { // prim:
 					throw CalculatorException("')' expected");
 				}
 				is.get();   // skip processed char
-				return e;
+				return;
 			}
 		}
 	}
@@ -144,6 +157,19 @@ double Calculator::prim (istream &is, bool skip) const { // prim:
 }
 
 
+/** Appends the instruction that pushes the value of a variable to a compiled expression.
+ *  @param[in] name name of variable
+ *  @param[in,out] e expression to extend
+ *  @param[in] slotNames names of the variables bound to slots */
+void Calculator::variable (const string &name, Expression &e, const SlotNames &slotNames) const {
+	auto it = find(slotNames.begin(), slotNames.end(), name);
+	if (it != slotNames.end())
+		e.append(Expression::Opcode::PUSH_SLOT, double(it-slotNames.begin()));
+	else
+		e.append(Expression::Opcode::PUSH_CONST, getVariable(name));
+}
+
+
 /** Returns the value of a previously defined variable. If there
  *  is no variable of the given name, a CalculatorException is thrown.
  *  @param[in] name name of variable
@@ -200,3 +226,80 @@ Calculator::Token Calculator::lex (istream &is) {
 	}
 	return token;
 }
+
+
+/** Appends an instruction to the expression. Operations on constant operands are
+ *  folded into a single constant unless they would fail, e.g. due to a division by zero. */
+void Calculator::Expression::append (Opcode opcode, double value) {
+	size_t size = _code.size();
+	if (opcode == Opcode::NEG && size > 0 && _code[size-1].opcode == Opcode::PUSH_CONST) {
+		_code[size-1].value = -_code[size-1].value;
+		return;
+	}
+	if (opcode != Opcode::PUSH_CONST && opcode != Opcode::PUSH_SLOT && opcode != Opcode::NEG
+		&& size > 1 && _code[size-1].opcode == Opcode::PUSH_CONST && _code[size-2].opcode == Opcode::PUSH_CONST
+		&& !((opcode == Opcode::DIV || opcode == Opcode::MOD) && _code[size-1].value == 0))
+	{
+		double &left = _code[size-2].value;
+		double right = _code[size-1].value;
+		switch (opcode) {
+			case Opcode::ADD: left += right; break;
+			case Opcode::SUB: left -= right; break;
+			case Opcode::MUL: left *= right; break;
+			case Opcode::DIV: left /= right; break;
+			case Opcode::MOD: left -= right * floor(left / right); break;
+			default: break;
+		}
+		_code.pop_back();
+		return;
+	}
+	_code.emplace_back(opcode, value);
+}
+
+
+/** Evaluates the compiled expression.
+ *  @param[in] slotValues values of the variables bound to slots
+ *  @return expression value */
+double Calculator::Expression::eval (const vector<double> &slotValues) const {
+	vector<double> stack;
+	stack.reserve(_code.size());
+	for (const Instruction &instr : _code) {
+		switch (instr.opcode) {
+			case Opcode::PUSH_CONST:
+				stack.push_back(instr.value);
+				break;
+			case Opcode::PUSH_SLOT: {
+				size_t slot = size_t(instr.value);
+				if (slot >= slotValues.size())
+					throw CalculatorException("undefined variable");
+				stack.push_back(slotValues[slot]);
+				break;
+			}
+			case Opcode::NEG:
+				stack.back() = -stack.back();
+				break;
+			default: {
+				double right = stack.back();
+				stack.pop_back();
+				double &left = stack.back();
+				switch (instr.opcode) {
+					case Opcode::ADD: left += right; break;
+					case Opcode::SUB: left -= right; break;
+					case Opcode::MUL: left *= right; break;
+					case Opcode::DIV:
+						if (right == 0)
+							throw CalculatorException("division by zero");
+						left /= right;
+						break;
+					case Opcode::MOD:
+						if (right == 0)
+							throw CalculatorException("division by zero");
+						left -= right * floor(left / right);
+						break;
+					default: break;
+				}
+			}
+		}
+	}
+	return stack.empty() ? 0 : stack.back();
+}
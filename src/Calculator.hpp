@@ -24,6 +24,7 @@
 #include <istream>
 #include <map>
 #include <string>
+#include <vector>
 #include <mpark/variant.hpp>
 #include "MessageException.hpp"
 
@@ -32,16 +33,48 @@ struct CalculatorException : public MessageException {
 };
 
 class Calculator {
+	public:
+		/** Arithmetic expression compiled into a sequence of instructions of a simple
+		 *  stack machine. Variables bound to slots during the compilation are not
+		 *  resolved until evaluation, where their values are taken from a given vector.
+		 *  This way, an expression can be evaluated repeatedly without being parsed again. */
+		class Expression {
+			friend class Calculator;
+			public:
+				Expression () =default;
+				explicit Expression (double value) {append(Opcode::PUSH_CONST, value);}
+				double eval (const std::vector<double> &slotValues={}) const;
+				bool empty () const {return _code.empty();}
+
+			protected:
+				enum class Opcode {PUSH_CONST, PUSH_SLOT, ADD, SUB, MUL, DIV, MOD, NEG};
+
+				struct Instruction {
+					Instruction (Opcode opc, double val) : opcode(opc), value(val) {}
+					Opcode opcode;
+					double value;  ///< constant value or slot index
+				};
+
+				void append (Opcode opcode, double value=0);
+
+			private:
+				std::vector<Instruction> _code;
+		};
+
 	public:
 		double eval (std::istream &is) const;
 		double eval (const std::string &expr) const;
+		Expression compile (std::istream &is, const std::vector<std::string> &slotNames={}) const;
+		Expression compile (const std::string &expr, const std::vector<std::string> &slotNames={}) const;
 		void setVariable (const std::string &name, double value) {_variables[name] = value;}
 		double getVariable (const std::string &name) const;
 
 	protected:
-		double expr (std::istream &is, bool skip) const;
-		double term (std::istream &is, bool skip) const;
-		double prim (std::istream &is, bool skip) const;
+		using SlotNames = std::vector<std::string>;
+		void expr (std::istream &is, bool skip, Expression &e, const SlotNames &slotNames) const;
+		void term (std::istream &is, bool skip, Expression &e, const SlotNames &slotNames) const;
+		void prim (std::istream &is, bool skip, Expression &e, const SlotNames &slotNames) const;
+		void variable (const std::string &name, Expression &e, const SlotNames &slotNames) const;
 
 		using Token = mpark::variant<bool, char, double, std::string>;
 		static Token lex (std::istream &is);
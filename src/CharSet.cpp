@@ -0,0 +1,158 @@
+/*************************************************************************
+** CharSet.cpp                                                          **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <algorithm>
+#include "CharSet.hpp"
+
+using namespace std;
+
+constexpr int CharSet::MAX_BITS;
+
+
+CharSet::CharSet (initializer_list<int> chars) {
+	for (int c : chars)
+		insert(c);
+}
+
+
+/** Adds a character code to the set.
+ *  @param[in] c character code to add
+ *  @return true if the code was added, false if it was already present */
+bool CharSet::insert (int c) {
+	if (c >= 0 && c < MAX_BITS) {
+		size_t index = size_t(c)/64;
+		uint64_t mask = uint64_t(1) << (c%64);
+		if (index >= _bits.size())
+			_bits.resize(index+1, 0);
+		else if (_bits[index] & mask)
+			return false;
+		_bits[index] |= mask;
+	}
+	else {
+		auto it = lower_bound(_sparse.begin(), _sparse.end(), c);
+		if (it != _sparse.end() && *it == c)
+			return false;
+		_sparse.insert(it, c);
+	}
+	++_size;
+	return true;
+}
+
+
+/** Adds all character codes of another set to this one. */
+void CharSet::insert (const CharSet &charset) {
+	if (_bits.size() < charset._bits.size())
+		_bits.resize(charset._bits.size(), 0);
+	for (size_t i=0; i < charset._bits.size(); i++) {
+		for (uint64_t added = charset._bits[i] & ~_bits[i]; added; added &= added-1)
+			++_size;
+		_bits[i] |= charset._bits[i];
+	}
+	for (int c : charset._sparse)
+		insert(c);
+}
+
+
+bool CharSet::contains (int c) const {
+	if (c >= 0 && c < MAX_BITS) {
+		size_t index = size_t(c)/64;
+		return index < _bits.size() && (_bits[index] & (uint64_t(1) << (c%64)));
+	}
+	return binary_search(_sparse.begin(), _sparse.end(), c);
+}
+
+
+void CharSet::clear () {
+	_bits.clear();
+	_sparse.clear();
+	_size = 0;
+}
+
+
+CharSet::Iterator CharSet::begin () const {
+	if (numNegativeSparse() > 0)
+		return Iterator(*this, 0, 0);
+	return Iterator(*this, nextBit(0), 0);
+}
+
+
+bool CharSet::operator == (const CharSet &charset) const {
+	if (_size != charset._size || _sparse != charset._sparse)
+		return false;
+	const vector<uint64_t> &bits1 = _bits.size() <= charset._bits.size() ? _bits : charset._bits;
+	const vector<uint64_t> &bits2 = _bits.size() <= charset._bits.size() ? charset._bits : _bits;
+	return equal(bits1.begin(), bits1.end(), bits2.begin())
+		&& all_of(bits2.begin()+bits1.size(), bits2.end(), [](uint64_t word) {return word == 0;});
+}
+
+
+/** Returns the position of the first set bit at or after a given position.
+ *  If there's no such bit, the total number of bits is returned. */
+size_t CharSet::nextBit (size_t pos) const {
+	size_t index = pos/64;
+	if (index < _bits.size()) {
+		uint64_t word = _bits[index] >> (pos%64);
+		if (word == 0) {
+			while (++index < _bits.size() && _bits[index] == 0);
+			if (index == _bits.size())
+				return numBits();
+			pos = index*64;
+			word = _bits[index];
+		}
+		for (; (word & 1) == 0; word >>= 1)
+			++pos;
+		return pos;
+	}
+	return numBits();
+}
+
+
+/** Returns the number of negative codes present in the set. */
+size_t CharSet::numNegativeSparse () const {
+	return lower_bound(_sparse.begin(), _sparse.end(), 0) - _sparse.begin();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+/** Returns true if the iterator currently points to a code stored in the bit vector. */
+bool CharSet::Iterator::atBit () const {
+	return _bitpos < _charset->numBits() && _index == _charset->numNegativeSparse();
+}
+
+
+int CharSet::Iterator::operator * () const {
+	return atBit() ? int(_bitpos) : _charset->_sparse[_index];
+}
+
+
+CharSet::Iterator& CharSet::Iterator::operator ++ () {
+	if (atBit())
+		_bitpos = _charset->nextBit(_bitpos+1);
+	else if (++_index == _charset->numNegativeSparse())  // passed the last negative code?
+		_bitpos = _charset->nextBit(0);
+	return *this;
+}
+
+
+CharSet::Iterator CharSet::Iterator::operator ++ (int) {
+	Iterator it = *this;
+	++(*this);
+	return it;
+}
@@ -0,0 +1,89 @@
+/*************************************************************************
+** CharSet.hpp                                                          **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef CHARSET_HPP
+#define CHARSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+/** Set of character codes, e.g. the characters of a font used in a document.
+ *  Codes in the range [0, MAX_BITS) are represented by a bit vector so that
+ *  inserting and looking up characters takes constant time even for fonts with
+ *  thousands of used glyphs. The few codes outside this range, if any, are kept
+ *  in a sorted vector. Iterating over the set yields the codes in ascending order. */
+class CharSet {
+	public:
+		class Iterator {
+			friend class CharSet;
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = int;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const int*;
+				using reference = int;
+
+				int operator * () const;
+				Iterator& operator ++ ();
+				Iterator operator ++ (int);
+				bool operator == (const Iterator &it) const {return _bitpos == it._bitpos && _index == it._index;}
+				bool operator != (const Iterator &it) const {return !(*this == it);}
+
+			protected:
+				Iterator (const CharSet &charset, size_t bitpos, size_t index) : _charset(&charset), _bitpos(bitpos), _index(index) {}
+				bool atBit () const;
+
+			private:
+				const CharSet *_charset;
+				size_t _bitpos;  ///< position of the current bit (number of bits if beyond the bit vector)
+				size_t _index;   ///< index of the current entry in the vector of sparse codes
+		};
+
+	public:
+		CharSet () =default;
+		CharSet (std::initializer_list<int> chars);
+		bool insert (int c);
+		void insert (const CharSet &charset);
+		bool contains (int c) const;
+		size_t size () const   {return _size;}
+		bool empty () const    {return _size == 0;}
+		void clear ();
+		Iterator begin () const;
+		Iterator end () const  {return Iterator(*this, numBits(), _sparse.size());}
+		bool operator == (const CharSet &charset) const;
+		bool operator != (const CharSet &charset) const {return !(*this == charset);}
+
+		static constexpr int MAX_BITS = 0x110000;  ///< codes below this value are stored in the bit vector
+
+	protected:
+		size_t numBits () const {return _bits.size()*64;}
+		size_t nextBit (size_t pos) const;
+		size_t numNegativeSparse () const;
+
+	private:
+		std::vector<uint64_t> _bits;  ///< bit vector representing the codes in [0, MAX_BITS)
+		std::vector<int> _sparse;     ///< sorted codes outside [0, MAX_BITS)
+		size_t _size=0;               ///< number of codes in the set
+};
+
+#endif
@@ -22,58 +22,57 @@
 #include <sstream>
 #include <vector>
 #include "ColorSpecialHandler.hpp"
+#include "InputReader.hpp"
 #include "SpecialActions.hpp"
 
 using namespace std;
 
 
-static double read_double (istream &is) {
-	is.clear();
+static double read_double (InputReader &ir) {
 	double v;
-	is >> v;
-	if (is.fail())
+	if (!ir.parseDouble(v))
 		throw SpecialException("number expected");
 	return v;
 }
 
 
-/** Reads multiple double values from a given stream. The number of
+/** Reads multiple double values from a given input reader. The number of
  *  values read is determined by the size of the result vector.
- *  @param[in]  is stream to be read from
+ *  @param[in]  ir reader to read from
  *  @param[out] vec the resulting values */
-static void read_doubles (istream &is, vector<double> &vec) {
+static void read_doubles (InputReader &ir, vector<double> &vec) {
 	for (double &val : vec)
-		val = read_double(is);
+		val = read_double(ir);
 }
 
 
-/** Reads a color statement from an input stream and converts it to a color object.
+/** Reads a color statement from an input reader and converts it to a color object.
  *  A color statement has the following syntax:
  *  _color model_ _component values_
  *  Currently, the following color models are supported: rgb, cmyk, hsb and gray.
  *  Examples: rgb 1 0.5 0, gray 0.5
  *  @param[in] model the color model
- *  @param[in] is stream to be read from
+ *  @param[in] ir reader to read from
  *  @return resulting Color object */
-Color ColorSpecialHandler::readColor (const string &model, istream &is) {
+Color ColorSpecialHandler::readColor (const string &model, InputReader &ir) {
 	Color color;
 	if (model == "rgb") {
 		vector<double> rgb(3);
-		read_doubles(is, rgb);
+		read_doubles(ir, rgb);
 		color.setRGB(rgb[0], rgb[1], rgb[2]);
 	}
 	else if (model == "cmyk") {
 		vector<double> cmyk(4);
-		read_doubles(is, cmyk);
+		read_doubles(ir, cmyk);
 		color.setCMYK(cmyk[0], cmyk[1], cmyk[2], cmyk[3]);
 	}
 	else if (model == "hsb") {
 		vector<double> hsb(3);
-		read_doubles(is, hsb);
+		read_doubles(ir, hsb);
 		color.setHSB(hsb[0], hsb[1], hsb[2]);
 	}
 	else if (model == "gray")
-		color.setGray(read_double(is));
+		color.setGray(read_double(ir));
 	else if (!color.setPSName(model, true))
 		throw SpecialException("unknown color statement");
 	return color;
@@ -81,34 +80,59 @@ Color ColorSpecialHandler::readColor (const string &model, istream &is) {
 
 
 /** Reads the color model (rgb, cmyk, hsb, or gray) and the corresponding color components
- *  from a given input stream.
- *  @param[in] is stream to be read from
+ *  from a given input reader.
+ *  @param[in] ir reader to read from
  *  @return resulting Color object */
+Color ColorSpecialHandler::readColor (InputReader &ir) {
+	string model = ir.getString();
+	return readColor(model, ir);
+}
+
+
+Color ColorSpecialHandler::readColor (const string &model, istream &is) {
+	StreamInputReader ir(is);
+	return readColor(model, ir);
+}
+
+
 Color ColorSpecialHandler::readColor (istream &is) {
-	string model;
-	is >> model;
-	return readColor(model, is);
+	StreamInputReader ir(is);
+	return readColor(ir);
 }
 
 
 bool ColorSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
+	StreamInputReader ir(is);
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+bool ColorSpecialHandler::processText (const string&, CharInputReader &ir, SpecialActions &actions) {
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+/** Evaluates a color special statement and updates the current colors accordingly.
+ *  @param[in] ir reader providing the special statement following the prefix
+ *  @param[in] actions actions the special handler can perform */
+void ColorSpecialHandler::processSpecial (InputReader &ir, SpecialActions &actions) {
 	char colortype=0;
-	auto pos = is.tellg();
-	string cmd;
-	is >> cmd;
+	string cmd = ir.getString();
 	if (cmd == "push")               // color push [fill|stroke] <model> <params>
-		colortype = processPush(is);
+		colortype = processPush(ir);
 	else if (cmd == "pop") {
 		if (!_colorStack.empty())     // color pop
 			_colorStack.pop_back();
 	}
 	else if (cmd == "set")           // color set [fill|stroke] <model> <params>
-		colortype = processSet(is);
+		colortype = processSet(ir);
 	else {                           // color [fill|stroke] <model> <params>
 		while (!_colorStack.empty())
 			_colorStack.pop_back();
-		is.seekg(pos);
-		colortype = processPush(is);
+		_colorStack.emplace_back(ColorPair{});
+		colortype = setColor(cmd, ir);
 	}
 	if (_colorStack.empty()) {
 		if (colortype == 0 || colortype == 'f')
@@ -122,27 +146,25 @@ bool ColorSpecialHandler::process (const string&, istream &is, SpecialActions &a
 		if (colortype == 0 || colortype == 's')
 			actions.setStrokeColor(_colorStack.back().strokeColor);
 	}
-	return true;
 }
 
 
 /** Parses [fill|stroke] <model> <params>.
- *  @param[in] is stream to read from
+ *  @param[in] token the first token of the statement (fill, stroke, or the color model)
+ *  @param[in] ir reader providing the remaining part of the statement
  *  @param[out] type specified type color type ('f'=fill, 's'=stroke, 0=none specified)
  *  @return color object representing the specified color */
-static Color read_color_and_type (istream &is, char &type) {
-	string token;
+static Color read_color_and_type (string token, InputReader &ir, char &type) {
 	string model;
-	is >> token;
 	if (token == "fill" || token == "stroke") {
-		is >> model;
+		model = ir.getString();
 		type = token[0];
 	}
 	else {
 		model = std::move(token);
 		type = '\0';
 	}
-	return ColorSpecialHandler::readColor(model, is);
+	return ColorSpecialHandler::readColor(model, ir);
 }
 
 
@@ -150,9 +172,9 @@ static Color read_color_and_type (istream &is, char &type) {
  *  onto the stack. If 'fill' or 'stroke' is specified, only that color value is set.
  *  The other one is copied from the current corresponding value.
  *  @return color type specified in the special command ('f'=fill, 's'=stroke, 0=none specified) */
-char ColorSpecialHandler::processPush (istream &is) {
+char ColorSpecialHandler::processPush (InputReader &ir) {
 	_colorStack.emplace_back(ColorPair{});
-	return processSet(is);
+	return processSet(ir);
 }
 
 
@@ -160,9 +182,19 @@ char ColorSpecialHandler::processPush (istream &is) {
  *  color pair without pushing new ones. If the stack is empty, the default
  *  color values (usually black) are changed.
  *  @return color type specified in the special command ('f'=fill, 's'=stroke, 0=none specified) */
-char ColorSpecialHandler::processSet (istream &is) {
+char ColorSpecialHandler::processSet (InputReader &ir) {
+	string token = ir.getString();
+	return setColor(token, ir);
+}
+
+
+/** Changes the current color pair according to [fill|stroke] <model> <params>.
+ *  @param[in] token the first token of the statement (fill, stroke, or the color model)
+ *  @param[in] ir reader providing the remaining part of the statement
+ *  @return color type specified in the special command ('f'=fill, 's'=stroke, 0=none specified) */
+char ColorSpecialHandler::setColor (const string &token, InputReader &ir) {
 	char type;
-	Color color = read_color_and_type(is, type);
+	Color color = read_color_and_type(token, ir, type);
 	Color &fillColor = _colorStack.empty() ? _defaultFillColor : _colorStack.back().fillColor;
 	Color &strokeColor = _colorStack.empty() ? _defaultStrokeColor : _colorStack.back().strokeColor;
 	if (type == 0 || type == 'f')
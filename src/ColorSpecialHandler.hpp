@@ -27,6 +27,8 @@
 #include "Color.hpp"
 #include "SpecialHandler.hpp"
 
+class InputReader;
+
 
 class ColorSpecialHandler : public SpecialHandler {
 	private:
@@ -37,6 +39,9 @@ class ColorSpecialHandler : public SpecialHandler {
 
 	public:
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool processText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions) override;
+		static Color readColor (InputReader &ir);
+		static Color readColor (const std::string &model, InputReader &ir);
 		static Color readColor (std::istream &is);
 		static Color readColor (const std::string &model, std::istream &is);
 		const char* name () const override {return handlerName();}
@@ -46,8 +51,10 @@ class ColorSpecialHandler : public SpecialHandler {
 		size_t stackSize () const {return _colorStack.size();}
 
 	protected:
-		char processPush (std::istream &is);
-		char processSet (std::istream &is);
+		void processSpecial (InputReader &ir, SpecialActions &actions);
+		char processPush (InputReader &ir);
+		char processSet (InputReader &ir);
+		char setColor (const std::string &token, InputReader &ir);
 
 	private:
 		Color _defaultFillColor = Color::BLACK;
@@ -39,7 +39,9 @@ class CommandLine : public CL::CommandLine {
 		Option debugGlyphsOpt {"debug-glyphs", '\0', "create PS files for all glyphs converted to TTF"};
 		Option embedBitmapsOpt {"embed-bitmaps", '\0', "prevent references to external bitmap files"};
 		Option epsOpt {"eps", 'E', "convert EPS file to SVG"};
+		TypedOption<std::string, Option::ArgMode::REQUIRED> eventsOpt {"events", '\0', "target", "write progress events in JSON format to a file or file descriptor (fd:N)"};
 		Option exactBboxOpt {"exact-bbox", 'e', "compute exact glyph bounding boxes"};
+		TypedOption<int, Option::ArgMode::REQUIRED> fontCompressionOpt {"font-compression", '\0', "level", 11, "set compression level of WOFF/WOFF2 fonts (0-11)"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> fontFormatOpt {"font-format", 'f', "format", "svg", "set file format of embedded fonts"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> fontmapOpt {"fontmap", 'm', "filenames", "evaluate (additional) font map files"};
 		Option gradOverlapOpt {"grad-overlap", '\0', "create overlapping color gradient segments"};
@@ -51,6 +53,9 @@ class CommandLine : public CL::CommandLine {
 		TypedOption<std::string, Option::ArgMode::REQUIRED> linkmarkOpt {"linkmark", 'L', "style", "box", "select how to mark hyperlinked areas"};
 		Option listSpecialsOpt {"list-specials", 'l', "print supported special sets and exit"};
 		TypedOption<double, Option::ArgMode::REQUIRED> magOpt {"mag", 'M', "factor", 4, "magnification of Metafont output"};
+		TypedOption<unsigned, Option::ArgMode::REQUIRED> maxPageMemoryOpt {"max-page-memory", '\0', "size", "skip pages allocating more than the given number of MB (checked between steps, Ghostscript's memory excluded)"};
+		Option mergeLinesOpt {"merge-lines", '\0', "combine adjacent lines of em and tpic specials into a single path element"};
+		Option mergeRulesOpt {"merge-rules", '\0', "combine adjacent rules into a single path element"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> messageOpt {"message", '\0', "text", "print message text after writing an SVG file"};
 		TypedOption<int, Option::ArgMode::OPTIONAL> noFontsOpt {"no-fonts", 'n', "variant", 0, "draw glyphs by using path elements"};
 		Option noMergeOpt {"no-merge", '\0', "don't merge adjacent text elements"};
@@ -61,12 +66,14 @@ class CommandLine : public CL::CommandLine {
 		TypedOption<std::string, Option::ArgMode::REQUIRED> outputOpt {"output", 'o', "pattern", "set name pattern of output files"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> pageOpt {"page", 'p', "ranges", "1", "choose page(s) to convert"};
 		TypedOption<std::string, Option::ArgMode::OPTIONAL> pageHashesOpt {"page-hashes", 'H', "params", "xxh64", "activate usage of page hashes"};
+		TypedOption<double, Option::ArgMode::REQUIRED> pageTimeoutOpt {"page-timeout", '\0', "seconds", "simplify the output of pages whose conversion takes longer than the given number of seconds"};
 		Option pdfOpt {"pdf", 'P', "convert PDF file to SVG"};
 		TypedOption<int, Option::ArgMode::REQUIRED> precisionOpt {"precision", 'd', "number", 0, "set number of decimal points (0-6)"};
 		TypedOption<double, Option::ArgMode::OPTIONAL> progressOpt {"progress", '\0', "delay", 0.5, "enable progress indicator"};
 		Option relativeOpt {"relative", 'R', "create relative path commands"};
 		TypedOption<double, Option::ArgMode::REQUIRED> rotateOpt {"rotate", 'r', "angle", "rotate page content clockwise"};
 		TypedOption<std::string, Option::ArgMode::REQUIRED> scaleOpt {"scale", 'c', "sx[,sy]", "scale page content"};
+		TypedOption<std::string, Option::ArgMode::OPTIONAL> statsOpt {"stats", '\0', "format", "text", "print time and size statistics of the conversion"};
 		Option stdinOpt {"stdin", '\0', "read input file from stdin"};
 		Option stdoutOpt {"stdout", 's', "write SVG output to stdout"};
 		TypedOption<std::string, Option::ArgMode::OPTIONAL> tmpdirOpt {"tmpdir", '\0', "path", "set/print the directory for temporary files"};
@@ -112,6 +119,9 @@ class CommandLine : public CL::CommandLine {
 			{&commentsOpt, 1},
 			{&currentcolorOpt, 1},
 			{&embedBitmapsOpt, 1},
+#if !defined(DISABLE_WOFF)
+			{&fontCompressionOpt, 1},
+#endif
 #if !defined(DISABLE_WOFF)
 			{&fontFormatOpt, 1},
 #endif
@@ -125,6 +135,8 @@ class CommandLine : public CL::CommandLine {
 			{&gradSimplifyOpt, 1},
 #endif
 			{&linkmarkOpt, 1},
+			{&mergeLinesOpt, 1},
+			{&mergeRulesOpt, 1},
 			{&optimizeOpt, 1},
 			{&outputOpt, 1},
 			{&precisionOpt, 1},
@@ -150,15 +162,19 @@ class CommandLine : public CL::CommandLine {
 			{&libgsOpt, 3},
 #endif
 			{&magOpt, 3},
+			{&maxPageMemoryOpt, 3},
 			{&noMktexmfOpt, 3},
 			{&noSpecialsOpt, 3},
 			{&pageHashesOpt, 3},
+			{&pageTimeoutOpt, 3},
 			{&traceAllOpt, 3},
 			{&colorOpt, 4},
+			{&eventsOpt, 4},
 			{&helpOpt, 4},
 			{&listSpecialsOpt, 4},
 			{&messageOpt, 4},
 			{&progressOpt, 4},
+			{&statsOpt, 4},
 			{&verbosityOpt, 4},
 			{&versionOpt, 4},
 		};
@@ -38,6 +38,8 @@ struct DVIActions {
 	virtual void moveToY (double y, bool forceSVGMove) {}
 	virtual void setFont (int num, const Font &font) {}
 	virtual void special (const std::string &s, double dvi2bp, bool preprocessing=false) {}
+	virtual bool needsPreprocessing (const std::string &s) const {return false;}
+	virtual void synchronizeSpecials () {}
 	virtual void beginPage (unsigned pageno, const std::vector<int32_t> &c) {}
 	virtual void endPage (unsigned pageno) {}
 	virtual BoundingBox& bbox () =0;
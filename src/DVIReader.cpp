@@ -27,6 +27,8 @@
 #include "Font.hpp"
 #include "FontManager.hpp"
 #include "HashFunction.hpp"
+#include "MemoryMonitor.hpp"
+#include "Profiler.hpp"
 #include "utility.hpp"
 
 using namespace std;
@@ -60,7 +62,8 @@ void DVIReader::executeAll () {
 /** Reads and executes the commands of a single page.
  *  This methods stops reading after the page's eop command has been executed.
  *  @param[in] n number of page to be executed (1-based)
- *  @returns true if page was read successfully */
+ *  @returns true if page was read successfully
+ *  @throw PageMemoryException if the page exceeds the memory limit set in MemoryMonitor */
 bool DVIReader::executePage (unsigned n) {
 	clearStream();    // reset all status bits
 	if (!isStreamValid())
@@ -70,7 +73,10 @@ bool DVIReader::executePage (unsigned n) {
 
 	seek(_bopOffsets[n-1]); // goto bop of n-th page
 	_currPageNum = n;
-	while (executeCommand() != OP_EOP);
+	Profiler::Scope scope("dvi");
+	MemoryMonitor::beginPage();
+	while (executeCommand() != OP_EOP)
+		MemoryMonitor::checkPageLimit();
 	return true;
 }
 
@@ -402,8 +408,8 @@ void DVIReader::cmdXXX (int len) {
 	if (!_inPage)
 		throw DVIException("special outside of page");
 	uint32_t numBytes = readUnsigned(len);
-	string str = readString(numBytes);
-	dviXXX(str);
+	readString(numBytes, _special);
+	dviXXX(_special);
 }
 
 
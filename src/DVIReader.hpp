@@ -85,7 +85,7 @@ class DVIReader : public BasicDVIReader, public VFActions {
 		// the DVI registers have been updated, i.e. currState() represents the state after executing
 		// the command. If the previous register state is required, prevState() can be used.
 		virtual void dviPre (uint8_t id, uint32_t numer, uint32_t denom, uint32_t mag, const std::string &comment) {}
-		virtual void dviPost (uint16_t stdepth, uint16_t pages, uint32_t pw, uint32_t ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) {}
+		virtual void dviPost (uint16_t stdepth, uint16_t pages, double pw, double ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) {}
 		virtual void dviPostPost (uint8_t id, uint32_t postOffset) {}
 		virtual void dviBop (const std::vector<int32_t> &c, int32_t prevBopOffset) {}
 		virtual void dviEop () {}
@@ -163,6 +163,7 @@ class DVIReader : public BasicDVIReader, public VFActions {
 		DVIState _dviState;          ///< current state of the DVI registers
 		std::stack<DVIState> _stateStack;
 		std::vector<uint32_t> _bopOffsets;
+		std::string _special;        ///< text of the current special (reused to avoid reallocations)
 };
 
 #endif
@@ -19,6 +19,8 @@
 *************************************************************************/
 
 #include <config.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
@@ -28,18 +30,23 @@
 #include "Calculator.hpp"
 #include "DVIToSVG.hpp"
 #include "DVIToSVGActions.hpp"
+#include "EventStream.hpp"
 #include "FileSystem.hpp"
 #include "Font.hpp"
 #include "FontManager.hpp"
 #include "GlyphTracerMessages.hpp"
 #include "InputBuffer.hpp"
 #include "InputReader.hpp"
+#include "MemoryMonitor.hpp"
+#include "PageBudget.hpp"
 #include "PageRanges.hpp"
 #include "PageSize.hpp"
 #include "PreScanDVIReader.hpp"
+#include "Profiler.hpp"
 #include "SignalHandler.hpp"
 #include "optimizer/SVGOptimizer.hpp"
 #include "SVGOutput.hpp"
+#include "System.hpp"
 #include "utility.hpp"
 #include "version.hpp"
 #include "XXHashFunction.hpp"
@@ -74,6 +81,10 @@ DVIToSVG::DVIToSVG (istream &is, SVGOutputBase &out)
 {
 	_prevXPos = _prevYPos = numeric_limits<double>::min();
 	_actions = util::make_unique<DVIToSVGActions>(*this, _svg);
+	// The DVIReader constructor has already processed the postamble, but at that
+	// point the call of dviPost() couldn't be dispatched to this class yet.
+	goToPostamble();
+	executeCommand();
 }
 
 
@@ -109,13 +120,46 @@ void DVIToSVG::convert (unsigned first, unsigned last, HashFunction *hashFunc) {
 			Message::mstream().indent(1);
 			Message::mstream(false, Message::MC_PAGE_WRITTEN) << "\nfile " << path.shorterAbsoluteOrRelative() << " exists\n";
 			Message::mstream().indent(0);
+			if (EventStream::enabled())
+				EventStream::instance().write(EventStream::Event("page-skipped").add("page", i).add("file", path.absolute()));
 		}
 		else {
-			executePage(i);
-			SVGOptimizer(_svg).execute();
-			embedFonts(_svg.rootNode());
+			double startTime = System::time();
+			if (EventStream::enabled())
+				EventStream::instance().write(EventStream::Event("page-started").add("page", i).add("pages", numberOfPages()));
+			Profiler::instance().beginPage(i);
+			PageBudget::beginPage();
+			try {
+				executePage(i);
+				MemoryMonitor::checkPageLimit();
+				if (!PageBudget::exceeded()) {
+					SVGOptimizer(_svg).execute();
+					MemoryMonitor::checkPageLimit();
+				}
+				else
+					PageBudget::degrade(PageBudget::NO_OPTIMIZER);
+				if (PageBudget::degradations())
+					PageBudget::reportDegradations(_svg, i);
+				embedFonts(_svg.rootNode());
+				MemoryMonitor::checkPageLimit();
+			}
+			catch (const PageMemoryException &e) {
+				abortPage(i, e.what(), path, startTime);
+				continue;
+			}
 			bool success = _svg.write(_out.getPageStream(currentPageNumber(), numberOfPages(), hashTriple));
 			_out.finish();
+			Profiler::instance().endPage();
+			if (EventStream::enabled()) {
+				EventStream::Event event("page-finished");
+				event.add("page", i).add("file", path.empty() ? "" : path.absolute()).add("success", success);
+				if (!dviHash.empty())
+					event.add("hash", dviHash);
+				if (PageBudget::degradations())
+					event.add("degraded", PageBudget::degradationString());
+				event.add("bbox", _pageBBox).add("duration", System::time()-startTime);
+				EventStream::instance().write(event);
+			}
 			string fname = path.shorterAbsoluteOrRelative();
 			if (fname.empty())
 				fname = "<stdout>";
@@ -137,6 +181,35 @@ void DVIToSVG::convert (unsigned first, unsigned last, HashFunction *hashFunc) {
 }
 
 
+/** Discards the partially converted current page and releases the memory
+ *  allocated for it. No output file is written for this page.
+ *  @param[in] pageno number of the page
+ *  @param[in] reason message describing why the page was aborted
+ *  @param[in] path path of the SVG file that would have been written
+ *  @param[in] startTime time the conversion of the page started */
+void DVIToSVG::abortPage (unsigned pageno, const string &reason, const FilePath &path, double startTime) {
+	// let the special handlers finish the page so that their state is consistent for the following pages
+	if (inPage()) {
+		try {
+			_actions->endPage(pageno);
+		}
+		catch (const PageMemoryException&) {
+			// the memory limit is still exceeded while finishing the page
+		}
+	}
+	Profiler::instance().endPage();
+	_svg.reset();
+	_actions->reset();
+	Message::estream(true) << "page " << pageno << ": " << reason << ", page skipped\n";
+	if (EventStream::enabled()) {
+		EventStream::Event event("page-finished");
+		event.add("page", pageno).add("file", path.empty() ? "" : path.absolute()).add("success", false);
+		event.add("error", reason).add("duration", System::time()-startTime);
+		EventStream::instance().write(event);
+	}
+}
+
+
 /** Creates a HashFunction object for a given algorithm name.
  *  @param[in] algo name of hash algorithm
  *  @return pointer to hash function
@@ -164,10 +237,15 @@ void DVIToSVG::convert (const string &rangestr, pair<int,int> *pageinfo) {
 
 	Message::mstream(false, Message::MC_PAGE_NUMBER) << "pre-processing DVI file (format version "  << getDVIVersion() << ")\n";
 	if (auto actions = dynamic_cast<DVIToSVGActions*>(_actions.get())) {
-		PreScanDVIReader prescan(getInputStream(), actions);
-		actions->setDVIReader(prescan);
-		prescan.executeAllPages();
-		actions->setDVIReader(*this);
+		// only run through the pages if there are handlers that evaluate specials in advance
+		if (SpecialManager::instance().needsPreprocessing()) {
+			Profiler::Scope scope("dvi", "prescan");
+			PreScanDVIReader prescan(getInputStream(), actions);
+			actions->setDVIReader(prescan);
+			prescan.executeAllPages();
+			actions->setDVIReader(*this);
+			Profiler::instance().addCount("preprocessed specials", prescan.specialIndex().size());
+		}
 		SpecialManager::instance().notifyPreprocessingFinished();
 		executeFontDefs();
 	}
@@ -235,6 +313,16 @@ int DVIToSVG::executeCommand () {
 }
 
 
+int DVIToSVG::evalCommand (CommandHandler &handler, int &param) {
+	int opcode = DVIReader::evalCommand(handler, param);
+	// Let the special handlers finish deferred operations before executing
+	// a command other than xxx1-xxx4 (239-242).
+	if (_actions && (opcode < 239 || opcode > 242))
+		_actions->synchronizeSpecials();
+	return opcode;
+}
+
+
 /** This template method is called by parent class DVIReader before
  *  executing the BOP actions.
  *  @param[in] pageno physical page number (1 = first page)
@@ -259,46 +347,31 @@ void DVIToSVG::leaveEndPage (unsigned) {
 
 	// set bounding box and apply page transformations
 	BoundingBox bbox = _actions->bbox();  // bounding box derived from the DVI commands executed
-	if (_bboxFormatString == "min" || _bboxFormatString == "preview" || _bboxFormatString == "papersize") {
+	if (mpark::get_if<ContentBBox>(&_bboxFormat)) {
 		bbox.unlock();
 		bbox.transform(getPageTransformation());
 	}
-	else if (_bboxFormatString == "dvi") {
+	else if (mpark::get_if<DVIPageBBox>(&_bboxFormat)) {
 		// center page content
 		double dx = (_pageWidth-bbox.width())/2;
 		double dy = (_pageHeight-bbox.height())/2;
 		bbox += BoundingBox(-dx, -dy, dx, dy);
 	}
-	else if (_bboxFormatString != "none") {
-		istringstream iss(_bboxFormatString);
-		StreamInputReader ir(iss);
-		ir.skipSpace();
-		if (isalpha(ir.peek())) {
-			// set explicitly given page format
-			PageSize size(_bboxFormatString);
-			if (size.valid()) {
-				// convention: DVI position (0,0) equals (1in, 1in) relative
-				// to the upper left vertex of the page (see DVI specification)
-				const double border = -72;
-				bbox = BoundingBox(border, border, size.width().bp()+border, size.height().bp()+border);
-			}
-		}
-		else { // set/modify bounding box by explicitly given values
-			try {
-				vector<Length> lengths = BoundingBox::extractLengths(_bboxFormatString);
-				if (lengths.size() == 1 || lengths.size() == 2) {  // relative box size?
-					// apply the page transformation and adjust the bbox afterwards
-					bbox.transform(getPageTransformation());
-				}
-				bbox.set(lengths);
-			}
-			catch (const MessageException &e) {
+	else if (auto pageSizeBox = mpark::get_if<PageSizeBBox>(&_bboxFormat))
+		bbox = pageSizeBox->box;
+	else if (auto lengthsBox = mpark::get_if<LengthsBBox>(&_bboxFormat)) {
+		if (!lengthsBox->lengths.empty()) {
+			if (lengthsBox->lengths.size() < 4) {  // relative box size?
+				// apply the page transformation and adjust the bbox afterwards
+				bbox.transform(getPageTransformation());
 			}
+			bbox.set(lengthsBox->lengths);
 		}
 	}
+	_pageBBox = bbox;
 	if (bbox.width() == 0)
 		Message::wstream(false) << "\npage is empty\n";
-	if (_bboxFormatString != "none") {
+	if (!mpark::get_if<NoBBox>(&_bboxFormat)) {
 		_svg.setBBox(bbox);
 		const double bp2pt = (1_bp).pt();
 		Message::mstream(false) << '\n';
@@ -311,38 +384,114 @@ void DVIToSVG::leaveEndPage (unsigned) {
 }
 
 
+/** Returns the bounding box of the current page if it's already known before the
+ *  page content is processed, i.e. if it's given by a named page format or by four
+ *  explicit lengths (see option --bbox). Otherwise, an invalid box is returned.
+ *  Like the page content, the box is given in coordinates prior to the page transformation. */
+BoundingBox DVIToSVG::getFixedPageBBox () const {
+	BoundingBox bbox;
+	if (auto pageSizeBox = mpark::get_if<PageSizeBBox>(&_bboxFormat))
+		bbox = pageSizeBox->box;
+	else if (auto lengthsBox = mpark::get_if<LengthsBBox>(&_bboxFormat)) {
+		if (lengthsBox->lengths.size() == 4)
+			bbox.set(lengthsBox->lengths);
+	}
+	if (bbox.valid()) {
+		Matrix inverse = getPageTransformation();
+		if (abs(det(inverse)) < 1e-12)
+			return BoundingBox();
+		bbox.transform(inverse.invert());
+	}
+	return bbox;
+}
+
+
+/** Sets the bounding box format applied to each page. The format string is parsed
+ *  here once so that the bounding boxes of the single pages can be computed without
+ *  any further string processing.
+ *  @param[in] format bounding box format given by the user (see option --bbox) */
+void DVIToSVG::setPageSize (const string &format) {
+	_bboxFormatString = format;
+	if (format == "min" || format == "preview" || format == "papersize")
+		_bboxFormat = ContentBBox();
+	else if (format == "dvi")
+		_bboxFormat = DVIPageBBox();
+	else if (format == "none")
+		_bboxFormat = NoBBox();
+	else {
+		istringstream iss(format);
+		StreamInputReader ir(iss);
+		ir.skipSpace();
+		if (isalpha(ir.peek())) {
+			// set explicitly given page format
+			_bboxFormat = LengthsBBox();
+			try {
+				PageSize size(format);
+				if (size.valid()) {
+					// convention: DVI position (0,0) equals (1in, 1in) relative
+					// to the upper left vertex of the page (see DVI specification)
+					const double border = -72;
+					_bboxFormat = PageSizeBBox{BoundingBox(border, border, size.width().bp()+border, size.height().bp()+border)};
+				}
+			}
+			catch (const PageSizeException&) {
+				// unknown format names leave the content box unchanged (see --bbox check in dvisvgm.cpp)
+			}
+		}
+		else { // set/modify bounding box by explicitly given values
+			LengthsBBox lengthsBox;
+			try {
+				lengthsBox.lengths = BoundingBox::extractLengths(format);
+				size_t size = lengthsBox.lengths.size();
+				if (size != 1 && size != 2 && size != 4)
+					lengthsBox.lengths.clear();
+			}
+			catch (const MessageException &e) {
+				lengthsBox.lengths.clear();
+			}
+			_bboxFormat = std::move(lengthsBox);
+		}
+	}
+}
+
+
+/** Sets the transformation commands applied to each page. The commands are compiled
+ *  here once so that only their arguments have to be evaluated for the single pages.
+ *  @param[in] cmds transformation commands given by the user */
+void DVIToSVG::setPageTransformation (const string &cmds) {
+	Calculator calc;
+	// add constants for length units to calculator
+	for (const auto &unit : Length::getUnits())
+		calc.setVariable(unit.first, Length(1, unit.second).pt());
+	_pageTransformation = CompiledTransformation(cmds, calc, {"ux", "uy", "w", "h"});
+}
+
+
 Matrix DVIToSVG::getPageTransformation () const {
 	Matrix matrix(1); // unity matrix
-	if (!_transCmds.empty()) {
-		Calculator calc;
+	if (!_pageTransformation.empty()) {
+		vector<double> slotValues;
 		if (_actions) {
 			const double bp2pt = (1_bp).pt();
 			BoundingBox &bbox = _actions->bbox();
-			calc.setVariable("ux", bbox.minX()*bp2pt);
-			calc.setVariable("uy", bbox.minY()*bp2pt);
-			calc.setVariable("w",  bbox.width()*bp2pt);
-			calc.setVariable("h",  bbox.height()*bp2pt);
+			slotValues = {bbox.minX()*bp2pt, bbox.minY()*bp2pt, bbox.width()*bp2pt, bbox.height()*bp2pt};
 		}
-		// add constants for length units to calculator
-		for (const auto &unit : Length::getUnits())
-			calc.setVariable(unit.first, Length(1, unit.second).pt());
-		matrix.set(_transCmds, calc);
+		matrix = _pageTransformation.eval(slotValues);
 	}
 	return matrix;
 }
 
 
-static void collect_chars (unordered_map<const Font*, set<int>> &fontmap) {
-	unordered_map<const Font*, set<int>> insertedChars;
+static void collect_chars (unordered_map<const Font*, CharSet> &fontmap) {
+	// references to the elements of an unordered_map remain valid when inserting new elements
+	vector<pair<const Font*, const CharSet*>> proxyChars;
 	for (const auto &entry : fontmap) {
 		const Font *unique_font = entry.first->uniqueFont();
-		if (unique_font != entry.first) {
-			for (int c : entry.second)
-				insertedChars[unique_font].insert(c);
-		}
+		if (unique_font != entry.first)
+			proxyChars.emplace_back(unique_font, &entry.second);
 	}
-	for (const auto &entry : insertedChars)
-		fontmap[entry.first].insert(entry.second.begin(), entry.second.end());
+	for (const auto &entry : proxyChars)
+		fontmap[entry.first].insert(*entry.second);
 }
 
 
@@ -351,12 +500,14 @@ static void collect_chars (unordered_map<const Font*, set<int>> &fontmap) {
 void DVIToSVG::embedFonts (XMLElement *svgElement) {
 	if (!svgElement || !_actions) // no dvi actions => no chars written => no fonts to embed
 		return;
+	Profiler::Scope scope("fonts");
 
 	auto &usedCharsMap = FontManager::instance().getUsedChars();
 	collect_chars(usedCharsMap);
 
 	GlyphTracerMessages messages;
 	unordered_set<const Font*> tracedFonts;  // collect unique fonts already traced
+	vector<SVGTree::FontChars> fontchars;    // fonts to embed
 	for (const auto &fontchar : usedCharsMap) {
 		const Font *font = fontchar.first;
 		if (auto ph_font = font_cast<const PhysicalFont*>(font)) {
@@ -367,13 +518,18 @@ void DVIToSVG::embedFonts (XMLElement *svgElement) {
 				tracedFonts.insert(ph_font->uniqueFont());
 			}
 			if (font->path())  // does font file exist?
-				_svg.append(*ph_font, fontchar.second, &messages);
+				fontchars.emplace_back(ph_font, &fontchar.second);
 			else
 				Message::wstream(true) << "can't embed font '" << font->name() << "'\n";
 		}
 		else
 			Message::wstream(true) << "can't embed font '" << font->name() << "'\n";
 	}
+	// append the fonts in a deterministic order
+	sort(fontchars.begin(), fontchars.end(), [](const SVGTree::FontChars &fc1, const SVGTree::FontChars &fc2) {
+		return FontManager::instance().fontID(fc1.first) < FontManager::instance().fontID(fc2.first);
+	});
+	_svg.append(fontchars, &messages);
 	_svg.appendFontStyles(FontManager::instance().getUsedFonts());
 }
 
@@ -451,9 +607,9 @@ void DVIToSVG::moveDown (double dy, MoveMode mode) {
 }
 
 
-void DVIToSVG::dviPost (uint16_t, uint16_t pages, uint32_t pw, uint32_t ph, uint32_t, uint32_t, uint32_t, uint32_t) {
-	_pageHeight = ph; // height of tallest page in dvi units
-	_pageWidth  = pw; // width of widest page in dvi units
+void DVIToSVG::dviPost (uint16_t, uint16_t, double pw, double ph, uint32_t, uint32_t, uint32_t, uint32_t) {
+	_pageHeight = ph; // height of tallest page in PS points
+	_pageWidth  = pw; // width of widest page in PS points
 }
 
 
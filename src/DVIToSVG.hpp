@@ -24,6 +24,9 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
+#include <mpark/variant.hpp>
+#include "BoundingBox.hpp"
 #include "DVIReader.hpp"
 #include "FilePath.hpp"
 #include "SVGTree.hpp"
@@ -53,8 +56,8 @@ class DVIToSVG : public DVIReader {
 		explicit DVIToSVG (std::istream &is, SVGOutputBase &out);
 		DVIToSVG (const DVIToSVG&) =delete;
 		void convert (const std::string &range, std::pair<int,int> *pageinfo=nullptr);
-		void setPageSize (const std::string &format)         {_bboxFormatString = format;}
-		void setPageTransformation (const std::string &cmds) {_transCmds = cmds;}
+		void setPageSize (const std::string &format);
+		void setPageTransformation (const std::string &cmds);
 		void setUserMessage (const std::string &msg)         {_userMessage = msg;}
 		Matrix getPageTransformation () const override;
 		void translateToX (double x) override {_tx = x-dviState().h-_tx;}
@@ -66,6 +69,7 @@ class DVIToSVG : public DVIReader {
 
 		FilePath getSVGFilePath (unsigned pageno) const;
 		const std::string& getUserBBoxString () const  {return _bboxFormatString;}
+		BoundingBox getFixedPageBBox () const;
 		static void setProcessSpecials (const char *ignorelist=nullptr, bool pswarning=false);
 
 	public:
@@ -76,13 +80,15 @@ class DVIToSVG : public DVIReader {
 	protected:
 		void convert (unsigned firstPage, unsigned lastPage, HashFunction *hashFunc);
 		int executeCommand () override;
+		int evalCommand (CommandHandler &handler, int &param) override;
 		void enterBeginPage (unsigned pageno, const std::vector<int32_t> &c);
 		void leaveEndPage (unsigned pageno);
+		void abortPage (unsigned pageno, const std::string &reason, const FilePath &path, double startTime);
 		void embedFonts (XMLElement *svgElement);
 		void moveRight (double dx, MoveMode mode) override;
 		void moveDown (double dy, MoveMode mode) override;
 
-		void dviPost (uint16_t stdepth, uint16_t pages, uint32_t pw, uint32_t ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) override;
+		void dviPost (uint16_t stdepth, uint16_t pages, double pw, double ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) override;
 		void dviBop (const std::vector<int32_t> &c, int32_t prevBopOffset) override;
 		void dviEop () override;
 		void dviSetChar0 (uint32_t c, const Font *font) override;
@@ -98,14 +104,30 @@ class DVIToSVG : public DVIReader {
 		void dviXGlyphString (std::vector<double> &dx, std::vector<uint16_t> &glyphs, const Font &font) override;
 		void dviXTextAndGlyphs (std::vector<double> &dx, std::vector<double> &dy, std::vector<uint16_t> &chars, std::vector<uint16_t> &glyphs, const Font &font) override;
 
+	private:
+		/** Variants of the bounding box format given by option --bbox. */
+		struct NoBBox {};                 ///< "none": don't set a bounding box
+		struct ContentBBox {};            ///< "min", "preview", "papersize": transformed box enclosing the page content
+		struct DVIPageBBox {};            ///< "dvi": box of the page size given in the postamble
+		struct PageSizeBBox {             ///< named page format, e.g. "A4"
+			BoundingBox box;
+		};
+		struct LengthsBBox {              ///< explicitly given lengths
+			std::vector<Length> lengths;    ///< 1, 2, or 4 lengths, empty if the format is invalid
+		};
+		// default: empty LengthsBBox, i.e. keep the box derived from the DVI commands
+		using BBoxFormat = mpark::variant<LengthsBBox, NoBBox, ContentBBox, DVIPageBBox, PageSizeBBox>;
+
 	private:
 		SVGTree _svg;
 		SVGOutputBase &_out;
 		std::unique_ptr<DVIActions> _actions;
 		std::string _bboxFormatString;      ///< bounding box size/format set by the user
-		std::string _transCmds;             ///< page transformation commands set by the user
+		BBoxFormat _bboxFormat;             ///< parsed bounding box format
+		CompiledTransformation _pageTransformation;  ///< page transformation commands set by the user
 		std::string _userMessage;           ///< message printed after conversion of a page
-		double _pageHeight=0, _pageWidth=0; ///< global page height and width stored in the postamble
+		BoundingBox _pageBBox;              ///< final bounding box of the current page
+		double _pageHeight=0, _pageWidth=0; ///< global page height and width (in PS points) stored in the postamble
 		double _tx=0, _ty=0;                ///< translation of cursor position
 		double _prevXPos, _prevYPos;        ///< previous cursor position
 		WritingMode _prevWritingMode;       ///< previous writing mode
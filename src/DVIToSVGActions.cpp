@@ -28,9 +28,12 @@
 #include "GlyphTracerMessages.hpp"
 #include "System.hpp"
 #include "utility.hpp"
+#include "XMLString.hpp"
 
 using namespace std;
 
+bool DVIToSVGActions::MERGE_RULES = false;
+
 
 void DVIToSVGActions::reset () {
 	FontManager::instance().resetUsedChars();
@@ -43,7 +46,9 @@ void DVIToSVGActions::reset () {
  *  @param[in] x new horizontal position
  *  @param[in] forceSVGMove if true, creates an explicit position change in the SVG tree */
 void DVIToSVGActions::moveToX (double x, bool forceSVGMove) {
-	SpecialManager::instance().notifyPositionChange(getX(), getY(), *this);
+	SpecialManager &manager = SpecialManager::instance();
+	if (manager.trackingPosition())  // any handlers interested in position changes?
+		manager.notifyPositionChange(getX(), getY(), *this);
 	if (forceSVGMove)
 		_svg.setX(x);
 }
@@ -53,7 +58,9 @@ void DVIToSVGActions::moveToX (double x, bool forceSVGMove) {
  *  @param[in] y new vertical position
  *  @param[in] forceSVGMove if true, creates an explicit position change in the SVG tree */
 void DVIToSVGActions::moveToY (double y, bool forceSVGMove) {
-	SpecialManager::instance().notifyPositionChange(getX(), getY(), *this);
+	SpecialManager &manager = SpecialManager::instance();
+	if (manager.trackingPosition())  // any handlers interested in position changes?
+		manager.notifyPositionChange(getX(), getY(), *this);
 	if (forceSVGMove)
 		_svg.setY(y);
 }
@@ -67,6 +74,15 @@ FilePath DVIToSVGActions::getSVGFilePath (unsigned pageno) const {
 }
 
 
+/** Returns the bounding box of the current page if it's independent of the page content
+ *  (see DVIToSVG::getFixedPageBBox). Otherwise, the returned box is invalid. */
+BoundingBox DVIToSVGActions::getFixedPageBBox () const {
+	if (auto dvi2svg = dynamic_cast<DVIToSVG*>(_dvireader))
+		return dvi2svg->getFixedPageBBox();
+	return BoundingBox();
+}
+
+
 string DVIToSVGActions::getBBoxFormatString () const {
 	string boxstr;
 	if (auto dvi2svg = dynamic_cast<DVIToSVG*>(_dvireader))
@@ -161,14 +177,18 @@ void DVIToSVGActions::setRule (double x, double y, double height, double width)
 		return;
 
 	// (x,y) is the lower left corner of the rectangle
-	auto rect = util::make_unique<SVGElement>("rect");
-	rect->addAttribute("x", x);
-	rect->addAttribute("y", y-height);
-	rect->addAttribute("height", height);
-	rect->addAttribute("width", width);
-	rect->setTransform(getMatrix());
-	rect->setFillColor(_svg.getFillColor());
-	_svg.appendToPage(std::move(rect));
+	if (MERGE_RULES)
+		appendRuleToPath(x, y, height, width);
+	else {
+		auto rect = util::make_unique<SVGElement>("rect");
+		rect->addAttribute("x", x);
+		rect->addAttribute("y", y-height);
+		rect->addAttribute("height", height);
+		rect->addAttribute("width", width);
+		rect->setTransform(getMatrix());
+		rect->setFillColor(_svg.getFillColor());
+		_svg.appendToPage(std::move(rect));
+	}
 
 	// update bounding box
 	BoundingBox bb(x, y-height, x+width, y);
@@ -178,6 +198,28 @@ void DVIToSVGActions::setRule (double x, double y, double height, double width)
 }
 
 
+/** Adds a rule as a rectangular subpath to a path element. If the preceding node
+ *  of the current page context is a path with the same fill color and transformation,
+ *  the rule is appended to it. Otherwise, a new path element is started. This way,
+ *  sequences of rules, like table lines or barcodes, don't require a separate
+ *  element per rule.
+ *  @param[in] x horizontal position of the lower left corner
+ *  @param[in] y vertical position of the lower left corner
+ *  @param[in] height height of the rule
+ *  @param[in] width width of the rule */
+void DVIToSVGActions::appendRuleToPath (double x, double y, double height, double width) {
+	string d = "M" + XMLString(x) + " " + XMLString(y-height);
+	if (SVGTree::RELATIVE_PATH_CMDS)
+		d += "h" + XMLString(width) + "v" + XMLString(height) + "h" + XMLString(-width) + "z";
+	else
+		d += "H" + XMLString(x+width) + "V" + XMLString(y) + "H" + XMLString(x) + "Z";
+	auto path = util::make_unique<SVGElement>("path");
+	path->setTransform(getMatrix());
+	path->setFillColor(_svg.getFillColor());
+	_svg.appendPathToPage(std::move(path), d);
+}
+
+
 /** This method is called when a "set font" command was found in the DVI file. The
  *  font must be previously defined.
  *  @param[in] num unique number of the font in the DVI file (not necessarily equal to the DVI font number)
@@ -205,6 +247,24 @@ void DVIToSVGActions::special (const string &spc, double dvi2bp, bool preprocess
 }
 
 
+/** Returns true if the given special must be evaluated while the DVI file is being pre-processed.
+ *  @param[in] spc the special expression */
+bool DVIToSVGActions::needsPreprocessing (const string &spc) const {
+	return SpecialManager::instance().needsPreprocessing(spc);
+}
+
+
+/** This method is called before a DVI command other than a special is executed. */
+void DVIToSVGActions::synchronizeSpecials () {
+	try {
+		SpecialManager::instance().synchronize(*this);
+	}
+	catch (const SpecialException &e) {
+		Message::estream(true) << "error in special: " << e.what() << '\n';
+	}
+}
+
+
 /** This method is called when a "begin of page (bop)" command was found in the DVI file.
  *  @param[in] pageno physical page number
  *  @param[in] c array with 10 components representing \\count0 ... \\count9. c[0] contains the
@@ -61,6 +61,8 @@ class DVIToSVGActions : public DVIActions, public SpecialActions {
 		void moveToY (double y, bool forceSVGMove) override;
 		void setFont (int num, const Font &font) override;
 		void special (const std::string &spc, double dvi2bp, bool preprocessing=false) override;
+		bool needsPreprocessing (const std::string &spc) const override;
+		void synchronizeSpecials () override;
 		void beginPage (unsigned pageno, const std::vector<int32_t> &c) override;
 		void endPage (unsigned pageno) override;
 		void progress (size_t current, size_t total, const char *id=nullptr) override;
@@ -80,8 +82,14 @@ class DVIToSVGActions : public DVIActions, public SpecialActions {
 		void embed (const DPair &p, double r=0) override;
 		FilePath getSVGFilePath (unsigned pageno) const override;
 		std::string getBBoxFormatString () const override;
+		BoundingBox getFixedPageBBox () const override;
 		void setDVIReader (BasicDVIReader &r) {_dvireader = &r;}
 
+		static bool MERGE_RULES;  ///< if true, consecutive rules with common properties are combined into a single path
+
+	protected:
+		void appendRuleToPath (double x, double y, double height, double width);
+
 	private:
 		SVGTree &_svg;
 		BasicDVIReader *_dvireader;
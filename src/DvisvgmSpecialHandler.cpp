@@ -97,6 +97,19 @@ DvisvgmSpecialHandler::DvisvgmSpecialHandler () : _currentMacro(_macros.end())
 
 
 void DvisvgmSpecialHandler::preprocess (const string&, istream &is, SpecialActions&) {
+	StreamInputReader ir(is);
+	preprocessSpecial(ir);
+}
+
+
+void DvisvgmSpecialHandler::preprocessText (const string&, CharInputReader &ir, SpecialActions&) {
+	preprocessSpecial(ir);
+}
+
+
+/** Collects the SVG fragments defined by rawset/endrawset while preprocessing the DVI file.
+ *  @param[in] ir reader providing the special statement following the prefix */
+void DvisvgmSpecialHandler::preprocessSpecial (InputReader &ir) {
 	constexpr struct Command {
 		const char *name;
 		void (DvisvgmSpecialHandler::*handler)(InputReader&);
@@ -108,7 +121,6 @@ void DvisvgmSpecialHandler::preprocess (const string&, istream &is, SpecialActio
 		{"rawput",    &DvisvgmSpecialHandler::preprocessRawPut}
 	};
 
-	StreamInputReader ir(is);
 	const string cmdstr = ir.getWord();
 	auto it = find_if(begin(commands), end(commands), [&](const Command &cmd) {
 		return cmd.name == cmdstr;
@@ -172,7 +184,20 @@ void DvisvgmSpecialHandler::preprocessRawPut (InputReader &ir) {
  *  @param[in] prefix special prefix read by the SpecialManager
  *  @param[in] is the special statement is read from this stream
  *  @param[in] actions object providing the actions that can be performed by the SpecialHandler */
-bool DvisvgmSpecialHandler::process (const string &prefix, istream &is, SpecialActions &actions) {
+bool DvisvgmSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
+	StreamInputReader ir(is);
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+bool DvisvgmSpecialHandler::processText (const string&, CharInputReader &ir, SpecialActions &actions) {
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+void DvisvgmSpecialHandler::processSpecial (InputReader &ir, SpecialActions &actions) {
 	constexpr struct Command {
 		const char *name;
 		void (DvisvgmSpecialHandler::*handler)(InputReader&, SpecialActions&);
@@ -187,7 +212,6 @@ bool DvisvgmSpecialHandler::process (const string &prefix, istream &is, SpecialA
 		{"currentcolor", &DvisvgmSpecialHandler::processCurrentColor},
 		{"message",      &DvisvgmSpecialHandler::processMessage}
 	};
-	StreamInputReader ir(is);
 	const string cmdstr = ir.getWord();
 	auto it = find_if(begin(commands), end(commands), [&](const Command &cmd) {
 		return cmd.name == cmdstr;
@@ -196,7 +220,6 @@ bool DvisvgmSpecialHandler::process (const string &prefix, istream &is, SpecialA
 		ir.skipSpace();
 		(this->*it->handler)(ir, actions);
 	}
-	return true;
 }
 
 
@@ -74,13 +74,19 @@ class DvisvgmSpecialHandler : public SpecialHandler {
 	public:
 		DvisvgmSpecialHandler ();
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		void preprocessText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool processText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions) override;
 		const char* info () const override {return "special set for embedding raw SVG snippets";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "dvisvgm";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_BEGIN_PAGE|EV_END_PAGE;}
 
 	protected:
+		void preprocessSpecial (InputReader &ir);
+		void processSpecial (InputReader &ir, SpecialActions &actions);
 		void preprocessRaw (InputReader &ir);
 		void preprocessRawDef (InputReader &ir);
 		void preprocessRawSet (InputReader &ir);
@@ -20,6 +20,7 @@
 
 #include <sstream>
 #include "EmSpecialHandler.hpp"
+#include "GraphicsPath.hpp"
 #include "InputBuffer.hpp"
 #include "InputReader.hpp"
 #include "Length.hpp"
@@ -79,6 +80,26 @@ static void create_line (const DPair &p1, const DPair &p2, char c1, char c2, dou
 	unique_ptr<SVGElement> node;
 	DPair dir = p2-p1;
 	if (dir.x() == 0 || dir.y() == 0 || (c1 == 'p' && c2 == 'p')) {
+		// update bounding box
+		DPair cv = cut_vector('p', dir, lw);
+		actions.embed(p1+cv);
+		actions.embed(p1-cv);
+		actions.embed(p2+cv);
+		actions.embed(p2-cv);
+		if (SVGTree::MERGE_LINES && actions.getOpacity().isStrokeDefault()) {
+			// draw line as subpath of a path element shared with adjacent lines of same style
+			GraphicsPath<double> path;
+			path.moveto(p1);
+			path.lineto(p2);
+			ostringstream oss;
+			path.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS);
+			node = util::make_unique<SVGElement>("path");
+			node->setNoFillColor();
+			node->setStrokeWidth(lw);
+			node->setStrokeColor(actions.getStrokeColor());
+			actions.svgTree().appendPathToPage(std::move(node), oss.str());
+			return;
+		}
 		// draw regular line
 		node = util::make_unique<SVGElement>("line");
 		node->addAttribute("x1", p1.x());
@@ -88,13 +109,6 @@ static void create_line (const DPair &p1, const DPair &p2, char c1, char c2, dou
 		node->setStrokeWidth(lw);
 		node->setStrokeColor(actions.getStrokeColor());
 		node->setStrokeOpacity(actions.getOpacity());
-
-		// update bounding box
-		DPair cv = cut_vector('p', dir, lw);
-		actions.embed(p1+cv);
-		actions.embed(p1-cv);
-		actions.embed(p2+cv);
-		actions.embed(p2-cv);
 	}
 	else {
 		// draw polygon
@@ -138,7 +152,23 @@ static double read_length (InputReader &in) {
 }
 
 
-bool EmSpecialHandler::process (const string &prefix, istream &is, SpecialActions &actions) {
+bool EmSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
+	StreamInputReader ir(is);
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+bool EmSpecialHandler::processText (const string&, CharInputReader &ir, SpecialActions &actions) {
+	processSpecial(ir, actions);
+	return true;
+}
+
+
+/** Evaluates an em special statement.
+ *  @param[in] ir reader providing the special statement following the prefix
+ *  @param[in] actions actions the special handler can perform */
+void EmSpecialHandler::processSpecial (InputReader &ir, SpecialActions &actions) {
 	// em:moveto => move graphic cursor to dvi position
 	// em:lineto => draw line from graphic cursor to dvi cursor, then move graphic cursor to dvi position
 	// em:linewidth <w> => set line width to <w>
@@ -166,7 +196,6 @@ bool EmSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 		{nullptr, nullptr}
 	};
 
-	StreamInputReader ir(is);
 	const string cmdstr = ir.getWord();
 	for (Command *cmd=commands; cmd->name; cmd++) {
 		if (cmdstr == cmd->name) {
@@ -174,7 +203,6 @@ bool EmSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 			break;
 		}
 	}
-	return true;
 }
 
 
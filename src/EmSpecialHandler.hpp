@@ -38,14 +38,17 @@ class EmSpecialHandler : public SpecialHandler {
 	};
 
 	public:
-		bool process (const std::string &prefix, std::istream &in, SpecialActions &actions) override;
+		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool processText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions) override;
 		const char* info () const override {return "line drawing statements of the emTeX special set";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "em";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 
 	protected:
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
+		void processSpecial (InputReader &ir, SpecialActions &actions);
 		void linewidth (InputReader &ir, SpecialActions &actions);
 		void moveto (InputReader &ir, SpecialActions &actions);
 		void lineto (InputReader &ir, SpecialActions &actions);
@@ -0,0 +1,159 @@
+/*************************************************************************
+** EventStream.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include "BoundingBox.hpp"
+#include "EventStream.hpp"
+#include "XMLString.hpp"
+
+using namespace std;
+
+EventStream::Event::Event (const string &type) {
+	_oss << "{\"event\":" << quote(type);
+}
+
+
+EventStream::Event& EventStream::Event::add (const string &name, const string &value) {
+	_oss << ",\"" << name << "\":" << quote(value);
+	return *this;
+}
+
+
+EventStream::Event& EventStream::Event::add (const string &name, bool value) {
+	_oss << ",\"" << name << "\":" << (value ? "true" : "false");
+	return *this;
+}
+
+
+/** Adds a floating point number. Since JSON doesn't support infinite values
+ *  and NaNs, they are written as null. */
+EventStream::Event& EventStream::Event::add (const string &name, double value) {
+	_oss << ",\"" << name << "\":";
+	if (std::isfinite(value))
+		_oss << value;
+	else
+		_oss << "null";
+	return *this;
+}
+
+
+/** Returns the JSON representation of a length value (null for non-finite values). */
+static string length_json (double value) {
+	return std::isfinite(value) ? string(XMLString(value)) : "null";
+}
+
+
+/** Adds a bounding box in PS point units as array [x, y, width, height]. */
+EventStream::Event& EventStream::Event::add (const string &name, const BoundingBox &bbox) {
+	_oss << ",\"" << name << "\":["
+		<< length_json(bbox.minX()) << ',' << length_json(bbox.minY()) << ','
+		<< length_json(bbox.width()) << ',' << length_json(bbox.height()) << ']';
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+EventStream::~EventStream () {
+	close();
+}
+
+
+EventStream& EventStream::instance () {
+	static EventStream eventStream;
+	return eventStream;
+}
+
+
+/** Opens the target the events are written to.
+ *  @param[in] target "fd:N" to write to file descriptor N, otherwise name/path of a file
+ *  @return true on success */
+bool EventStream::open (const string &target) {
+	close();
+	if (target.substr(0, 3) == "fd:") {
+		try {
+			size_t count;
+			int fd = stoi(target.substr(3), &count);
+			if (fd < 0 || count != target.length()-3)
+				return false;
+#ifdef _WIN32
+			_file = _fdopen(fd, "w");
+#else
+			_file = fdopen(fd, "w");
+#endif
+		}
+		catch (const exception &e) {
+			return false;
+		}
+	}
+	else
+		_file = fopen(target.c_str(), "w");
+	_startTime = Clock::now();
+	return _file != nullptr;
+}
+
+
+void EventStream::close () {
+	if (_file) {
+		fclose(_file);
+		_file = nullptr;
+	}
+}
+
+
+/** Writes an event record to the stream. Each record gets the time in seconds
+ *  elapsed since opening the stream. The record is flushed immediately so that
+ *  the reading process can react to it without delay. */
+void EventStream::write (const Event &event) {
+	if (_file) {
+		lock_guard<mutex> lock(_mutex);
+		string json = event.toJSON();
+		ostringstream oss;
+		oss << fixed << setprecision(6) << chrono::duration<double>(Clock::now()-_startTime).count();
+		json.insert(json.length()-1, ",\"time\":"+oss.str());
+		fputs(json.c_str(), _file);
+		fputc('\n', _file);
+		fflush(_file);
+	}
+}
+
+
+/** Returns a string as quoted JSON string literal. */
+string EventStream::quote (const string &str) {
+	ostringstream oss;
+	oss << '"';
+	for (char c : str) {
+		switch (c) {
+			case '"' : oss << "\\\""; break;
+			case '\\': oss << "\\\\"; break;
+			case '\n': oss << "\\n"; break;
+			case '\r': oss << "\\r"; break;
+			case '\t': oss << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					oss << "\\u" << hex << setw(4) << setfill('0') << int(c) << dec;
+				else
+					oss << c;
+		}
+	}
+	oss << '"';
+	return oss.str();
+}
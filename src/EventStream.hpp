@@ -0,0 +1,80 @@
+/*************************************************************************
+** EventStream.hpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef EVENTSTREAM_HPP
+#define EVENTSTREAM_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+class BoundingBox;
+
+/** Writes machine-readable records about the progress of the conversion, like the
+ *  start and end of a page conversion or warnings, to a file or file descriptor.
+ *  Each record is a JSON object written on a separate line (NDJSON), so that other
+ *  programs can process the results of a page while the conversion continues. */
+class EventStream {
+	using Clock = std::chrono::steady_clock;
+
+	public:
+		class Event {
+			public:
+				explicit Event (const std::string &type);
+				Event& add (const std::string &name, const std::string &value);
+				Event& add (const std::string &name, const char *value) {return add(name, std::string(value));}
+				Event& add (const std::string &name, bool value);
+				Event& add (const std::string &name, double value);
+				Event& add (const std::string &name, float value) {return add(name, double(value));}
+				Event& add (const std::string &name, const BoundingBox &bbox);
+
+				template <typename T>
+				Event& add (const std::string &name, T value) {
+					_oss << ",\"" << name << "\":" << value;
+					return *this;
+				}
+
+				std::string toJSON () const {return _oss.str()+"}";}
+
+			private:
+				std::ostringstream _oss;
+		};
+
+	public:
+		~EventStream ();
+		static EventStream& instance ();
+		static bool enabled () {return instance()._file != nullptr;}
+		bool open (const std::string &target);
+		void close ();
+		void write (const Event &event);
+		static std::string quote (const std::string &str);
+
+	protected:
+		EventStream () =default;
+
+	private:
+		std::FILE *_file=nullptr;
+		Clock::time_point _startTime;
+		std::mutex _mutex;
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include "FontEngine.hpp"
 #include "Message.hpp"
 #include "MetafontWrapper.hpp"
+#include "Profiler.hpp"
 #include "SignalHandler.hpp"
 #include "Subfont.hpp"
 #include "Unicode.hpp"
@@ -222,6 +223,17 @@ Character PhysicalFont::decodeChar (uint32_t c) const {
 }
 
 
+/** Returns the character that addresses the glyph of a DVI character in the font file.
+ *  In contrast to decodeChar(), the subfont mapping assigned in the font map is applied too.
+ *  @param[in] c DVI character to decode */
+Character PhysicalFont::decodeGlyphChar (int c) const {
+	if (const FontMap::Entry *entry = fontMapEntry())
+		if (Subfont *sf = entry->subfont)
+			c = sf->decode(c);
+	return decodeChar(c);
+}
+
+
 /** Returns the number of units per EM. The EM square is the virtual area a glyph is designed on.
  *  All coordinates used to specify portions of the glyph are relative to the origin (0,0) at the
  *  lower left corner of this square, while the upper right corner is located at (m,m), where m
@@ -335,6 +347,7 @@ int PhysicalFont::charIndexByName(const string &charname) const {
  *  @param[in]  callback optional callback object for tracer class
  *  @return true if outline could be computed */
 bool PhysicalFont::getGlyph (int c, GraphicsPath<int32_t> &glyph, GFGlyphTracer::Callback *callback) const {
+	Profiler::Scope scope("glyphs");
 	if (type() == Type::MF) {
 		const Glyph *cached_glyph=nullptr;
 		if (!CACHE_PATH.empty()) {
@@ -368,10 +381,7 @@ bool PhysicalFont::getGlyph (int c, GraphicsPath<int32_t> &glyph, GFGlyphTracer:
 	else { // vector fonts (OTF, PFB, TTF, TTC)
 		bool ok=true;
 		FontEngine::instance().setFont(*this);
-		if (const FontMap::Entry *entry = fontMapEntry())
-			if (Subfont *sf = entry->subfont)
-				c = sf->decode(c);
-		ok = FontEngine::instance().traceOutline(decodeChar(c), glyph, false);
+		ok = FontEngine::instance().traceOutline(decodeGlyphChar(c), glyph, false);
 		glyph.closeOpenSubPaths();
 		return ok;
 	}
@@ -139,6 +139,7 @@ class PhysicalFont : public virtual Font {
 		virtual CharMapID getCharMapID () const =0;
 		virtual void setCharMapID (const CharMapID &id) {}
 		virtual Character decodeChar (uint32_t c) const;
+		Character decodeGlyphChar (int c) const;
 		virtual int charIndexByName (const std::string &charname) const;
 		const char* path () const override;
 		void visit (FontVisitor &visitor) override;
@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <ft2build.h>
@@ -50,6 +51,10 @@ static inline FT_Fixed to_16dot16 (int val) {
 
 ///////////////////////////////////////////////////////////////////////////
 
+/** Maximal number of font faces kept open by each FontEngine object. Keeping the
+ *  faces open avoids reloading the font files when switching between fonts. */
+static const size_t MAX_OPEN_FACES = 16;
+
 
 FontEngine::FontEngine () {
 	if (FT_Init_FreeType(&_library))
@@ -58,16 +63,20 @@ FontEngine::FontEngine () {
 
 
 FontEngine::~FontEngine () {
-	if (_currentFace && FT_Done_Face(_currentFace))
-		Message::estream(true) << "failed to release font\n";
+	for (const FaceEntry &entry : _faces) {
+		if (FT_Done_Face(entry.face))
+			Message::estream(true) << "failed to release font\n";
+	}
 	if (FT_Done_FreeType(_library))
 		Message::estream(true) << "failed to release FreeType library\n";
 }
 
 
-/** Returns the singleton instance of this class. */
+/** Returns the instance of this class assigned to the calling thread. Since the
+ *  FreeType objects must not be shared between threads, each thread gets its
+ *  own FT_Library and FT_Face objects. */
 FontEngine& FontEngine::instance () {
-	static FontEngine engine;
+	static thread_local FontEngine engine;
 	return engine;
 }
 
@@ -82,46 +91,81 @@ string FontEngine::version () {
 }
 
 
-/** Sets the font to be used.
+/** Sets the font to be used. Recently used fonts are kept open so that
+ *  switching between them doesn't require to reload the font files.
  * @param[in] fname path to font file
  * @param[in] fontindex index of font in font collection (multi-font files, like TTC)
  * @return true on success */
 bool FontEngine::setFont (const string &fname, int fontindex, const CharMapID &charMapID) {
-	if (_currentFace && FT_Done_Face(_currentFace))
-		Message::estream(true) << "failed to release font\n";
-	if (fname.size() <= 6 || fname.substr(0, 6) == "sys://") {
-		if (const MemoryFontData *data = find_base14_font(fname.substr(6))) {
-			FT_Open_Args args;
-			args.flags = FT_OPEN_MEMORY;
-			args.memory_base = reinterpret_cast<const FT_Byte*>(data->data);
-			args.memory_size = FT_Long(data->size);
-			if (FT_Open_Face(_library, &args, fontindex, &_currentFace)) {
-				Message::estream(true) << "can't read memory font " << fname << '\n';
-				return false;
+	auto it = find_if(_faces.begin(), _faces.end(), [&](const FaceEntry &entry) {
+		return entry.fontIndex == fontindex && entry.path == fname;
+	});
+	if (it != _faces.end())
+		_faces.splice(_faces.begin(), _faces, it);  // move entry to front
+	else {
+		FT_Face face = nullptr;
+		if (fname.size() <= 6 || fname.substr(0, 6) == "sys://") {
+			if (const MemoryFontData *data = find_base14_font(fname.substr(6))) {
+				FT_Open_Args args;
+				args.flags = FT_OPEN_MEMORY;
+				args.memory_base = reinterpret_cast<const FT_Byte*>(data->data);
+				args.memory_size = FT_Long(data->size);
+				if (FT_Open_Face(_library, &args, fontindex, &face))
+					Message::estream(true) << "can't read memory font " << fname << '\n';
 			}
 		}
+		else if (FT_New_Face(_library, fname.c_str(), fontindex, &face))
+			Message::estream(true) << "can't read font file " << fname << '\n';
+		if (!face) {
+			_currentFace = nullptr;
+			_currentFaceEntry = nullptr;
+			return false;
+		}
+		_faces.emplace_front(fname, fontindex, face);
+		if (_faces.size() > MAX_OPEN_FACES) {
+			if (FT_Done_Face(_faces.back().face))
+				Message::estream(true) << "failed to release font\n";
+			_faces.pop_back();
+		}
 	}
-	else if (FT_New_Face(_library, fname.c_str(), fontindex, &_currentFace)) {
-		Message::estream(true) << "can't read font file " << fname << '\n';
-		return false;
-	}
+	_currentFaceEntry = &_faces.front();
+	_currentFace = _currentFaceEntry->face;
 	if (charMapID.valid())
 		setCharMap(charMapID);
+	else if (_currentFaceEntry->defaultCharMap)
+		FT_Set_Charmap(_currentFace, _currentFaceEntry->defaultCharMap);
 	return true;
 }
 
 
 bool FontEngine::setFont (const Font &font) {
-	if (_currentFont && _currentFont->name() == font.name())
+	// The previously selected font object might already be destroyed (e.g. if the engine is
+	// used by a worker thread that outlives the fonts), so only its stored name is compared.
+	if (_currentFont && _currentFontName == font.name()) {
+		_currentFont = &font;
 		return true;
+	}
 
-	if (const char *path=font.path()) {
-		auto pf = font_cast<const PhysicalFont*>(&font);
-		if (setFont(path, font.fontIndex(), pf ? pf->getCharMapID() : CharMapID())) {
-			_currentFont = &font;
-			return true;
-		}
+	if (const char *path=font.path())
+		return setFont(font, path);
+	return false;
+}
+
+
+/** Sets the font to be used. In contrast to setFont(const Font&), the path of the
+ *  font file isn't looked up, so the function can be called from worker threads.
+ *  @param[in] font the font to be used
+ *  @param[in] path path of the font file
+ *  @return true on success */
+bool FontEngine::setFont (const Font &font, const string &path) {
+	auto pf = font_cast<const PhysicalFont*>(&font);
+	if (setFont(path, font.fontIndex(), pf ? pf->getCharMapID() : CharMapID())) {
+		_currentFont = &font;
+		_currentFontName = font.name();
+		return true;
 	}
+	_currentFont = nullptr;
+	_currentFontName.clear();
 	return false;
 }
 
@@ -153,25 +197,51 @@ bool FontEngine::setCharMap (const CharMapID &charMapID) {
 
 
 /** Returns a character map that maps from glyph indexes to character codes
- *  of the current encoding.
+ *  of the current encoding. If a glyph is referenced by several character
+ *  codes, the smallest non-zero one is assigned.
  *  @param[out] charmap the resulting charmap */
 void FontEngine::buildGidToCharCodeMap (RangeMap &charmap) {
 	charmap.clear();
+	if (!_currentFace)
+		return;
+	const int charmapIndex = _currentFace->charmap ? FT_Get_Charmap_Index(_currentFace->charmap) : -1;
+	auto it = _currentFaceEntry->gidToCharCodeMaps.find(charmapIndex);
+	if (it != _currentFaceEntry->gidToCharCodeMaps.end()) {
+		charmap = it->second;
+		return;
+	}
+	// Collect the (glyph index, character code) pairs and add them in ascending
+	// glyph index order. This prevents the range vector of the charmap from being
+	// shuffled around, which is expensive for fonts with many glyphs.
+	vector<pair<uint32_t,uint32_t>> gidCharPairs;
 	FT_UInt gid;  // index of current glyph
 	uint32_t charcode = FT_Get_First_Char(_currentFace, &gid);
 	while (gid) {
-		if (!charmap.valueAt(gid))
-			charmap.addRange(gid, gid, charcode);
+		gidCharPairs.emplace_back(gid, charcode);
 		charcode = FT_Get_Next_Char(_currentFace, charcode, &gid);
 	}
+	stable_sort(gidCharPairs.begin(), gidCharPairs.end(), [](const pair<uint32_t,uint32_t> &p1, const pair<uint32_t,uint32_t> &p2) {
+		return p1.first < p2.first;
+	});
+	for (auto first=gidCharPairs.begin(); first != gidCharPairs.end();) {
+		auto last = first;
+		while (last != gidCharPairs.end() && last->first == first->first)
+			++last;
+		auto nonzero = find_if(first, last, [](const pair<uint32_t,uint32_t> &p) {return p.second != 0;});
+		charmap.addRange(first->first, first->first, nonzero != last ? nonzero->second : 0);
+		first = last;
+	}
+	_currentFaceEntry->gidToCharCodeMaps.emplace(charmapIndex, charmap);
 }
 
 
 /** Creates a charmap that maps from the custom character encoding to Unicode.
  *  @return pointer to charmap if it could be created, 0 otherwise */
 unique_ptr<const RangeMap> FontEngine::createCustomToUnicodeMap () {
-	auto charmap = util::make_unique<RangeMap>();
-	if (_currentFace) {
+	if (!_currentFace)
+		return util::make_unique<RangeMap>();
+	if (!_currentFaceEntry->customToUnicodeMapBuilt) {
+		_currentFaceEntry->customToUnicodeMapBuilt = true;
 		FT_CharMap ftcharmap = _currentFace->charmap;
 		if (FT_Select_Charmap(_currentFace, FT_ENCODING_ADOBE_CUSTOM) != 0)
 			return nullptr;
@@ -179,16 +249,29 @@ unique_ptr<const RangeMap> FontEngine::createCustomToUnicodeMap () {
 		buildGidToCharCodeMap(gidToCharCodeMap);
 		if (FT_Select_Charmap(_currentFace, FT_ENCODING_UNICODE) != 0)
 			return nullptr;
+		vector<pair<uint32_t,uint32_t>> customUnicodePairs;
 		FT_UInt gid;  // index of current glyph
 		uint32_t ucCharcode = FT_Get_First_Char(_currentFace, &gid);  // Unicode code point
 		while (gid) {
-			uint32_t customCharcode = gidToCharCodeMap.valueAt(gid);
-			charmap->addRange(customCharcode, customCharcode, ucCharcode);
+			customUnicodePairs.emplace_back(gidToCharCodeMap.valueAt(gid), ucCharcode);
 			ucCharcode = FT_Get_Next_Char(_currentFace, ucCharcode, &gid);
 		}
 		FT_Set_Charmap(_currentFace, ftcharmap);
+		// add the mappings in ascending order of the custom codes; if a custom code
+		// is mapped to several code points, the greatest one is assigned
+		stable_sort(customUnicodePairs.begin(), customUnicodePairs.end(), [](const pair<uint32_t,uint32_t> &p1, const pair<uint32_t,uint32_t> &p2) {
+			return p1.first < p2.first;
+		});
+		auto charmap = util::make_unique<RangeMap>();
+		for (size_t i=0; i < customUnicodePairs.size(); i++) {
+			if (i+1 == customUnicodePairs.size() || customUnicodePairs[i+1].first != customUnicodePairs[i].first)
+				charmap->addRange(customUnicodePairs[i].first, customUnicodePairs[i].first, customUnicodePairs[i].second);
+		}
+		_currentFaceEntry->customToUnicodeMap = std::move(charmap);
 	}
-	return charmap;
+	if (_currentFaceEntry->customToUnicodeMap)
+		return util::make_unique<RangeMap>(*_currentFaceEntry->customToUnicodeMap);
+	return nullptr;
 }
 
 
@@ -24,6 +24,7 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_CID_H
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -43,6 +44,7 @@ class FontEngine {
 		static FontEngine& instance ();
 		static std::string version ();
 		bool setFont (const Font &font);
+		bool setFont (const Font &font, const std::string &path);
 		const Font* currentFont () const {return _currentFont;}
 		bool isCIDFont() const;
 		bool hasVerticalMetrics () const;
@@ -77,9 +79,26 @@ class FontEngine {
 		int charIndex (const Character &c) const;
 
 	private:
+		/** Font face opened by FreeType together with data derived from it. */
+		struct FaceEntry {
+			FaceEntry (std::string fname, int index, FT_Face ftface)
+				: path(std::move(fname)), fontIndex(index), face(ftface), defaultCharMap(ftface->charmap) {}
+
+			std::string path;                           ///< path of the font file
+			int fontIndex;                              ///< index of the font in a font collection
+			FT_Face face;                               ///< FreeType face object
+			FT_CharMap defaultCharMap;                  ///< charmap selected by FreeType when opening the face
+			std::map<int,RangeMap> gidToCharCodeMaps;   ///< cached glyph index maps (key: charmap index)
+			std::unique_ptr<RangeMap> customToUnicodeMap;
+			bool customToUnicodeMapBuilt=false;
+		};
+
 		FT_Face _currentFace = nullptr;
+		FaceEntry *_currentFaceEntry = nullptr;
+		std::list<FaceEntry> _faces;  ///< opened faces, most recently used first
 		FT_Library _library;
 		const Font *_currentFont = nullptr;
+		std::string _currentFontName;  ///< name of the current font
 };
 
 #endif
@@ -23,12 +23,12 @@
 
 #include <memory>
 #include <ostream>
-#include <set>
 #include <string>
 #include <stack>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include "CharSet.hpp"
 #include "Color.hpp"
 #include "FontStyle.hpp"
 
@@ -43,7 +43,7 @@ class VirtualFont;
  *  virtual fonts are completely replaced by their DVI description so they don't
  *  appear anywhere in the output. */
 class FontManager {
-	using CharMap = std::unordered_map<const Font*, std::set<int>>;
+	using CharMap = std::unordered_map<const Font*, CharSet>;
 	using FontSet = std::unordered_set<const Font*>;
 	using Num2IdMap = std::unordered_map<uint32_t, int>;
 	using Name2IdMap = std::unordered_map<std::string, int>;
@@ -69,9 +69,16 @@ vector<string> FontWriter::supportedFormats () {
 #ifdef DISABLE_WOFF
 // dummy functions used if WOFF support is disabled
 FontWriter::FontWriter (const PhysicalFont &font) : _currentFont(font) {}
-std::string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {return "";}
-bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {return false;}
+std::string FontWriter::createFontFile (FontFormat format, const CharSet &charcodes, GFGlyphTracer::Callback *cb) const {return "";}
+bool FontWriter::writeCSSFontFace (FontFormat format, const CharSet &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {return false;}
+
+future<string> FontWriter::createCSSFontFace (FontFormat format, const CharSet &charcodes, ThreadPool &pool, GFGlyphTracer::Callback *cb) const {
+	promise<string> result;
+	result.set_value("");
+	return result.get_future();
+}
 #else
+#include <atomic>
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -81,12 +88,15 @@ bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes,
 #include "FileSystem.hpp"
 #include "Font.hpp"
 #include "Glyph.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
 #include "ttf/TTFAutohint.hpp"
 #include "ttf/TTFWriter.hpp"
 
 using namespace ttf;
 
-bool FontWriter::createTTFFile (const std::string &ttfname, const PhysicalFont &font, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {
+bool FontWriter::createTTFFile (const std::string &ttfname, const PhysicalFont &font, const CharSet &charcodes, GFGlyphTracer::Callback *cb) const {
+	Profiler::Scope scope("fontwriter");
 	TTFWriter ttfWriter(font, charcodes);
 	if (cb)
 		ttfWriter.setTracerCallback(*cb);
@@ -127,28 +137,46 @@ bool FontWriter::createTTFFile (const std::string &ttfname, const PhysicalFont &
 }
 
 
+/** Converts a TTF file to WOFF or WOFF2 and removes the TTF file afterwards.
+ *  Since no font data is accessed, the function can be called from worker threads.
+ *  @param[in] ttfname name/path of the TTF file
+ *  @param[in] targetname name/path of the resulting font file
+ *  @param[in] format target font format
+ *  @return true on success */
+static bool convert_ttf_file (const string &ttfname, const string &targetname, FontWriter::FontFormat format) {
+	Profiler::Scope scope("fontwriter");
+	bool ok = true;
+	if (format == FontWriter::FontFormat::WOFF || format == FontWriter::FontFormat::WOFF2) {
+		if (format == FontWriter::FontFormat::WOFF)
+			ok = TTFWriter::convertTTFToWOFF(ttfname, targetname);
+		else
+			TTFWriter::convertTTFToWOFF2(ttfname, targetname);
+		if (!PhysicalFont::KEEP_TEMP_FILES)
+			FileSystem::remove(ttfname);
+	}
+	return ok;
+}
+
+
+/** Returns the path of a temporary font file without suffix. Since the font files
+ *  may be converted concurrently, a running number is appended to the font name
+ *  to prevent different fonts with the same name from sharing the files. */
+static string temp_basename (const PhysicalFont &font) {
+	static atomic<unsigned> count{0};
+	return FileSystem::tmpdir()+font.name()+"-tmp"+to_string(++count);
+}
+
+
 /** Creates a font file containing a given set of glyphs mapped to their Unicode points.
  * @param[in] format target font format
  * @param[in] charcodes character codes of the glyphs to be considered
  * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
  * @return name of the created font file */
-string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes, GFGlyphTracer::Callback *cb) const {
-	string tmpdir = FileSystem::tmpdir();
-	string basename = tmpdir+_font.name()+"-tmp";
+string FontWriter::createFontFile (FontFormat format, const CharSet &charcodes, GFGlyphTracer::Callback *cb) const {
+	string basename = temp_basename(_font);
 	string ttfname = basename+".ttf";
 	string targetname = basename+"."+fontFormatInfo(format)->formatstr_short;
-	bool ok = createTTFFile(ttfname, _font, charcodes, cb);
-	if (ok) {
-		if (format == FontFormat::WOFF || format == FontFormat::WOFF2) {
-			if (format == FontFormat::WOFF)
-				ok = TTFWriter::convertTTFToWOFF(ttfname, targetname);
-			else
-				TTFWriter::convertTTFToWOFF2(ttfname, targetname);
-			if (!PhysicalFont::KEEP_TEMP_FILES)
-				FileSystem::remove(ttfname);
-		}
-	}
-	if (!ok)
+	if (!createTTFFile(ttfname, _font, charcodes, cb) || !convert_ttf_file(ttfname, targetname, format))
 		throw FontWriterException("failed writing "+string(fontFormatInfo(format)->formatstr_short)+ " file " + targetname);
 	return targetname;
 }
@@ -160,21 +188,63 @@ string FontWriter::createFontFile (FontFormat format, const set<int> &charcodes,
  * @param[in] os stream the CSS data is written to
  * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
  * @return true on success */
-bool FontWriter::writeCSSFontFace (FontFormat format, const set<int> &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {
-	if (const FontFormatInfo *info = fontFormatInfo(format)) {
-		string filename = createFontFile(format, charcodes, cb);
-		ifstream ifs(filename, ios::binary);
-		if (ifs) {
-			os << "@font-face{"
-				<< "font-family:" << _font.name() << ';'
-				<< "src:url(data:" << info->mimetype << ";base64,";
-			util::base64_copy(ifs, os);
-			os << ") format('" << info->formatstr_long << "');}\n";
-			ifs.close();
-			if (!PhysicalFont::KEEP_TEMP_FILES)
-				FileSystem::remove(filename);
-			return true;
-		}
+bool FontWriter::writeCSSFontFace (FontFormat format, const CharSet &charcodes, ostream &os, GFGlyphTracer::Callback *cb) const {
+	if (const FontFormatInfo *info = fontFormatInfo(format))
+		return writeCSSFontFace(createFontFile(format, charcodes, cb), _font.name(), *info, os);
+	return false;
+}
+
+
+/** Creates a CSS font-face rule that contains the WOFF/TTF font data. In contrast to
+ *  writeCSSFontFace(), only the TTF data is created in the calling thread. The conversion
+ *  to the target format, which is usually the most expensive part because of the data
+ *  compression, and the encoding of the font data are processed by a thread pool.
+ * @param[in] format target font format
+ * @param[in] charcodes character codes of the glyphs to be considered
+ * @param[in] pool thread pool used to finish the font file
+ * @param[in] cb callback object that allows to react to events triggered by the glyph tracer
+ * @return future providing the CSS rule (empty if the font file couldn't be created) */
+future<string> FontWriter::createCSSFontFace (FontFormat format, const CharSet &charcodes, ThreadPool &pool, GFGlyphTracer::Callback *cb) const {
+	const FontFormatInfo *info = fontFormatInfo(format);
+	if (!info) {
+		promise<string> result;
+		result.set_value("");
+		return result.get_future();
+	}
+	string basename = temp_basename(_font);
+	string ttfname = basename+".ttf";
+	string targetname = basename+"."+info->formatstr_short;
+	if (!createTTFFile(ttfname, _font, charcodes, cb))
+		throw FontWriterException("failed writing "+string(info->formatstr_short)+ " file " + targetname);
+	string fontname = _font.name();
+	return pool.enqueue([=]() {
+		if (!convert_ttf_file(ttfname, targetname, format))
+			throw FontWriterException("failed writing "+string(info->formatstr_short)+ " file " + targetname);
+		ostringstream oss;
+		writeCSSFontFace(targetname, fontname, *info, oss);
+		return oss.str();
+	});
+}
+
+
+/** Writes a CSS font-face rule containing the data of a font file to an output stream.
+ * @param[in] fontfile name/path of the font file (removed after reading it)
+ * @param[in] fontname name of the font family
+ * @param[in] info information about the format of the font file
+ * @param[in] os stream the CSS data is written to
+ * @return true on success */
+bool FontWriter::writeCSSFontFace (const string &fontfile, const string &fontname, const FontFormatInfo &info, ostream &os) {
+	ifstream ifs(fontfile, ios::binary);
+	if (ifs) {
+		os << "@font-face{"
+			<< "font-family:" << fontname << ';'
+			<< "src:url(data:" << info.mimetype << ";base64,";
+		util::base64_copy(ifs, os);
+		os << ") format('" << info.formatstr_long << "');}\n";
+		ifs.close();
+		if (!PhysicalFont::KEEP_TEMP_FILES)
+			FileSystem::remove(fontfile);
+		return true;
 	}
 	return false;
 }
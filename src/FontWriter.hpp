@@ -21,14 +21,16 @@
 #ifndef FONTWRITER_HPP
 #define FONTWRITER_HPP
 
+#include <future>
 #include <ostream>
-#include <set>
 #include <string>
 #include <vector>
+#include "CharSet.hpp"
 #include "GFGlyphTracer.hpp"
 #include "MessageException.hpp"
 
 class PhysicalFont;
+class ThreadPool;
 
 class FontWriter {
 	public:
@@ -37,8 +39,9 @@ class FontWriter {
 
 	public:
 		explicit FontWriter (const PhysicalFont &font) : _font(font) {}
-		std::string createFontFile (FontFormat format, const std::set<int> &charcodes, GFGlyphTracer::Callback *cb=nullptr) const;
-		bool writeCSSFontFace (FontFormat format, const std::set<int> &charcodes, std::ostream &os, GFGlyphTracer::Callback *cb=nullptr) const;
+		std::string createFontFile (FontFormat format, const CharSet &charcodes, GFGlyphTracer::Callback *cb=nullptr) const;
+		bool writeCSSFontFace (FontFormat format, const CharSet &charcodes, std::ostream &os, GFGlyphTracer::Callback *cb=nullptr) const;
+		std::future<std::string> createCSSFontFace (FontFormat format, const CharSet &charcodes, ThreadPool &pool, GFGlyphTracer::Callback *cb=nullptr) const;
 		static FontFormat toFontFormat (std::string formatstr);
 		static std::vector<std::string> supportedFormats ();
 
@@ -50,7 +53,8 @@ class FontWriter {
 			const char *formatstr_long;
 		};
 		static const FontFormatInfo* fontFormatInfo (FontFormat format);
-		bool createTTFFile (const std::string &ttfname, const PhysicalFont &font, const std::set<int> &charcodes, GFGlyphTracer::Callback *cb) const;
+		bool createTTFFile (const std::string &ttfname, const PhysicalFont &font, const CharSet &charcodes, GFGlyphTracer::Callback *cb) const;
+		static bool writeCSSFontFace (const std::string &fontfile, const std::string &fontname, const FontFormatInfo &info, std::ostream &os);
 
 	private:
 		const PhysicalFont &_font;
@@ -22,6 +22,7 @@
 #include "HyperlinkManager.hpp"
 #include "InputReader.hpp"
 #include "SpecialActions.hpp"
+#include "SpecialManager.hpp"
 
 using namespace std;
 
@@ -42,7 +43,11 @@ void HtmlSpecialHandler::preprocess (const string&, istream &is, SpecialActions
 
 
 bool HtmlSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
-	_active = true;
+	if (!_active) {
+		_active = true;
+		// track the DVI position in order to detect line breaks inside anchors
+		SpecialManager::instance().subscribe(this, EV_MOVE);
+	}
 	StreamInputReader ir(is);
 	ir.skipSpace();
 	map<string,string> attribs;
@@ -75,6 +80,7 @@ void HtmlSpecialHandler::dviMovedTo (double x, double y, SpecialActions &actions
 void HtmlSpecialHandler::dviEndPage (unsigned pageno, SpecialActions &actions) {
 	if (_active) {
 		HyperlinkManager::instance().createViews(pageno, actions);
+		SpecialManager::instance().unsubscribe(this, EV_MOVE);
 		_active = false;
 	}
 }
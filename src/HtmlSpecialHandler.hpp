@@ -30,11 +30,13 @@ class SpecialActions;
 class HtmlSpecialHandler : public SpecialHandler {
 	public:
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* info () const override {return "hyperref specials";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "html";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 
 	protected:
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
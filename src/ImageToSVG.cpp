@@ -23,10 +23,14 @@
 #include <sstream>
 #include "Calculator.hpp"
 #include "DvisvgmSpecialHandler.hpp"
+#include "EventStream.hpp"
 #include "ImageToSVG.hpp"
+#include "MemoryMonitor.hpp"
+#include "PageBudget.hpp"
 #include "Message.hpp"
 #include "MessageException.hpp"
 #include "PageRanges.hpp"
+#include "Profiler.hpp"
 #include "PsSpecialHandler.hpp"
 #include "optimizer/SVGOptimizer.hpp"
 #include "SVGOutput.hpp"
@@ -73,6 +77,7 @@ void ImageToSVG::convert (int pageno) {
 	_currentPageNumber = pageno;
 	if (!isSinglePageFormat())
 		ss << " page=" << pageno << " proc=gs";
+	_psHandler.clearBitmapIDs();  // each page is written to a separate SVG document
 	try {
 		_psHandler.process(psSpecialCmd(), ss, *this);
 	}
@@ -84,18 +89,74 @@ void ImageToSVG::convert (int pageno) {
 }
 
 
+/** Converts a single page and records its statistics and events.
+ *  @param[in] pageno number of page to convert */
+void ImageToSVG::convertPage (int pageno) {
+	_pageStartTime = System::time();
+	if (EventStream::enabled())
+		EventStream::instance().write(EventStream::Event("page-started").add("page", pageno).add("pages", totalPageCount()));
+	MemoryMonitor::beginPage();
+	PageBudget::beginPage();
+	Profiler::instance().beginPage(pageno);
+	try {
+		convert(pageno);
+	}
+	catch (const PageMemoryException &e) {
+		abortPage(pageno, e.what());
+		return;
+	}
+	Profiler::instance().endPage();
+}
+
+
+/** Discards the current page after its conversion has been aborted.
+ *  @param[in] pageno number of the aborted page
+ *  @param[in] reason description of the cause */
+void ImageToSVG::abortPage (int pageno, const string &reason) {
+	Profiler::instance().endPage();
+	_bbox.invalidate();
+	_svg.reset();
+	Message::estream(true) << "page " << pageno << ": " << reason << ", page skipped\n";
+	if (EventStream::enabled()) {
+		FilePath path = _out.filepath(pageno, totalPageCount());
+		EventStream::Event event("page-finished");
+		event.add("page", pageno).add("file", path.empty() ? "" : path.absolute()).add("success", false);
+		event.add("error", reason).add("duration", System::time()-_pageStartTime);
+		EventStream::instance().write(event);
+	}
+}
+
+
 void ImageToSVG::writeSVG (int pageno) {
 	progress(nullptr);
+	MemoryMonitor::checkPageLimit();
 	Matrix matrix = getUserMatrix(_bbox);
 	// output SVG file
-	SVGOptimizer(_svg).execute();
+	if (!PageBudget::exceeded()) {
+		SVGOptimizer(_svg).execute();
+		MemoryMonitor::checkPageLimit();
+	}
+	else
+		PageBudget::degrade(PageBudget::NO_OPTIMIZER);
 	_svg.transformPage(matrix);
 	_bbox.transform(matrix);
 	_svg.setBBox(_bbox);
 	_svg.appendToDoc(util::make_unique<XMLComment>(" This file was generated by dvisvgm " + string(PROGRAM_VERSION) + " "));
+	string degradations = PageBudget::degradationString();
+	if (!degradations.empty())
+		PageBudget::reportDegradations(_svg, pageno);
 	bool success = _svg.write(_out.getPageStream(pageno, totalPageCount()));
-	string svgfname = _out.filepath(pageno, totalPageCount()).shorterAbsoluteOrRelative();
+	FilePath svgpath = _out.filepath(pageno, totalPageCount());
+	string svgfname = svgpath.shorterAbsoluteOrRelative();
 	_out.finish();
+	if (EventStream::enabled()) {
+		EventStream::Event event("page-finished");
+		event.add("page", pageno).add("file", svgpath.empty() ? "" : svgpath.absolute()).add("success", success);
+		if (!degradations.empty())
+			event.add("degraded", degradations);
+		event.add("bbox", _bbox).add("duration", System::time()-_pageStartTime);
+		EventStream::instance().write(event);
+	}
 	if (svgfname.empty())
 		svgfname = "<stdout>";
 	if (!success)
@@ -122,7 +183,7 @@ void ImageToSVG::convert (int firstPage, int lastPage, pair<int,int> *pageinfo)
 	checkGSAndFileFormat();
 	int pageCount = 1;       // number of pages converted
 	if (isSinglePageFormat())
-		convert(1);
+		convertPage(1);
 	else {
 		if (firstPage > lastPage)
 			swap(firstPage, lastPage);
@@ -133,7 +194,7 @@ void ImageToSVG::convert (int firstPage, int lastPage, pair<int,int> *pageinfo)
 			lastPage = min(totalPageCount(), lastPage);
 			pageCount = lastPage-firstPage+1;
 			for (int i=firstPage; i <= lastPage; i++)
-				convert(i);
+				convertPage(i);
 		}
 	}
 	if (pageinfo) {
@@ -150,11 +211,25 @@ void ImageToSVG::convert (const std::string &rangestr, pair<int,int> *pageinfo)
 		throw MessageException("invalid page range format");
 
 	int pageCount=0;  // number of pages converted
-	for (const auto &range : ranges) {
-		convert(range.first, range.second, pageinfo);
-		if (pageinfo)
-			pageCount += pageinfo->first;
+	// keep multi-page documents open so that they are parsed only once
+	_psHandler.keepPDFOpen(!isSinglePageFormat());
+	try {
+		for (const auto &range : ranges) {
+			convert(range.first, range.second, pageinfo);
+			if (pageinfo)
+				pageCount += pageinfo->first;
+		}
+	}
+	catch (...) {
+		try {
+			_psHandler.keepPDFOpen(false);
+		}
+		catch (...) {
+			// keep the original exception if closing the file fails too
+		}
+		throw;
 	}
+	_psHandler.keepPDFOpen(false);
 	if (pageinfo)
 		pageinfo->first = pageCount;
 }
@@ -195,22 +270,26 @@ void ImageToSVG::progress (const char *id) {
 }
 
 
+/** Sets the transformation commands applied to the graphics. They are compiled
+ *  once and evaluated with the bounding box of the respective page.
+ *  @param[in] transCmds transformation commands given by the user */
+void ImageToSVG::setPageTransformation (const string &transCmds) {
+	Calculator calc;
+	// add constants for length units to calculator
+	for (const auto &unit : Length::getUnits())
+		calc.setVariable(unit.first, Length(1, unit.second).pt());
+	_transformation = CompiledTransformation(transCmds, calc, {"ux", "uy", "w", "h"});
+}
+
+
 /** Returns the matrix describing the graphics transformations
  *  given by the user in terms of transformation commands.
  *  @param[in] bbox bounding box of the graphics to transform */
 Matrix ImageToSVG::getUserMatrix (const BoundingBox &bbox) const {
 	Matrix matrix(1);
-	if (!_transCmds.empty()) {
+	if (!_transformation.empty()) {
 		const double bp2pt = (1_bp).pt();
-		Calculator calc;
-		calc.setVariable("ux", bbox.minX()*bp2pt);
-		calc.setVariable("uy", bbox.minY()*bp2pt);
-		calc.setVariable("w",  bbox.width()*bp2pt);
-		calc.setVariable("h",  bbox.height()*bp2pt);
-		// add constants for length units to calculator
-		for (const auto &unit : Length::getUnits())
-			calc.setVariable(unit.first, Length(1, unit.second).pt());
-		matrix.set(_transCmds, calc);
+		matrix = _transformation.eval({bbox.minX()*bp2pt, bbox.minY()*bp2pt, bbox.width()*bp2pt, bbox.height()*bp2pt});
 	}
 	return matrix;
 }
@@ -36,7 +36,7 @@ class ImageToSVG : protected SpecialActions {
 		virtual void convert (int pageno);
 		void convert (int firstPage, int lastPage, std::pair<int,int> *pageinfo);
 		void convert (const std::string &rangestr, std::pair<int,int> *pageinfo);
-		void setPageTransformation (const std::string &transCmds) {_transCmds = transCmds;}
+		void setPageTransformation (const std::string &transCmds);
 		void setUserMessage (const std::string &msg) {_userMessage = msg;}
 		std::string filename () const {return _fname;}
 		PSInterpreter& psInterpreter () const {return _psHandler.psInterpreter();}
@@ -52,6 +52,8 @@ class ImageToSVG : protected SpecialActions {
 		virtual std::string psSpecialCmd () const =0;
 		int gsVersion () const                                  {return _gsVersion;}
 		virtual void writeSVG (int pageno);
+		void convertPage (int pageno);
+		void abortPage (int pageno, const std::string &reason);
 		// implement abstract base class SpecialActions
 		double getX () const override                           {return _x;}
 		double getY () const override                           {return _y;}
@@ -88,7 +90,8 @@ class ImageToSVG : protected SpecialActions {
 		BoundingBox _bbox;
 		mutable PsSpecialHandler _psHandler;
 		int _gsVersion=0;         ///< Ghostscript version found
-		std::string _transCmds;   ///< transformation commands
+		double _pageStartTime=0;  ///< time the conversion of the current page started
+		CompiledTransformation _transformation;  ///< transformation commands
 		std::string _userMessage; ///< message printed after conversion
 };
 
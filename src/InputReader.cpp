@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <functional>
@@ -82,48 +83,27 @@ string StringMatcher::read (InputReader &ir) {
 
 ///////////////////////////////////////////////////////////////////////////
 
-/** Skips n characters. */
-void InputReader::skip (size_t n) {
-	while (n-- > 0)
-		get();
-}
-
+// The parsing algorithms are implemented as function templates in order to use
+// them for all reader types. When instantiated for the final class CharInputReader,
+// the calls of get() and peek() are resolved statically and can be inlined.
 
 /** Moves the buffer pointer to the next non-space character. A following call
  *  of get() returns this character. */
-void InputReader::skipSpace () {
-	while (isspace(peek()))
-		get();
-}
-
-
-/** Tries to find a given string and skips all characters preceding that string. If
- *  the string can't be found, all characters until EOF are skipped.
- *  @param[in] str string to look for (must not be longer than the maximal buffer size)
- *  @return true if str was found */
-bool InputReader::skipUntil (const char *str) {
-	StringMatcher matcher(str);
-	return matcher.match(*this);
-}
-
-
-/** Tries to find a given string and returns all characters including that string. If
- *  the string can't be found, all characters until EOF are read.
- *  @param[in] str string to look for (must not be longer than the maximal buffer size)
- *  @return the read characters */
-string InputReader::readUntil (const char *str) {
-	StringMatcher matcher(str);
-	return matcher.read(*this);
+template <typename Reader>
+static void skip_space (Reader &ir) {
+	while (isspace(ir.peek()))
+		ir.get();
 }
 
 
 /** Looks for the first occurrence of a given character.
  *  @param[in] c character to lookup
  *  @return position of character relative to current location, -1 if character was not found */
-int InputReader::find (char c) const {
+template <typename Reader>
+static int find_char (const Reader &ir, char c) {
 	int pos = 0;
 	int cc;
-	while ((cc = peek(pos)) >= 0 && cc != c)
+	while ((cc = ir.peek(pos)) >= 0 && cc != c)
 		pos++;
 	return cc < 0 ? -1 : pos;
 }
@@ -133,14 +113,15 @@ int InputReader::find (char c) const {
  *  @param[in] s string to be matched
  *  @param[in] consume if true, the characters of the matched string are skipped
  *  @return true if s matches */
-bool InputReader::check (const char *s, bool consume) {
+template <typename Reader>
+static bool check_string (Reader &ir, const char *s, bool consume) {
 	size_t count = 0;
 	for (const char *p=s; *p; p++) {
-		if (peek(count++) != *p)
+		if (ir.peek(count++) != uint8_t(*p))
 			return false;
 	}
 	if (consume)
-		skip(count);
+		ir.skip(count);
 	return true;
 }
 
@@ -151,52 +132,55 @@ bool InputReader::check (const char *s, bool consume) {
  *  @param[out] val contains the read integer value on success
  *  @param[in] accept_sign if false, only positive integers (without sign) are accepted
  *  @return true if integer could be read */
-bool InputReader::parseInt (int &val, bool accept_sign) {
+template <typename Reader>
+static bool parse_int (Reader &ir, int &val, bool accept_sign) {
 	val = 0;
 	int fac=1;
 	int sign;    // explicitly given sign
-	if (accept_sign && ((sign = peek()) == '+' || sign == '-')) {
-		if (isdigit(peek(1))) {
-			get();  // skip sign
+	if (accept_sign && ((sign = ir.peek()) == '+' || sign == '-')) {
+		if (isdigit(ir.peek(1))) {
+			ir.get();  // skip sign
 			if (sign == '-')
 				fac = -1;
 		}
 		else
 			return false;
 	}
-	else if (!isdigit(peek()))
+	else if (!isdigit(ir.peek()))
 		return false;
 
-	while (isdigit(peek()))
-		val = val*10 + (get()-'0');
+	while (isdigit(ir.peek()))
+		val = val*10 + (ir.get()-'0');
 	val *= fac;
 	return true;
 }
 
 
-bool InputReader::parseUInt (unsigned &val) {
+template <typename Reader>
+static bool parse_uint (Reader &ir, unsigned &val) {
 	val = 0;
-	if (!isdigit(peek()))
+	if (!isdigit(ir.peek()))
 		return false;
-	while (isdigit(peek()))
-		val = val*10 + (get()-'0');
+	while (isdigit(ir.peek()))
+		val = val*10 + (ir.get()-'0');
 	return true;
 }
 
 
-bool InputReader::parseUInt (int base, unsigned &val) {
+template <typename Reader>
+static bool parse_uint (Reader &ir, int base, unsigned &val) {
 	if (base < 2 || base > 32)
 		return false;
 
 	const char *digits = "0123456789abcdefghijklmnopqrstuvwxyz";
 	const char maxdigit = digits[base-1];
 	int c;
-	if (!isalnum(c = tolower(peek())) || c > maxdigit)
+	if (!isalnum(c = tolower(ir.peek())) || c > maxdigit)
 		return false;
 
 	val = 0;
-	while (isalnum(c = tolower(peek())) && c <= maxdigit) {
-		get();
+	while (isalnum(c = tolower(ir.peek())) && c <= maxdigit) {
+		ir.get();
 		unsigned digit = c - (c <= '9' ? '0' : 'a'-10);
 		val = val*base + digit;
 	}
@@ -209,15 +193,16 @@ bool InputReader::parseUInt (int base, unsigned &val) {
  *  the buffer pointer points to the same position as before the function call.
  *  @param[out] val contains the read double value on success
  *  @return number details: 0=no number, 'i'=integer, 'f'=floating point number */
-char InputReader::parseDouble (double &val) {
+template <typename Reader>
+static char parse_double (Reader &ir, double &val) {
 	int fac=1;
 	int int_part=0;
 	bool is_float = false;
-	skipSpace();
-	int sign = peek();
-	if (parseInt(int_part)) { // match [+-]?[0-9]+\.?
-		if (peek() == '.') {
-			get();
+	ir.skipSpace();
+	int sign = ir.peek();
+	if (ir.parseInt(int_part)) { // match [+-]?[0-9]+\.?
+		if (ir.peek() == '.') {
+			ir.get();
 			is_float = true;
 		}
 		if (int_part < 0 || sign == '-') {
@@ -226,30 +211,30 @@ char InputReader::parseDouble (double &val) {
 		}
 	}
 	else {  // match [+-]?\.
-		if ((sign = peek()) == '+' || sign == '-') { // match [+-]?\.[0-9]
-			if (peek(1) != '.' || !isdigit(peek(2)))
+		if ((sign = ir.peek()) == '+' || sign == '-') { // match [+-]?\.[0-9]
+			if (ir.peek(1) != '.' || !isdigit(ir.peek(2)))
 				return 0;
 			if (sign == '-')
 				fac = -1;
-			skip(2);  // skip sign and dot
+			ir.skip(2);  // skip sign and dot
 		}
-		else if (peek() == '.' && isdigit(peek(1)))
-			get();
+		else if (ir.peek() == '.' && isdigit(ir.peek(1)))
+			ir.get();
 		else
 			return 0;
 		is_float = true;
 	}
 	// parse fractional part
 	double frac_part=0.0;
-	for (double u=10; isdigit(peek()); u*=10)
-		frac_part += (get()-'0')/u;
+	for (double u=10; isdigit(ir.peek()); u*=10)
+		frac_part += (ir.get()-'0')/u;
 	val = (int_part + frac_part) * fac;
 	// parse exponent
 	int c;
-	if (tolower(peek()) == 'e' && (isdigit(c=peek(1)) || ((c == '+' || c == '-') && isdigit(peek(2))))) {
-		get(); // skip 'e'
+	if (tolower(ir.peek()) == 'e' && (isdigit(c=ir.peek(1)) || ((c == '+' || c == '-') && isdigit(ir.peek(2))))) {
+		ir.get(); // skip 'e'
 		int exp;
-		parseInt(exp);
+		ir.parseInt(exp);
 		val *= pow(10.0, exp);
 		is_float = true;
 	}
@@ -259,39 +244,43 @@ char InputReader::parseDouble (double &val) {
 
 /** Reads an integer value from the buffer. If no valid integer constant
  *  could be found at the current position 0 is returned. */
-int InputReader::getInt () {
-	skipSpace();
+template <typename Reader>
+static int get_int (Reader &ir) {
+	ir.skipSpace();
 	int val;
-	return parseInt(val) ? val : 0;
+	return ir.parseInt(val) ? val : 0;
 }
 
 
 /** Reads an double value from the buffer. If no valid double constant
  *  could be found at the current position 0 is returned. */
-double InputReader::getDouble () {
-	skipSpace();
+template <typename Reader>
+static double get_double (Reader &ir) {
+	ir.skipSpace();
 	double val;
-	return parseDouble(val) ? val : 0.0;
+	return ir.parseDouble(val) ? val : 0.0;
 }
 
 
 /** Reads a string that consists of alphabetic letters only. Reading stops as
  *  soon as a non-alphabetic character is found or EOF is reached. */
-string InputReader::getWord () {
+template <typename Reader>
+static string get_word (Reader &ir) {
 	string ret;
-	skipSpace();
-	while (isalpha(peek()))
-		ret += char(get());
+	ir.skipSpace();
+	while (isalpha(ir.peek()))
+		ret += char(ir.get());
 	return ret;
 }
 
 
 /** Reads a single punctuation character.
  *  @return the read character or 0 if there's no punctuation character at the current position */
-char InputReader::getPunct () {
-	skipSpace();
-	if (ispunct(peek()))
-		return char(get());
+template <typename Reader>
+static char get_punct (Reader &ir) {
+	ir.skipSpace();
+	if (ispunct(ir.peek()))
+		return char(ir.get());
 	return 0;
 }
 
@@ -304,17 +293,18 @@ char InputReader::getPunct () {
  *  is identical to a call of getString().
  *  @param[in] quotechars recognized quotation characters bounding the string to be read
  *  @return the string read */
-string InputReader::getQuotedString (const char *quotechars) {
+template <typename Reader>
+static string get_quoted_string (Reader &ir, const char *quotechars) {
 	if (!quotechars)
-		return getString();
+		return ir.getString();
 
 	string ret;
-	skipSpace();
-	if (const char *quotechar = strchr(quotechars, peek())) {
-		get();
-		while (!eof() && peek() != *quotechar)
-			ret += char(get());
-		get();
+	ir.skipSpace();
+	if (const char *quotechar = strchr(quotechars, ir.peek())) {
+		ir.get();
+		while (!ir.eof() && ir.peek() != *quotechar)
+			ret += char(ir.get());
+		ir.get();
 	}
 	return ret;
 }
@@ -325,22 +315,12 @@ string InputReader::getQuotedString (const char *quotechars) {
  *  all printable characters to the result until a whitespace, an unprintable character, or
  *  EOF is found.
  *  @return the string read */
-string InputReader::getString () {
-	string ret;
-	skipSpace();
-	while (!eof() && !isspace(peek()) && isprint(peek()))
-		ret += char(get());
-	return ret;
-}
-
-
-/** Reads a given number of characters and returns the resulting string.
- *  @param n number of character to read
- *  @return the string read */
-string InputReader::getString (size_t n) {
+template <typename Reader>
+static string get_string (Reader &ir) {
 	string ret;
-	while (n-- > 0)
-		ret += char(get());
+	ir.skipSpace();
+	while (!ir.eof() && !isspace(ir.peek()) && isprint(ir.peek()))
+		ret += char(ir.get());
 	return ret;
 }
 
@@ -348,26 +328,88 @@ string InputReader::getString (size_t n) {
 /** Reads a string delimited by EOF or a single character from a given set of characters.
  *  @param[in] delim characters delimiting the string
  *  @return the read string */
-string InputReader::getString (const char *delim) {
+template <typename Reader>
+static string get_string (Reader &ir, const char *delim) {
 	if (!delim || !delim[0])
-		return getString();
+		return ir.getString();
 	string ret;
-	skipSpace();
-	while (!eof() && peek() > 0 && !strchr(delim, peek()))
-		ret += char(get());
+	ir.skipSpace();
+	while (!ir.eof() && ir.peek() > 0 && !strchr(delim, ir.peek()))
+		ret += char(ir.get());
 	return ret;
 }
 
 
-string InputReader::getLine () {
+template <typename Reader>
+static string get_line (Reader &ir) {
 	string ret;
-	skipSpace();
-	while (!eof() && peek() > 0 && peek() != '\n')
-		ret += char(get());
+	ir.skipSpace();
+	while (!ir.eof() && ir.peek() > 0 && ir.peek() != '\n')
+		ret += char(ir.get());
 	// trim trailing whitespace
 	return ret.erase(ret.find_last_not_of(" \t\n\r\f\v")+1);
 }
 
+///////////////////////////////////////////////////////////////////////////
+
+/** Skips n characters. */
+void InputReader::skip (size_t n) {
+	while (n-- > 0)
+		get();
+}
+
+
+void InputReader::skipSpace () {
+	skip_space(*this);
+}
+
+
+/** Tries to find a given string and skips all characters preceding that string. If
+ *  the string can't be found, all characters until EOF are skipped.
+ *  @param[in] str string to look for (must not be longer than the maximal buffer size)
+ *  @return true if str was found */
+bool InputReader::skipUntil (const char *str) {
+	StringMatcher matcher(str);
+	return matcher.match(*this);
+}
+
+
+/** Tries to find a given string and returns all characters including that string. If
+ *  the string can't be found, all characters until EOF are read.
+ *  @param[in] str string to look for (must not be longer than the maximal buffer size)
+ *  @return the read characters */
+string InputReader::readUntil (const char *str) {
+	StringMatcher matcher(str);
+	return matcher.read(*this);
+}
+
+
+int InputReader::find (char c) const                    {return find_char(*this, c);}
+bool InputReader::check (const char *s, bool consume)   {return check_string(*this, s, consume);}
+bool InputReader::parseInt (int &val, bool accept_sign) {return parse_int(*this, val, accept_sign);}
+bool InputReader::parseUInt (unsigned &val)             {return parse_uint(*this, val);}
+bool InputReader::parseUInt (int base, unsigned &val)   {return parse_uint(*this, base, val);}
+char InputReader::parseDouble (double &val)             {return parse_double(*this, val);}
+int InputReader::getInt ()                              {return get_int(*this);}
+double InputReader::getDouble ()                        {return get_double(*this);}
+string InputReader::getWord ()                          {return get_word(*this);}
+char InputReader::getPunct ()                           {return get_punct(*this);}
+string InputReader::getQuotedString (const char *quotechars) {return get_quoted_string(*this, quotechars);}
+string InputReader::getString ()                        {return get_string(*this);}
+string InputReader::getString (const char *delim)       {return get_string(*this, delim);}
+string InputReader::getLine ()                          {return get_line(*this);}
+
+
+/** Reads a given number of characters and returns the resulting string.
+ *  @param n number of character to read
+ *  @return the string read */
+string InputReader::getString (size_t n) {
+	string ret;
+	while (n-- > 0)
+		ret += char(get());
+	return ret;
+}
+
 
 /** Parses a sequence of key-value pairs of the form KEY=VALUE or KEY="VALUE".
  *  If parameter 'requireValues' is false, attributes may also consist of a key only.
@@ -424,4 +466,39 @@ streamsize BufferInputReader::read (char *buf, streamsize size) {
 	while (c >= 0 && size-- > 0)
 		*p++ = char(c);
 	return p-buf;
-}
\ No newline at end of file
+}
+
+streamsize CharInputReader::read (char *buf, streamsize size) {
+	size = min(size, streamsize(_end-_pos));
+	memcpy(buf, _pos, size);
+	_pos += size;
+	return size;
+}
+
+
+void CharInputReader::skip (size_t n) {
+	_pos += min(n, size_t(_end-_pos));
+}
+
+
+int CharInputReader::find (char c) const {
+	if (const void *p = memchr(_pos, c, _end-_pos))
+		return int(static_cast<const char*>(p)-_pos);
+	return -1;
+}
+
+
+void CharInputReader::skipSpace ()                         {skip_space(*this);}
+bool CharInputReader::check (const char *s, bool consume)   {return check_string(*this, s, consume);}
+bool CharInputReader::parseInt (int &val, bool accept_sign) {return parse_int(*this, val, accept_sign);}
+bool CharInputReader::parseUInt (unsigned &val)             {return parse_uint(*this, val);}
+bool CharInputReader::parseUInt (int base, unsigned &val)   {return parse_uint(*this, base, val);}
+char CharInputReader::parseDouble (double &val)             {return parse_double(*this, val);}
+int CharInputReader::getInt ()                              {return get_int(*this);}
+double CharInputReader::getDouble ()                        {return get_double(*this);}
+string CharInputReader::getWord ()                          {return get_word(*this);}
+char CharInputReader::getPunct ()                           {return get_punct(*this);}
+string CharInputReader::getQuotedString (const char *quotechars) {return get_quoted_string(*this, quotechars);}
+string CharInputReader::getString ()                        {return get_string(*this);}
+string CharInputReader::getString (const char *delim)       {return get_string(*this, delim);}
+string CharInputReader::getLine ()                          {return get_line(*this);}
@@ -21,6 +21,7 @@
 #ifndef INPUTREADER_HPP
 #define INPUTREADER_HPP
 
+#include <cstdint>
 #include <istream>
 #include <map>
 #include <string>
@@ -90,6 +91,45 @@ class BufferInputReader : public InputReader {
 };
 
 
+/** Reads characters from a block of memory that must remain valid while the reader
+ *  is used. Since the characters are accessed directly and the class can't be derived
+ *  from, the parsing functions work without virtual calls of get() and peek(). */
+class CharInputReader final : public InputReader {
+	public:
+		CharInputReader (const char *buf, size_t size) : _pos(buf), _end(buf ? buf+size : buf) {}
+		explicit CharInputReader (const std::string &str) : CharInputReader(str.data(), str.length()) {}
+		int get () override                {return _pos < _end ? uint8_t(*_pos++) : -1;}
+		std::streamsize read (char *buf, std::streamsize size) override;
+		int peek () const override         {return _pos < _end ? uint8_t(*_pos) : -1;}
+		int peek (size_t n) const override {return n < size_t(_end-_pos) ? uint8_t(_pos[n]) : -1;}
+		bool eof () const override         {return _pos >= _end;}
+		bool check (char c) const override {return peek() == c;}
+		bool check (const char *s, bool consume=true) override;
+		void skip (size_t n) override;
+		int find (char c) const override;
+		void skipSpace () override;
+		int getInt () override;
+		bool parseInt (int &val, bool accept_sign=true) override;
+		bool parseUInt (int base, unsigned &val) override;
+		bool parseUInt (unsigned &val) override;
+		char parseDouble (double &val) override;
+		double getDouble () override;
+		std::string getWord () override;
+		char getPunct () override;
+		std::string getQuotedString (const char *quotechars) override;
+		std::string getString () override;
+		std::string getString (const char *delim) override;
+		std::string getLine () override;
+		using InputReader::getString;
+		const char* pos () const {return _pos;}
+		size_t remaining () const {return size_t(_end-_pos);}
+
+	private:
+		const char *_pos;  ///< pointer to next character to read
+		const char *_end;  ///< pointer to first character behind the buffer
+};
+
+
 /** Implementation of the Knuth-Morris-Pratt search algorithm.
  *  http://www.inf.fh-flensburg.de/lang/algorithmen/pattern/kmpen.htm */
 class StringMatcher {
@@ -20,7 +20,6 @@
 
 #include <cstring>
 #include <sstream>
-#include "InputBuffer.hpp"
 #include "InputReader.hpp"
 #include "MapLine.hpp"
 #include "Subfont.hpp"
@@ -93,8 +92,7 @@ static bool split_fontname (string &fontname, string &sfdname) {
  *  @param[in] line the mapline */
 void MapLine::parse (const char *line) {
 	if (line) {
-		CharInputBuffer ib(line, strlen(line));
-		BufferInputReader ir(ib);
+		CharInputReader ir(line, strlen(line));
 		_texname = ir.getString();
 		string sfdname;
 		split_fontname(_texname, sfdname);
@@ -128,8 +126,7 @@ void MapLine::parseDVIPSLine (InputReader &ir) {
 		}
 		else {  // ir.peek() == '"' => list of PS font operators
 			string options = ir.getQuotedString("\"");
-			StringInputBuffer sib(options);
-			BufferInputReader sir(sib);
+			CharInputReader sir(options);
 			while (!sir.eof()) {
 				double number;
 				if (sir.parseDouble(number)) {
@@ -231,8 +228,7 @@ void MapLine::parseDVIPDFMLine (InputReader &ir) {
 /** [:INDEX:][!]FONTNAME[/CSI][,VARIANT] */
 void MapLine::parseFilenameOptions (string fname) {
 	_fontfname = fname;
-	StringInputBuffer ib(fname);
-	BufferInputReader ir(ib);
+	CharInputReader ir(fname);
 	if (ir.peek() == ':' && isdigit(ir.peek(1))) {  // index given?
 		ir.get();
 		_fontindex = ir.getInt();  // font index of file with multiple fonts
@@ -347,98 +347,8 @@ bool Matrix::isTranslation (double &tx, double &ty) const {
 }
 
 
-/** Gets a parameter for the transformation command.
- *  @param[in] is parameter chars are read from this stream
- *  @param[in] calc parameters can be arithmetic expressions, so we need a calculator to evaluate them
- *  @param[in] def default value if parameter is optional
- *  @param[in] optional true if parameter is optional
- *  @param[in] leadingComma true if first non-blank must be a comma
- *  @return value of argument */
-static double getArgument (istream &is, Calculator &calc, double def, bool optional, bool leadingComma) {
-	is >> ws;
-	if (!optional && leadingComma && is.peek() != ',')
-		throw ParserException("',' expected");
-	if (is.peek() == ',') {
-		is.get();         // skip comma
-		optional = false; // now we expect a parameter
-	}
-	string expr;
-	while (!isupper(is.peek()) && is.peek() != ',' && is)
-		expr += (char)is.get();
-	if (expr.length() == 0) {
-		if (optional)
-			return def;
-		else
-			throw ParserException("parameter expected");
-	}
-	return calc.eval(expr);
-}
-
-
 Matrix Matrix::parse (istream &is, Calculator &calc) {
-	Matrix ret(1);
-	while (is) {
-		is >> ws;
-		int cmd = is.get();
-		switch (cmd) {
-			case 'T': {
-				double tx = getArgument(is, calc, 0, false, false);
-				double ty = getArgument(is, calc, 0, true, true);
-				ret.translate(tx, ty);
-				break;
-			}
-			case 'S': {
-				double sx = getArgument(is, calc, 1, false, false);
-				double sy = getArgument(is, calc, sx, true, true );
-				ret.scale(sx, sy);
-				break;
-			}
-			case 'R': {
-				double a = getArgument(is, calc, 0, false, false);
-				double x = getArgument(is, calc, calc.getVariable("ux")+calc.getVariable("w")/2, true, true);
-				double y = getArgument(is, calc, calc.getVariable("uy")+calc.getVariable("h")/2, true, true);
-				ret.translate(-x, -y);
-				ret.rotate(a);
-				ret.translate(x, y);
-				break;
-			}
-			case 'F': {
-				int c = is.get();
-				if (c != 'H' && c != 'V')
-					throw ParserException("'H' or 'V' expected");
-				double a = getArgument(is, calc, 0, false, false);
-				ret.flip(c == 'H', a);
-				break;
-			}
-			case 'K': {
-				int c = is.get();
-				if (c != 'X' && c != 'Y')
-					throw ParserException("transformation command 'K' must be followed by 'X' or 'Y'");
-				double a = getArgument(is, calc, 0, false, false);
-				if (std::abs(cos(deg2rad(a))) < numeric_limits<double>::epsilon())
-					throw ParserException("illegal skewing angle: " + util::to_string(a) + " degrees");
-				if (c == 'X')
-					ret.xskewByAngle(a);
-				else
-					ret.yskewByAngle(a);
-				break;
-			}
-			case 'M': {
-				double v[9];
-				for (int i=0; i < 6; i++)
-					v[i] = getArgument(is, calc, i%4 ? 0 : 1, i!=0, i!=0);
-				// third row (0, 0, 1)
-				v[6] = v[7] = 0;
-				v[8] = 1;
-				Matrix tm(v);
-				ret.lmultiply(tm);
-				break;
-			}
-			default:
-				throw ParserException("transformation command expected (found '" + string(1, cmd) + "' instead)");
-		}
-	}
-	return ret;
+	return CompiledTransformation(is, calc).eval();
 }
 
 
@@ -621,3 +531,160 @@ YSkewingMatrix::YSkewingMatrix (double deg) {
 	double xyratio = tan(deg2rad(deg));
 	lmultiply(Matrix({1, 0, 0, xyratio}));
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+/** Gets a parameter for the transformation command.
+ *  @param[in] is parameter chars are read from this stream
+ *  @param[in] calc parameters can be arithmetic expressions, so we need a calculator to compile them
+ *  @param[in] slotNames names of the variables to be bound to slots
+ *  @param[in] def default expression if parameter is optional
+ *  @param[in] optional true if parameter is optional
+ *  @param[in] leadingComma true if first non-blank must be a comma
+ *  @return compiled argument */
+static Calculator::Expression getArgument (istream &is, const Calculator &calc, const vector<string> &slotNames, const Calculator::Expression &def, bool optional, bool leadingComma) {
+	is >> ws;
+	if (!optional && leadingComma && is.peek() != ',')
+		throw ParserException("',' expected");
+	if (is.peek() == ',') {
+		is.get();         // skip comma
+		optional = false; // now we expect a parameter
+	}
+	string expr;
+	while (!isupper(is.peek()) && is.peek() != ',' && is)
+		expr += (char)is.get();
+	if (expr.length() == 0) {
+		if (optional)
+			return def;
+		else
+			throw ParserException("parameter expected");
+	}
+	return calc.compile(expr, slotNames);
+}
+
+
+static Calculator::Expression getArgument (istream &is, const Calculator &calc, const vector<string> &slotNames, double def, bool optional, bool leadingComma) {
+	return getArgument(is, calc, slotNames, Calculator::Expression(def), optional, leadingComma);
+}
+
+
+/** Compiles a sequence of transformation commands.
+ *  @param[in] is commands are read from this stream
+ *  @param[in] calc calculator used to compile the command arguments
+ *  @param[in] slotNames names of the variables whose values are given not until evaluation */
+CompiledTransformation::CompiledTransformation (istream &is, const Calculator &calc, const vector<string> &slotNames) {
+	while (is) {
+		is >> ws;
+		int cmd = is.get();
+		if (cmd == EOF)
+			break;
+		switch (cmd) {
+			case 'T': {
+				_commands.emplace_back('T', 0);
+				auto &args = _commands.back().args;
+				args.push_back(getArgument(is, calc, slotNames, 0, false, false));
+				args.push_back(getArgument(is, calc, slotNames, 0, true, true));
+				break;
+			}
+			case 'S': {
+				_commands.emplace_back('S', 0);
+				auto &args = _commands.back().args;
+				args.push_back(getArgument(is, calc, slotNames, 1, false, false));
+				args.push_back(getArgument(is, calc, slotNames, args[0], true, true));
+				break;
+			}
+			case 'R': {
+				_commands.emplace_back('R', 0);
+				auto &args = _commands.back().args;
+				args.push_back(getArgument(is, calc, slotNames, 0, false, false));
+				args.push_back(getArgument(is, calc, slotNames, calc.compile("ux+w/2", slotNames), true, true));
+				args.push_back(getArgument(is, calc, slotNames, calc.compile("uy+h/2", slotNames), true, true));
+				break;
+			}
+			case 'F': {
+				int c = is.get();
+				if (c != 'H' && c != 'V')
+					throw ParserException("'H' or 'V' expected");
+				_commands.emplace_back('F', char(c));
+				_commands.back().args.push_back(getArgument(is, calc, slotNames, 0, false, false));
+				break;
+			}
+			case 'K': {
+				int c = is.get();
+				if (c != 'X' && c != 'Y')
+					throw ParserException("transformation command 'K' must be followed by 'X' or 'Y'");
+				_commands.emplace_back('K', char(c));
+				_commands.back().args.push_back(getArgument(is, calc, slotNames, 0, false, false));
+				break;
+			}
+			case 'M': {
+				_commands.emplace_back('M', 0);
+				auto &args = _commands.back().args;
+				for (int i=0; i < 6; i++)
+					args.push_back(getArgument(is, calc, slotNames, i%4 ? 0 : 1, i!=0, i!=0));
+				break;
+			}
+			default:
+				throw ParserException("transformation command expected (found '" + string(1, char(cmd)) + "' instead)");
+		}
+	}
+}
+
+
+CompiledTransformation::CompiledTransformation (const string &cmds, const Calculator &calc, const vector<string> &slotNames) {
+	istringstream iss;
+	iss.str(cmds);
+	*this = CompiledTransformation(iss, calc, slotNames);
+}
+
+
+/** Computes the matrix described by the transformation commands.
+ *  @param[in] slotValues values of the variables bound to slots
+ *  @return the resulting matrix */
+Matrix CompiledTransformation::eval (const vector<double> &slotValues) const {
+	Matrix ret(1);
+	for (const Command &cmd : _commands) {
+		switch (cmd.type) {
+			case 'T':
+				ret.translate(cmd.args[0].eval(slotValues), cmd.args[1].eval(slotValues));
+				break;
+			case 'S':
+				ret.scale(cmd.args[0].eval(slotValues), cmd.args[1].eval(slotValues));
+				break;
+			case 'R': {
+				double a = cmd.args[0].eval(slotValues);
+				double x = cmd.args[1].eval(slotValues);
+				double y = cmd.args[2].eval(slotValues);
+				ret.translate(-x, -y);
+				ret.rotate(a);
+				ret.translate(x, y);
+				break;
+			}
+			case 'F':
+				ret.flip(cmd.variant == 'H', cmd.args[0].eval(slotValues));
+				break;
+			case 'K': {
+				double a = cmd.args[0].eval(slotValues);
+				if (std::abs(cos(deg2rad(a))) < numeric_limits<double>::epsilon())
+					throw ParserException("illegal skewing angle: " + util::to_string(a) + " degrees");
+				if (cmd.variant == 'X')
+					ret.xskewByAngle(a);
+				else
+					ret.yskewByAngle(a);
+				break;
+			}
+			case 'M': {
+				double v[9];
+				for (int i=0; i < 6; i++)
+					v[i] = cmd.args[i].eval(slotValues);
+				// third row (0, 0, 1)
+				v[6] = v[7] = 0;
+				v[8] = 1;
+				Matrix tm(v);
+				ret.lmultiply(tm);
+				break;
+			}
+		}
+	}
+	return ret;
+}
@@ -25,6 +25,7 @@
 #include <istream>
 #include <string>
 #include <vector>
+#include "Calculator.hpp"
 #include "MessageException.hpp"
 #include "Pair.hpp"
 
@@ -33,8 +34,6 @@ struct ParserException : public MessageException {
 	explicit ParserException (const std::string &msg) : MessageException(msg) {}
 };
 
-class Calculator;
-
 class Matrix {
 	friend double det (const Matrix &m);
 	friend double det (const Matrix &m, int row, int col);
@@ -85,6 +84,29 @@ class Matrix {
 };
 
 
+/** Sequence of transformation commands (as accepted by option --transform) whose
+ *  arguments have been compiled into arithmetic expressions. The corresponding
+ *  matrix can be computed repeatedly for varying variable values without parsing
+ *  the commands again. */
+class CompiledTransformation {
+	public:
+		CompiledTransformation () =default;
+		CompiledTransformation (std::istream &is, const Calculator &calc, const std::vector<std::string> &slotNames={});
+		CompiledTransformation (const std::string &cmds, const Calculator &calc, const std::vector<std::string> &slotNames={});
+		Matrix eval (const std::vector<double> &slotValues={}) const;
+		bool empty () const {return _commands.empty();}
+
+	private:
+		struct Command {
+			Command (char t, char v) : type(t), variant(v) {}
+			char type;     ///< command character ('T', 'S', 'R', 'F', 'K', or 'M')
+			char variant;  ///< subcommand character of F and K ('H', 'V', 'X', or 'Y')
+			std::vector<Calculator::Expression> args;
+		};
+		std::vector<Command> _commands;
+};
+
+
 struct TranslationMatrix : public Matrix {
 	TranslationMatrix (double tx, double ty);
 };
@@ -0,0 +1,151 @@
+/*************************************************************************
+** MemoryMonitor.cpp                                                    **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <config.h>
+#include <cstdlib>
+#include <new>
+#include "MemoryMonitor.hpp"
+#include "Profiler.hpp"
+
+#ifdef _WIN32
+	#include "windows.hpp"
+	#include <malloc.h>
+	#define PSAPI_VERSION 2  // take GetProcessMemoryInfo from kernel32 rather than psapi.dll
+	#include <psapi.h>
+	#define MALLOC_SIZE(ptr) _msize(ptr)
+#else
+	#ifdef HAVE_SYS_RESOURCE_H
+		#include <sys/resource.h>
+	#endif
+	#if defined(__APPLE__)
+		#include <malloc/malloc.h>
+		#define MALLOC_SIZE(ptr) malloc_size(ptr)
+	#elif defined(HAVE_MALLOC_USABLE_SIZE)
+		#include <malloc.h>
+		#define MALLOC_SIZE(ptr) malloc_usable_size(ptr)
+	#endif
+#endif
+
+using namespace std;
+
+bool MemoryMonitor::ENABLED = false;
+bool MemoryMonitor::COUNT_ALLOCATIONS = false;
+atomic<int64_t> MemoryMonitor::_usage{0};
+atomic<int64_t> MemoryMonitor::_pagePeak{0};
+atomic<uint64_t> MemoryMonitor::_numAllocations{0};
+atomic<uint64_t> MemoryMonitor::_allocatedBytes{0};
+int64_t MemoryMonitor::_pageStart = 0;
+int64_t MemoryMonitor::_pageLimit = 0;
+
+
+#ifdef MALLOC_SIZE
+/* Replacements of the global allocation functions. All other variants of
+ * operator new and delete forward to these ones. The sizes of the memory
+ * blocks are taken from the allocator rather than the requested sizes in
+ * order to get matching values for allocation and release. Blocks allocated
+ * before the accounting was enabled aren't counted, so releasing them can
+ * drive the usage below zero. The reported values are therefore clamped
+ * to 0 (see MemoryMonitor::usage() and pagePeak()). */
+
+void* operator new (size_t size) {
+	void *ptr;
+	while ((ptr = malloc(size > 0 ? size : 1)) == nullptr) {
+		if (new_handler handler = get_new_handler())
+			handler();
+		else
+			throw bad_alloc();
+	}
+	if (MemoryMonitor::ENABLED)
+		MemoryMonitor::allocated(MALLOC_SIZE(ptr));
+	return ptr;
+}
+
+
+void operator delete (void *ptr) noexcept {
+	if (ptr) {
+		if (MemoryMonitor::ENABLED)
+			MemoryMonitor::released(MALLOC_SIZE(ptr));
+		free(ptr);
+	}
+}
+
+
+void operator delete (void *ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+#endif
+
+
+/** Returns true if the heap memory accounting is supported on this platform. */
+bool MemoryMonitor::available () {
+#ifdef MALLOC_SIZE
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+/** Records the allocation of a memory block.
+ *  @param[in] size size of the block in bytes */
+void MemoryMonitor::allocated (size_t size) {
+	int64_t usage = (_usage += int64_t(size));
+	if (COUNT_ALLOCATIONS) {
+		_numAllocations++;
+		_allocatedBytes += size;
+	}
+	int64_t peak = _pagePeak;
+	while (usage > peak && !_pagePeak.compare_exchange_weak(peak, usage));
+	if (Profiler::ENABLED)
+		Profiler::addAllocation(size);
+}
+
+
+/** Starts tracking the memory allocated while converting a new page. */
+void MemoryMonitor::beginPage () {
+	_pageStart = _pagePeak = _usage.load();
+}
+
+
+[[noreturn]] void MemoryMonitor::throwPageLimitExceeded () {
+	uint64_t mb = uint64_t(_pageLimit) >> 20;
+	throw PageMemoryException("page exceeds the memory limit of "+to_string(mb)+" MB");
+}
+
+
+/** Returns the maximum resident set size (physical memory used) of the process in bytes,
+ *  or 0 if the value can't be determined. */
+uint64_t MemoryMonitor::peakResidentSetSize () {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return pmc.PeakWorkingSetSize;
+#elif defined(HAVE_GETRUSAGE)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		return uint64_t(usage.ru_maxrss);        // value given in bytes
+#else
+		return uint64_t(usage.ru_maxrss) << 10;  // value given in kilobytes
+#endif
+	}
+#endif
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*************************************************************************
+** MemoryMonitor.hpp                                                    **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef MEMORYMONITOR_HPP
+#define MEMORYMONITOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "MessageException.hpp"
+
+struct PageMemoryException : MessageException {
+	explicit PageMemoryException (const std::string &msg) : MessageException(msg) {}
+};
+
+
+/** Keeps track of the heap memory allocated via operator new. If the accounting
+ *  is enabled, the replaced global allocation functions report the size of each
+ *  allocated and released memory block so that the amount of memory in use and
+ *  its peak value during the conversion of a page can be determined. Additionally,
+ *  the allocations are attributed to the phase measured by the innermost active
+ *  Profiler::Scope. The accounting is only available on platforms that provide
+ *  a function to query the size of a memory block allocated by malloc. */
+class MemoryMonitor {
+	public:
+		static bool available ();
+		static void allocated (size_t size);
+		static void released (size_t size) {_usage -= int64_t(size);}
+		static uint64_t usage ()    {return uint64_t(std::max(int64_t(0), _usage.load()));}
+		static uint64_t pagePeak () {return uint64_t(std::max(int64_t(0), _pagePeak-_pageStart));}
+		static uint64_t numAllocations () {return _numAllocations;}  ///< requires COUNT_ALLOCATIONS to be set
+		static uint64_t allocatedBytes () {return _allocatedBytes;}  ///< requires COUNT_ALLOCATIONS to be set
+		static void beginPage ();
+		static void setPageLimit (uint64_t bytes) {_pageLimit = int64_t(bytes);}
+
+		/** Throws a PageMemoryException if the memory allocated since the
+		 *  beginning of the current page exceeds the limit. */
+		static void checkPageLimit () {
+			if (_pageLimit > 0 && _usage-_pageStart > _pageLimit)
+				throwPageLimitExceeded();
+		}
+
+		static uint64_t peakResidentSetSize ();
+		static bool ENABLED;
+		static bool COUNT_ALLOCATIONS;  ///< if true, the number and total size of all allocations are counted too
+
+	protected:
+		[[noreturn]] static void throwPageLimitExceeded ();
+
+	private:
+		static std::atomic<int64_t> _usage;     ///< number of bytes currently allocated
+		static std::atomic<int64_t> _pagePeak;  ///< maximum value of _usage since beginning of current page
+		static std::atomic<uint64_t> _numAllocations;  ///< total number of allocations
+		static std::atomic<uint64_t> _allocatedBytes;  ///< total number of bytes allocated
+		static int64_t _pageStart;   ///< value of _usage at the beginning of the current page
+		static int64_t _pageLimit;   ///< maximum number of bytes a page may allocate (0: unlimited)
+};
+
+#endif
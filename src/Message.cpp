@@ -18,16 +18,40 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include "EventStream.hpp"
 #include "Message.hpp"
 #include "Terminal.hpp"
 
 using namespace std;
 
+/** Text written by a worker thread that hasn't been printed yet. */
+struct QueuedText {
+	QueuedText (Message::OrderKey k, string &&t) : key(std::move(k)), text(std::move(t)) {}
+	Message::OrderKey key;
+	string text;
+};
+
+static const thread::id mainThreadID = this_thread::get_id();
+static thread_local Message::OrderKey threadOrderKey;
+static mutex queueMutex;
+static vector<QueuedText> textQueue;  ///< complete lines written by worker threads
+
+
+static void queue_text (string &&text) {
+	lock_guard<mutex> lock(queueMutex);
+	textQueue.emplace_back(threadOrderKey, std::move(text));
+}
+
+
 MessageStream::MessageStream (std::ostream &os) noexcept
 	: _os(&os), _nl(true)
 {
@@ -81,7 +105,10 @@ void MessageStream::putChar (char c, ostream &os) {
 
 
 MessageStream& MessageStream::operator << (const char *str) {
-	if (_os && str) {
+	capture(str);
+	if (_buffered && str)
+		buffer(str);
+	else if (_os && str) {
 		const char *first = str;
 		while (*first) {
 			const char *last = strchr(first, '\n');
@@ -104,12 +131,38 @@ MessageStream& MessageStream::operator << (const char *str) {
 
 
 MessageStream& MessageStream::operator << (const char &c) {
-	if (_os)
+	const char str[] = {c, '\0'};
+	capture(str);
+	if (_buffered)
+		buffer(str);
+	else if (_os)
 		putChar(c, *_os);
 	return *this;
 }
 
 
+MessageStream& MessageStream::operator << (double val) {
+	char buf[32];  // same format as produced by an ostream with default settings
+	snprintf(buf, sizeof(buf), "%g", val);
+	return (*this) << buf;
+}
+
+
+/** Collects the text written to a stream of a worker thread. Complete lines are
+ *  queued in one piece so that they don't get mixed up with the output of other
+ *  threads. */
+void MessageStream::buffer (const char *str) {
+	_bufferedLine += str;
+	size_t pos = _bufferedLine.rfind('\n');
+	if (pos != string::npos) {
+		string rest = _bufferedLine.substr(pos+1);
+		_bufferedLine.resize(pos+1);
+		queue_text(std::move(_bufferedLine));
+		_bufferedLine = std::move(rest);
+	}
+}
+
+
 void MessageStream::indent (bool reset) {
 	if (reset)
 		_indent = 0;
@@ -125,6 +178,32 @@ void MessageStream::outdent (bool all) {
 }
 
 
+/** Passes the next line of text written to this stream to a callback function.
+ *  Leading newlines are skipped. The capturing ends after the first non-empty line.
+ *  @param[in] callback function receiving the text of the line */
+void MessageStream::captureLine (function<void(const string&)> callback) {
+	_captureCallback = std::move(callback);
+	_capturedLine.clear();
+}
+
+
+void MessageStream::capture (const char *str) {
+	if (_captureCallback && str) {
+		for (; *str; ++str) {
+			if (*str != '\n')
+				_capturedLine += *str;
+			else if (!_capturedLine.empty()) {
+				auto callback = std::move(_captureCallback);
+				_captureCallback = nullptr;
+				callback(_capturedLine);
+				_capturedLine.clear();
+				break;
+			}
+		}
+	}
+}
+
+
 void MessageStream::clearline () {
 	if (_os) {
 		int cols = Terminal::columns();
@@ -150,7 +229,7 @@ Message::Color Message::_classColors[9];
 /** Returns the stream for usual messages. */
 MessageStream& Message::mstream (bool prefix, MessageClass mclass) {
 	init();
-	MessageStream *ms = (LEVEL & MESSAGES) ? &messageStream : &nullStream;
+	MessageStream *ms = stream(LEVEL & MESSAGES);
 	if (COLORIZE && ms && ms->os()) {
 		Terminal::fgcolor(_classColors[mclass].foreground, *ms->os());
 		Terminal::bgcolor(_classColors[mclass].background, *ms->os());
@@ -164,13 +243,19 @@ MessageStream& Message::mstream (bool prefix, MessageClass mclass) {
 /** Returns the stream for warning messages. */
 MessageStream& Message::wstream (bool prefix) {
 	init();
-	MessageStream *ms = (LEVEL & WARNINGS) ? &messageStream : &nullStream;
+	MessageStream *ms = stream(LEVEL & WARNINGS);
 	if (COLORIZE && ms && ms->os()) {
 		Terminal::fgcolor(_classColors[MC_WARNING].foreground, *ms->os());
 		Terminal::bgcolor(_classColors[MC_WARNING].background, *ms->os());
 	}
-	if (prefix)
+	if (prefix) {
 		*ms << "\nWARNING: ";
+		if (EventStream::enabled()) {
+			ms->captureLine([](const string &msg) {
+				EventStream::instance().write(EventStream::Event("warning").add("message", msg));
+			});
+		}
+	}
 	return *ms;
 }
 
@@ -178,13 +263,19 @@ MessageStream& Message::wstream (bool prefix) {
 /** Returns the stream for error messages. */
 MessageStream& Message::estream (bool prefix) {
 	init();
-	MessageStream *ms = (LEVEL & ERRORS) ? &messageStream : &nullStream;
+	MessageStream *ms = stream(LEVEL & ERRORS);
 	if (COLORIZE && ms && ms->os()) {
 		Terminal::fgcolor(_classColors[MC_ERROR].foreground, *ms->os());
 		Terminal::bgcolor(_classColors[MC_ERROR].background, *ms->os());
 	}
-	if (prefix)
+	if (prefix) {
 		*ms << "\nERROR: ";
+		if (EventStream::enabled()) {
+			ms->captureLine([](const string &msg) {
+				EventStream::instance().write(EventStream::Event("error").add("message", msg));
+			});
+		}
+	}
 	return *ms;
 }
 
@@ -193,11 +284,67 @@ MessageStream& Message::estream (bool prefix) {
  *  @param[in] always ignore verbosity settings if true */
 MessageStream& Message::ustream (bool always) {
 	init();
-	MessageStream *ms = (always || (LEVEL & USERMESSAGES)) ? &messageStream : &nullStream;
+	MessageStream *ms = stream(always || (LEVEL & USERMESSAGES));
 	return *ms;
 }
 
 
+/** Returns the stream to be used by the calling thread. Messages of the main thread
+ *  are printed immediately while those of worker threads are collected and printed
+ *  by the main thread when calling flush().
+ *  @param[in] enabled false if the message is suppressed */
+MessageStream* Message::stream (bool enabled) {
+	if (this_thread::get_id() == mainThreadID)
+		return enabled ? &messageStream : &nullStream;
+	static thread_local MessageStream threadNullStream;
+	static thread_local MessageStream threadStream;
+	threadStream._buffered = true;
+	return enabled ? &threadStream : &threadNullStream;
+}
+
+
+/** Returns the order key of the n-th task created by the calling thread. */
+Message::OrderKey Message::childOrderKey (unsigned n) {
+	OrderKey key = threadOrderKey;
+	key.push_back(n);
+	return key;
+}
+
+
+/** Assigns an order key to the messages subsequently written by the calling
+ *  thread. An incomplete line written previously is queued with the old key.
+ *  @param[in] key the new order key */
+void Message::setOrderKey (OrderKey key) {
+	if (this_thread::get_id() != mainThreadID) {
+		MessageStream *ms = stream(true);
+		if (!ms->_bufferedLine.empty()) {
+			queue_text(std::move(ms->_bufferedLine));
+			ms->_bufferedLine.clear();
+		}
+	}
+	threadOrderKey = std::move(key);
+}
+
+
+/** Prints the lines written by worker threads ordered by their order keys.
+ *  Lines with identical keys keep the order they were written in.
+ *  Calls from worker threads are ignored. */
+void Message::flush () {
+	if (this_thread::get_id() != mainThreadID)
+		return;
+	vector<QueuedText> queue;
+	{
+		lock_guard<mutex> lock(queueMutex);
+		queue.swap(textQueue);
+	}
+	stable_sort(queue.begin(), queue.end(), [](const QueuedText &t1, const QueuedText &t2) {
+		return t1.key < t2.key;
+	});
+	for (const QueuedText &text : queue)
+		messageStream << text.text;
+}
+
+
 static bool colorchar2int (char colorchar, int *val) {
 	colorchar = tolower(colorchar);
 	if (colorchar >= '0' && colorchar <= '9')
@@ -23,9 +23,11 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <ostream>
 #include <sstream>
+#include <vector>
 #include "Terminal.hpp"
 
 
@@ -51,13 +53,25 @@ class MessageStream {
 		MessageStream& operator << (const char &c);
 		MessageStream& operator << (const std::string &str) {return (*this) << str.c_str();}
 
+		// overloads for common types that don't require a temporary ostringstream
+		MessageStream& operator << (int val)                {return (*this) << std::to_string(val);}
+		MessageStream& operator << (unsigned val)           {return (*this) << std::to_string(val);}
+		MessageStream& operator << (long val)               {return (*this) << std::to_string(val);}
+		MessageStream& operator << (unsigned long val)      {return (*this) << std::to_string(val);}
+		MessageStream& operator << (long long val)          {return (*this) << std::to_string(val);}
+		MessageStream& operator << (unsigned long long val) {return (*this) << std::to_string(val);}
+		MessageStream& operator << (double val);
+
 		void indent (int level)        {_indent = std::max(0, level*2);}
 		void indent (bool reset=false);
 		void outdent (bool all=false);
 		void clearline ();
+		void captureLine (std::function<void(const std::string&)> callback);
 
 	protected:
 		void putChar (char c, std::ostream &os);
+		void capture (const char *str);
+		void buffer (const char *str);
 		std::ostream* os () {return _os;}
 
 	private:
@@ -65,6 +79,10 @@ class MessageStream {
 		bool _nl=false;     ///< true if previous character was a newline
 		int _col=1;         ///< current terminal column
 		int _indent=0;      ///< indentation width (number of columns/characters)
+		std::function<void(const std::string&)> _captureCallback;  ///< receives the captured line
+		std::string _capturedLine;  ///< characters of the line currently captured
+		bool _buffered=false;       ///< true if complete lines are collected and passed to Message::flush()
+		std::string _bufferedLine;  ///< incomplete line of a buffered stream
 };
 
 
@@ -97,12 +115,20 @@ class Message {
 		static MessageStream& wstream (bool prefix=false);
 		static MessageStream& ustream (bool always=false);
 
+		/** Sequence of numbers determining the output order of messages written by worker threads.
+		 *  Messages with lexicographically smaller keys are printed first. */
+		using OrderKey = std::vector<unsigned>;
+		static OrderKey childOrderKey (unsigned n);
+		static void setOrderKey (OrderKey key);
+		static void flush ();
+
 		enum {ERRORS=1, WARNINGS=2, MESSAGES=4, USERMESSAGES=8};
 		static int LEVEL;
 		static bool COLORIZE;
 
 	protected:
 		static void init ();
+		static MessageStream* stream (bool enabled);
 
 
 	private:
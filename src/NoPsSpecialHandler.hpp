@@ -30,6 +30,7 @@ class NoPsSpecialHandler : public SpecialHandler {
 		const char* name () const override {return nullptr;}
 		static const char* handlerName ()  {return nullptr;}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 
 	protected:
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
@@ -32,6 +32,7 @@
 #include "Opacity.hpp"
 #include "PDFHandler.hpp"
 #include "Process.hpp"
+#include "Profiler.hpp"
 #include "SVGElement.hpp"
 #include "SVGTree.hpp"
 #include "Unicode.hpp"
@@ -813,6 +814,7 @@ void PDFHandler::collectObjects () {
 ///////////////////////////////////////////////////////////////////////////////
 
 string PDFHandler::mutool (const string &cmd, bool readFromStderr) {
+	Profiler::Scope scope("mutool");
 	string out;
 	Process("mutool", cmd).run(&out, readFromStderr ? Process::PF_STDERR : Process::PF_STDOUT);
 	return out;
@@ -820,6 +822,7 @@ string PDFHandler::mutool (const string &cmd, bool readFromStderr) {
 
 
 string PDFHandler::mutool (const string &cmd, const SearchPattern &pattern, bool readFromStderr) {
+	Profiler::Scope scope("mutool");
 	string out;
 	Process("mutool", cmd).run(&out, pattern, readFromStderr ? Process::PF_STDERR : Process::PF_STDOUT);
 	return out;
@@ -28,11 +28,16 @@
 #include "InputReader.hpp"
 #include "Message.hpp"
 #include "PSInterpreter.hpp"
+#include "Profiler.hpp"
 #include "SignalHandler.hpp"
 #include "utility.hpp"
 
 using namespace std;
 
+// maximal number of bytes that can be passed to Ghostscript at once
+// => see documentation of gsapi_run_string_foo()
+static const size_t MAX_CHUNK_SIZE = 0xffff;
+
 
 /** Constructs a new PSInterpreter object.
  *  @param[in] actions template methods to be executed after recognizing the corresponding PS operator. */
@@ -106,12 +111,32 @@ void PSInterpreter::checkStatus (int status) {
 }
 
 
-/** Executes a chunk of PostScript code.
+/** Rethrows an exception thrown by one of the action methods during the last call of
+ *  the Ghostscript API. Since exceptions must not be propagated through Ghostscript,
+ *  they are caught in the output callback and kept until Ghostscript has returned. */
+void PSInterpreter::rethrowActionException () {
+	if (_actionException) {
+		exception_ptr ex = _actionException;
+		_actionException = nullptr;
+		rethrow_exception(ex);
+	}
+}
+
+
+/** Executes a chunk of PostScript code. In order to reduce the number of calls of
+ *  the Ghostscript API, small snippets that don't have to be flushed are collected
+ *  and passed to Ghostscript together with subsequent code. Therefore, a PS error
+ *  in a collected snippet is not reported by the call that added it but by the one
+ *  passing the collected code to Ghostscript, i.e. a call with flush=true, a call
+ *  exceeding the buffer size, or a call while a byte limit is active (see limit()).
+ *  Code limited by limit() is never collected, and the previously collected code
+ *  is executed before it, without being counted.
  *  @param[in] str buffer containing the code
  *  @param[in] len number of characters in buffer
  *  @param[in] flush If true, a final 'flush' is sent which forces the output buffer to be written immediately.
  *  @return true if the assigned number of bytes have been read */
 bool PSInterpreter::execute (const char *str, size_t len, bool flush) {
+	Profiler::Scope scope("ghostscript");
 	init();
 	if (_mode == PS_QUIT)
 		return false;
@@ -128,28 +153,56 @@ bool PSInterpreter::execute (const char *str, size_t len, bool flush) {
 		len = _bytesToRead;
 		complete = true;
 	}
+	if (_bytesToRead == 0 && _codebuf.size()+len+7 <= MAX_CHUNK_SIZE) {
+		_codebuf.append(str, len);
+		if (flush) {
+			// force writing contents of output buffer
+			_codebuf.append("\nflush ");
+			runBufferedCode();
+		}
+		return complete;
+	}
+	runBufferedCode();
+	size_t processed = run(str, len);
+	if (_bytesToRead > 0)
+		_bytesToRead -= min(processed, _bytesToRead);
+	if (flush && _mode == PS_RUNNING) {
+		_gs.run_string_continue("\nflush ", 7, 0, &status);
+		rethrowActionException();
+	}
+	return complete;
+}
+
 
-	// feed Ghostscript with code chunks that are not larger than 64KB
-	// => see documentation of gsapi_run_string_foo()
-	const char *p=str;
+/** Passes a chunk of PostScript code to Ghostscript.
+ *  @return number of bytes passed */
+size_t PSInterpreter::run (const char *str, size_t len) {
+	int status=0;
+	size_t processed=0;
 	while (_mode == PS_RUNNING && len > 0) {
 		SignalHandler::instance().check();
-		size_t chunksize = min(len, (size_t)0xffff);
-		_gs.run_string_continue(p, chunksize, 0, &status);
-		p += chunksize;
+		size_t chunksize = min(len, MAX_CHUNK_SIZE);
+		_gs.run_string_continue(str, chunksize, 0, &status);
+		str += chunksize;
 		len -= chunksize;
-		if (_bytesToRead > 0)
-			_bytesToRead -= chunksize;
+		processed += chunksize;
+		rethrowActionException();
 		if (status == -101)  // e_Quit
 			_mode = PS_QUIT;
 		else
 			checkStatus(status);
 	}
-	if (flush) {
-		// force writing contents of output buffer
-		_gs.run_string_continue("\nflush ", 7, 0, &status);
+	return processed;
+}
+
+
+/** Passes the collected PostScript snippets to Ghostscript. */
+void PSInterpreter::runBufferedCode () {
+	if (!_codebuf.empty()) {
+		string code = std::move(_codebuf);
+		_codebuf.clear();
+		run(code.data(), code.size());
 	}
-	return complete;
 }
 
 
@@ -158,17 +211,37 @@ bool PSInterpreter::execute (const char *str, size_t len, bool flush) {
  *  @param[in] flush If true, a final 'flush' is sent which forces the output buffer to be written immediately.
  *  @return true if the assigned number of bytes have been read */
 bool PSInterpreter::execute (istream &is, bool flush) {
-	char buf[4096];
 	bool finished = false;
+	// prevent allocating a large buffer for short input (e.g. taken from a special)
+	streamsize avail = is.rdbuf()->in_avail();
+	vector<char> buf(avail > 0 ? min(size_t(avail), MAX_CHUNK_SIZE) : MAX_CHUNK_SIZE);
 	while (is && !is.eof() && !finished) {
-		is.read(buf, 4096);
-		finished = execute(buf, is.gcount(), false);
+		is.read(buf.data(), buf.size());
+		finished = execute(buf.data(), is.gcount(), false);
 	}
 	execute("\n", 1, flush);
 	return finished;
 }
 
 
+/** Executes the PostScript code of a file.
+ *  @param[in] fname name/path of the file to process
+ *  @param[in] flush If true, a final 'flush' is sent which forces the output buffer to be written immediately.
+ *  @return true if the file could be read */
+bool PSInterpreter::executeFile (const string &fname, bool flush) {
+	ifstream ifs(fname, ios::binary);
+	if (!ifs)
+		return false;
+	// read the entire file at once and pass it to Ghostscript in chunks of maximal size
+	string code(FileSystem::filesize(fname), '\0');
+	ifs.read(&code[0], code.size());
+	code.resize(ifs.gcount());
+	execute(code.data(), code.size(), false);
+	execute("\n", 1, flush);
+	return true;
+}
+
+
 bool PSInterpreter::executeRaw (const string &str, int n) {
 	_rawData.clear();
 	ostringstream oss;
@@ -227,8 +300,15 @@ int GSDLLCALL PSInterpreter::output (void *inst, const char *buf, int len) {
 								self->_errorMessage += char(in.get());
 							self->_inError = true;
 						}
-						else if (in.check("dvi."))
-							self->callActions(in);
+						else if (in.check("dvi.") && !self->_actionException) {
+							// keep exceptions until Ghostscript has returned (see rethrowActionException)
+							try {
+								self->callActions(in);
+							}
+							catch (...) {
+								self->_actionException = current_exception();
+							}
+						}
 					}
 				}
 				linebuf.clear();
@@ -356,10 +436,36 @@ int GSDLLCALL PSInterpreter::error (void *inst, const char *buf, int len) {
 }
 
 
+/** Opens a PDF file and keeps it open until pdfClose() is called or another
+ *  PDF file is opened. As long as the file is open, the page count and the page
+ *  boxes are retrieved and the pages are rendered without reading and parsing the
+ *  document structure (xref table, page tree, etc.) again.
+ *  @param[in] fname name/path of the PDF file */
+void PSInterpreter::pdfOpen (const string &fname) {
+	if (fname != _openPDF) {
+		pdfClose();
+		execute("\n("+FileSystem::ensureForwardSlashes(fname)+")@pdfopen ");
+		_openPDF = fname;
+	}
+}
+
+
+/** Closes the PDF file opened by pdfOpen(). */
+void PSInterpreter::pdfClose () {
+	if (!_openPDF.empty()) {
+		_openPDF.clear();
+		execute("\n@pdfclose ");
+	}
+}
+
+
 /** Returns the total number of pages of a PDF file.
  *  @param[in] fname name/path of the PDF file */
 int PSInterpreter::pdfPageCount (const string &fname) {
-	executeRaw("\n("+FileSystem::ensureForwardSlashes(fname)+")@pdfpagecount ", 1);
+	if (pdfIsOpen(fname))
+		executeRaw("\npdfpagecount ", 1);
+	else
+		executeRaw("\n("+FileSystem::ensureForwardSlashes(fname)+")@pdfpagecount ", 1);
 	if (!_rawData.empty()) {
 		size_t index;
 		int ret = stoi(_rawData[0], &index, 10);
@@ -377,7 +483,10 @@ int PSInterpreter::pdfPageCount (const string &fname) {
  *  @return the bounding box of the given page */
 BoundingBox PSInterpreter::pdfPageBox (const string &fname, int pageno) {
 	BoundingBox pagebox;
-	executeRaw("\n"+to_string(pageno)+"("+FileSystem::ensureForwardSlashes(fname)+")@pdfpagebox ", 4);
+	if (pdfIsOpen(fname))
+		executeRaw("\n"+to_string(pageno)+" @pdfmediabox ", 4);
+	else
+		executeRaw("\n"+to_string(pageno)+"("+FileSystem::ensureForwardSlashes(fname)+")@pdfpagebox ", 4);
 	if (_rawData.size() < 4)
 		pagebox.invalidate();
 	else
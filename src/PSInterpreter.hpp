@@ -22,6 +22,7 @@
 #define PSINTERPRETER_HPP
 
 #include <cstring>
+#include <exception>
 #include <istream>
 #include <string>
 #include <vector>
@@ -105,10 +106,15 @@ class PSInterpreter {
 		bool execute (const char *str, bool flush=true)        {return execute(str, std::strlen(str), flush);}
 		bool execute (const std::string &str, bool flush=true) {return execute(str.c_str(), flush);}
 		bool execute (std::istream &is, bool flush=true);
+		bool executeFile (const std::string &fname, bool flush=true);
 		bool executeRaw (const std::string &str, int n);
+		void flush ()                          {execute("", 0, true);}
 		bool active () const                   {return _mode != PS_QUIT;}
 		void limit (size_t max_bytes)          {_bytesToRead = max_bytes;}
 		PSActions* setActions (PSActions *actions);
+		void pdfOpen (const std::string &fname);
+		void pdfClose ();
+		bool pdfIsOpen (const std::string &fname) const {return !_openPDF.empty() && fname == _openPDF;}
 		int pdfPageCount (const std::string &fname);
 		BoundingBox pdfPageBox (const std::string &fname, int pageno);
 		const std::vector<std::string>& rawData () const {return _rawData;}
@@ -126,8 +132,11 @@ class PSInterpreter {
 		static int GSDLLCALL output (void *inst, const char *buf, int len);
 		static int GSDLLCALL error (void *inst, const char *buf, int len);
 
+		size_t run (const char *str, size_t len);
+		void runBufferedCode ();
 		void checkStatus (int status);
 		void callActions (InputReader &cib);
+		void rethrowActionException ();
 
 	private:
 		Ghostscript _gs;
@@ -135,10 +144,13 @@ class PSInterpreter {
 		PSActions *_actions=nullptr;       ///< actions to be performed
 		size_t _bytesToRead=0;             ///< if > 0, maximal number of bytes to be processed by following calls of execute()
 		std::vector<char> _linebuf;
+		std::string _codebuf;              ///< collects PS snippets not yet passed to Ghostscript
 		std::string _errorMessage;         ///< text of error message
+		std::exception_ptr _actionException; ///< exception thrown by an action while Ghostscript was running
 		bool _inError=false;               ///< true if scanning error message
 		bool _initialized=false;           ///< true if PSInterpreter has been completely initialized
 		std::vector<std::string> _rawData; ///< raw data received
+		std::string _openPDF;              ///< name of the PDF file kept open by pdfOpen()
 		static const char *PSDEFS;         ///< initial PostScript definitions
 };
 
@@ -0,0 +1,81 @@
+/*************************************************************************
+** PageBudget.cpp                                                       **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include "Message.hpp"
+#include "PageBudget.hpp"
+#include "Profiler.hpp"
+#include "SVGTree.hpp"
+#include "XMLNode.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+double PageBudget::_timeout = 0;
+PageBudget::Clock::time_point PageBudget::_deadline;
+unsigned PageBudget::_degradations = 0;
+
+
+/** Starts the time measurement for a new page and resets the degradations. */
+void PageBudget::beginPage () {
+	_degradations = 0;
+	if (_timeout > 0) {
+		auto duration = chrono::duration_cast<Clock::duration>(chrono::duration<double>(_timeout));
+		_deadline = Clock::now() + duration;
+	}
+}
+
+
+/** Records the application of a degradation to the current page.
+ *  @param[in] degradation the degradation applied
+ *  @return true if the degradation hasn't been applied to the current page before */
+bool PageBudget::degrade (Degradation degradation) {
+	bool isnew = !(_degradations & degradation);
+	_degradations |= degradation;
+	return isnew;
+}
+
+
+/** Returns the names of the degradations applied to the current page as
+ *  a comma-separated list. */
+string PageBudget::degradationString () {
+	string str;
+	if (_degradations & COARSE_SHADINGS)
+		str += "shadings";
+	if (_degradations & NO_OPTIMIZER) {
+		if (!str.empty())
+			str += ",";
+		str += "optimizer";
+	}
+	return str;
+}
+
+
+/** Informs about the simplifications applied to the current page because
+ *  its conversion exceeded the time limit. Besides printing a warning, a
+ *  corresponding comment is added to the SVG document of the page.
+ *  @param[in] svg SVG tree of the current page
+ *  @param[in] pageno number of the page */
+void PageBudget::reportDegradations (SVGTree &svg, unsigned pageno) {
+	string degradations = degradationString();
+	Message::wstream(true) << "page " << pageno << " exceeds the time limit of "
+		<< _timeout << "s, output degraded (" << degradations << ")\n";
+	svg.appendToDoc(util::make_unique<XMLComment>(" page degraded due to time limit: " + degradations + " "));
+	Profiler::instance().addCount("degraded pages", 1);
+}
@@ -0,0 +1,59 @@
+/*************************************************************************
+** PageBudget.hpp                                                       **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef PAGEBUDGET_HPP
+#define PAGEBUDGET_HPP
+
+#include <chrono>
+#include <string>
+
+class SVGTree;
+
+/** Limits the time spent on the conversion of a single page. Once the time
+ *  limit of a page is exceeded, expensive processing steps switch to cheaper
+ *  variants that produce less accurate or less compact output (see enum
+ *  Degradation). The applied degradations are recorded so that they can be
+ *  reported after the page has been finished. */
+class PageBudget {
+	using Clock = std::chrono::steady_clock;
+
+	public:
+		enum Degradation {
+			COARSE_SHADINGS = 1,  ///< approximate shading patches by a single color segment
+			NO_OPTIMIZER = 2      ///< don't optimize the SVG document
+		};
+
+	public:
+		static void setTimeout (double seconds) {_timeout = seconds;}
+		static double timeout () {return _timeout;}
+		static void beginPage ();
+		static bool exceeded () {return _timeout > 0 && Clock::now() > _deadline;}
+		static bool degrade (Degradation degradation);
+		static unsigned degradations () {return _degradations;}
+		static std::string degradationString ();
+		static void reportDegradations (SVGTree &svg, unsigned pageno);
+
+	private:
+		static double _timeout;           ///< time limit per page in seconds (0: unlimited)
+		static Clock::time_point _deadline;
+		static unsigned _degradations;    ///< degradations applied to the current page
+};
+
+#endif
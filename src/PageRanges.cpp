@@ -18,7 +18,6 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
-#include "InputBuffer.hpp"
 #include "InputReader.hpp"
 #include "PageRanges.hpp"
 
@@ -36,8 +35,7 @@ static bool is_odd (int n) {return n % 2 == 1;}
  *  @param[in] max_page greatest allowed value
  *  @return true on success; false denotes a syntax error */
 bool PageRanges::parse (const string &str, int max_page) {
-	StringInputBuffer ib(str);
-	BufferInputReader ir(ib);
+	CharInputReader ir(str);
 	while (ir && ir.peek() != ':') {
 		int first=1;
 		int last=max_page;
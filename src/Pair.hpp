@@ -62,7 +62,7 @@ inline Pair<T> abs (const Pair<T> &p) {
 /** Returns the dot product of two 2D vectors. */
 template <typename T>
 inline T dot (const Pair<T> &p1, const Pair<T> &p2) {
-	return p1.x()*p1.y() + p1.y()*p2.y();
+	return p1.x()*p2.x() + p1.y()*p2.y();
 }
 
 /** Returns the determinant of two 2D vectors. */
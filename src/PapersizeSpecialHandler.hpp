@@ -32,11 +32,13 @@ class PapersizeSpecialHandler : public SpecialHandler {
 
 	public:
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* info () const override {return "special to set the page size";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "papersize";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 		void storePaperSize (unsigned pageno, Length width, Length height);
 		void reset () {_pageSizes.clear();}
 
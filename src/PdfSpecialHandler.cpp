@@ -59,7 +59,11 @@ void PdfSpecialHandler::preprocess (const string&, istream &is, SpecialActions &
 
 
 bool PdfSpecialHandler::process (const string&, istream &is, SpecialActions &actions) {
-	_active = true;
+	if (!_active) {
+		_active = true;
+		// track the DVI position in order to detect line breaks inside anchors
+		SpecialManager::instance().subscribe(this, EV_MOVE);
+	}
 	StreamInputReader ir(is);
 	ir.skipSpace();
 	const string cmdstr = ir.getWord();
@@ -278,6 +282,7 @@ void PdfSpecialHandler::dviMovedTo (double x, double y, SpecialActions &actions)
 void PdfSpecialHandler::dviEndPage (unsigned pageno, SpecialActions &actions) {
 	if (_active) {
 		HyperlinkManager::instance().createViews(pageno, actions);
+		SpecialManager::instance().unsubscribe(this, EV_MOVE);
 		_active = false;
 	}
 }
@@ -28,11 +28,13 @@ class StreamInputReader;
 class PdfSpecialHandler : public SpecialHandler {
 	public:
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* info () const override {return "PDF hyperlink, font map, and pagesize specials";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "pdf";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 
 	protected:
 		// handlers for corresponding PDF specials
@@ -18,11 +18,19 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
+#include <deque>
+#include <future>
 #include "DVIActions.hpp"
 #include "PreScanDVIReader.hpp"
+#include "ThreadPool.hpp"
+#include "utility.hpp"
 
 using namespace std;
 
+size_t PreScanDVIReader::MIN_CHUNK_SIZE = 1 << 18;
+size_t PreScanDVIReader::MAX_CHUNK_SIZE = 1 << 24;
+
 
 PreScanDVIReader::PreScanDVIReader (std::istream &is, DVIActions *actions)
 	: BasicDVIReader(is), _actions(actions)
@@ -30,15 +38,107 @@ PreScanDVIReader::PreScanDVIReader (std::istream &is, DVIActions *actions)
 }
 
 
+/** Scans all pages for specials that must be preprocessed and passes them
+ *  to the actions object afterwards. */
+void PreScanDVIReader::executeAllPages () {
+	_specialIndex.clear();
+	if (getDVIVersion() == DVI_NONE)
+		executePostPost();   // get version ID from post_post
+	vector<uint32_t> bopOffsets = collectBopOffsets();
+	auto numPages = unsigned(bopOffsets.size()-1);
+	size_t numBytes = bopOffsets.back()-bopOffsets.front();
+	auto numChunks = unsigned(min(size_t(numPages), numBytes/MIN_CHUNK_SIZE));
+	ThreadPool pool(max(1u, min(numChunks, ThreadPool::defaultNumThreads())));
+	scanChunks(bopOffsets, pool);
+	// evaluate the indexed specials in the order of their occurrence
+	for (const SpecialEntry &entry : _specialIndex) {
+		seek(entry.offset);
+		readString(int(entry.length), _special);
+		_currentPageNumber = entry.pageno;
+		_actions->special(_special, 0, true);  // pre-process special
+	}
+	_currentPageNumber = numPages;
+}
+
+
+/** Runs through a given number of pages starting at the current stream position
+ *  and records the locations of all specials that must be preprocessed.
+ *  @param[in] numPages number of pages to scan */
+void PreScanDVIReader::scanPages (unsigned numPages) {
+	while (numPages > 0) {
+		if (executeCommand() == OP_EOP)
+			numPages--;
+	}
+}
+
+
+/** Splits the page sequence into chunks of consecutive pages and scans them
+ *  concurrently if the pool provides several threads. Each chunk is read into
+ *  memory at once, which is considerably faster than scanning the commands
+ *  directly from the file stream. The number of chunks being processed at the
+ *  same time is limited in order to keep the amount of DVI data held in memory low.
+ *  @param[in] bopOffsets offsets of all bop commands followed by the offset of the postamble
+ *  @param[in] pool threads used to scan the chunks */
+void PreScanDVIReader::scanChunks (const vector<uint32_t> &bopOffsets, ThreadPool &pool) {
+	const auto numPages = unsigned(bopOffsets.size()-1);
+	size_t chunkSize = (bopOffsets.back()-bopOffsets.front())/max(1u, pool.numThreads());
+	chunkSize = max(MIN_CHUNK_SIZE, min(MAX_CHUNK_SIZE, chunkSize));
+	deque<future<SpecialIndex>> results;
+	auto mergeResult = [&]() {
+		SpecialIndex index = results.front().get();
+		_specialIndex.insert(_specialIndex.end(), index.begin(), index.end());
+		results.pop_front();
+	};
+	for (unsigned first=0; first < numPages;) {
+		unsigned last = first+1;  // chunk contains pages first+1,...,last
+		while (last < numPages && bopOffsets[last+1]-bopOffsets[first] <= chunkSize)
+			last++;
+		if (results.size() > 2*pool.numThreads())
+			mergeResult();
+		seek(bopOffsets[first]);
+		string bytes;
+		readString(int(bopOffsets[last]-bopOffsets[first]), bytes);
+		results.push_back(pool.enqueue(&PreScanDVIReader::scanChunk,
+			std::move(bytes), bopOffsets[first], first, last-first, getDVIVersion(), _actions));
+		first = last;
+	}
+	while (!results.empty())
+		mergeResult();
+}
+
+
+/** Scans a sequence of complete pages stored in memory.
+ *  @param[in] bytes the DVI commands of the pages
+ *  @param[in] offset offset of the first byte relative to the begin of the DVI file
+ *  @param[in] pageno number of pages preceding the chunk
+ *  @param[in] numPages number of pages contained in the chunk
+ *  @param[in] version DVI version of the file
+ *  @param[in] actions actions object that decides which specials must be preprocessed
+ *  @return locations of the specials that must be preprocessed */
+PreScanDVIReader::SpecialIndex PreScanDVIReader::scanChunk (const string &bytes, uint32_t offset, unsigned pageno, unsigned numPages, DVIVersion version, DVIActions *actions) {
+	util::CharStreamBuffer buf(bytes.data(), bytes.size());
+	istream is(&buf);
+	PreScanDVIReader reader(is, actions);
+	reader.setDVIVersion(version);
+	reader._streamOffset = offset;
+	reader._currentPageNumber = pageno;
+	reader.scanPages(numPages);
+	return std::move(reader._specialIndex);
+}
+
+
 void PreScanDVIReader::cmdBop (int) {
 	_currentPageNumber++;
 	BasicDVIReader::cmdBop(0);
 }
 
 
+/** Records the location of a special if it must be preprocessed.
+ *  @param[in] len number of bytes of the length parameter */
 void PreScanDVIReader::cmdXXX (int len) {
 	uint32_t numBytes = readUnsigned(len);
-	string s = readString(numBytes);
-	if (_actions)
-		_actions->special(s, 0, true);  // pre-process special
+	auto offset = uint32_t(_streamOffset+tell());
+	readString(int(numBytes), _special);
+	if (_actions && _actions->needsPreprocessing(_special))
+		_specialIndex.emplace_back(_currentPageNumber, offset, numBytes);
 }
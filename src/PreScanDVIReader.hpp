@@ -21,22 +21,53 @@
 #ifndef PRESCANDVIREADER_HPP
 #define PRESCANDVIREADER_HPP
 
+#include <string>
+#include <vector>
 #include "BasicDVIReader.hpp"
 
 struct DVIActions;
+class ThreadPool;
 
+/** Runs through all pages of a DVI file in order to pass the specials to the
+ *  handlers that need to evaluate them before the actual conversion starts.
+ *  In a first step, the pages are scanned for specials requiring preprocessing
+ *  and their locations are recorded in an index. To do so, chunks of consecutive
+ *  pages are read into memory and scanned in parallel if the file is large enough.
+ *  Afterwards, the indexed specials are handed over to the actions object in the
+ *  order of their occurrence. */
 class PreScanDVIReader : public BasicDVIReader {
+	public:
+		/** Location of a special that must be evaluated during preprocessing. */
+		struct SpecialEntry {
+			SpecialEntry (unsigned pn, uint32_t ofs, uint32_t len) : pageno(pn), offset(ofs), length(len) {}
+			unsigned pageno;  ///< number of the page containing the special
+			uint32_t offset;  ///< offset of the special text relative to the begin of the DVI file
+			uint32_t length;  ///< length of the special text in bytes
+		};
+		using SpecialIndex = std::vector<SpecialEntry>;
+
 	public:
 		PreScanDVIReader (std::istream &is, DVIActions *actions);
+		void executeAllPages () override;
 		unsigned currentPageNumber () const override {return _currentPageNumber;}
+		const SpecialIndex& specialIndex () const {return _specialIndex;}
+
+		static size_t MIN_CHUNK_SIZE;  ///< minimal number of bytes scanned by a single thread
+		static size_t MAX_CHUNK_SIZE;  ///< maximal number of bytes scanned by a single thread
 
 	protected:
+		void scanPages (unsigned numPages);
+		void scanChunks (const std::vector<uint32_t> &bopOffsets, ThreadPool &pool);
+		static SpecialIndex scanChunk (const std::string &bytes, uint32_t offset, unsigned pageno, unsigned numPages, DVIVersion version, DVIActions *actions);
 		void cmdBop (int) override;
 		void cmdXXX (int len) override;
 
 	private:
 		DVIActions *_actions;
 		unsigned _currentPageNumber=0;
+		uint32_t _streamOffset=0;   ///< offset of the first byte of the input stream relative to the begin of the DVI file
+		SpecialIndex _specialIndex; ///< locations of the specials that must be preprocessed
+		std::string _special;       ///< text of the most recently read special
 };
 
 #endif
@@ -0,0 +1,253 @@
+/*************************************************************************
+** Profiler.cpp                                                         **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <algorithm>
+#include <iomanip>
+#include "MemoryMonitor.hpp"
+#include "Profiler.hpp"
+
+using namespace std;
+
+bool Profiler::ENABLED = false;
+
+/** Innermost scope active in the current thread. */
+static thread_local Profiler::Scope *current_scope = nullptr;
+
+
+Profiler& Profiler::instance () {
+	static Profiler profiler;
+	return profiler;
+}
+
+
+/** Starts the time measurement of a new phase.
+ *  @param[in] phase name of the phase
+ *  @param[in] subphase optional name that further specifies the phase, e.g. the name of a special handler */
+Profiler::Scope::Scope (const char *phase, const char *subphase) : _phase(phase), _subphase(subphase) {
+	if (ENABLED) {
+		_parent = current_scope;
+		current_scope = this;
+		_start = Clock::now();
+	}
+}
+
+
+Profiler::Scope::~Scope () {
+	if (ENABLED && current_scope == this) {
+		double time = chrono::duration<double>(Clock::now()-_start).count();
+		current_scope = _parent;
+		if (_parent)
+			_parent->_childTime += time;
+		string name = _phase;
+		if (_subphase)
+			name.append(":").append(_subphase);
+		instance().addTime(name, time-_childTime, _allocated);
+	}
+}
+
+
+/** Adds the values of another Stats object to this one. */
+void Profiler::Stats::add (const Stats &stats) {
+	time += stats.time;
+	for (const auto &phase : stats.phases) {
+		Entry &entry = phases[phase.first];
+		entry.time += phase.second.time;
+		entry.calls += phase.second.calls;
+		entry.allocated += phase.second.allocated;
+	}
+	for (const auto &counter : stats.counters)
+		counters[counter.first] += counter.second;
+	heapPeak = max(heapPeak, stats.heapPeak);
+	rssPeak = max(rssPeak, stats.rssPeak);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+/** Starts collecting the statistics of a new page.
+ *  @param[in] pageno number of the page */
+void Profiler::beginPage (unsigned pageno) {
+	if (ENABLED) {
+		lock_guard<mutex> lock(_mutex);
+		_pages.emplace_back(pageno);
+		_pageActive = true;
+		_pageStartTime = Clock::now();
+	}
+}
+
+
+/** Finishes collecting the statistics of the current page. */
+void Profiler::endPage () {
+	if (ENABLED) {
+		lock_guard<mutex> lock(_mutex);
+		if (_pageActive) {
+			Stats &stats = _pages.back();
+			stats.time = chrono::duration<double>(Clock::now()-_pageStartTime).count();
+			if (MemoryMonitor::ENABLED)
+				stats.heapPeak = MemoryMonitor::pagePeak();
+			stats.rssPeak = MemoryMonitor::peakResidentSetSize();
+			_pageActive = false;
+		}
+	}
+}
+
+
+/** Adds a time measurement to a phase of the current page.
+ *  @param[in] phase name of the phase
+ *  @param[in] time time in seconds
+ *  @param[in] allocated number of bytes allocated on the heap */
+void Profiler::addTime (const string &phase, double time, uint64_t allocated) {
+	lock_guard<mutex> lock(_mutex);
+	Entry &entry = currentStats().phases[phase];
+	entry.time += time;
+	entry.calls++;
+	entry.allocated += allocated;
+}
+
+
+/** Attributes an allocated memory block to the innermost scope of the current thread.
+ *  The function is called by MemoryMonitor if the heap memory accounting is enabled.
+ *  @param[in] size size of the block in bytes */
+void Profiler::addAllocation (size_t size) {
+	if (current_scope)
+		current_scope->_allocated += size;
+}
+
+
+/** Increases a counter of the current page, e.g. the number of bytes written.
+ *  @param[in] name name of the counter
+ *  @param[in] count value to add */
+void Profiler::addCount (const string &name, uint64_t count) {
+	if (ENABLED) {
+		lock_guard<mutex> lock(_mutex);
+		currentStats().counters[name] += count;
+	}
+}
+
+
+/** Returns the accumulated statistics of all pages and the phases executed outside of pages. */
+Profiler::Stats Profiler::totalStats () const {
+	Stats total;
+	for (const Stats &stats : _pages)
+		total.add(stats);
+	total.add(_nonPageStats);
+	total.time = chrono::duration<double>(Clock::now()-_startTime).count();
+	if (ENABLED)
+		total.rssPeak = MemoryMonitor::peakResidentSetSize();
+	return total;
+}
+
+
+/** Removes all collected data. */
+void Profiler::reset () {
+	lock_guard<mutex> lock(_mutex);
+	_pages.clear();
+	_nonPageStats = Stats();
+	_pageActive = false;
+	_startTime = Clock::now();
+}
+
+
+static void write_text (ostream &os, const string &title, const Profiler::Stats &stats) {
+	os << title << ": " << stats.time << "s\n";
+	for (const auto &phase : stats.phases) {
+		os << "  " << left << setw(30) << phase.first << right
+			<< setw(12) << phase.second.time << "s"
+			<< setw(10) << phase.second.calls << " call" << (phase.second.calls == 1 ? "" : "s");
+		if (MemoryMonitor::ENABLED)
+			os << (phase.second.calls == 1 ? " " : "") << setw(14) << phase.second.allocated << " bytes allocated";
+		os << '\n';
+	}
+	for (const auto &counter : stats.counters)
+		os << "  " << left << setw(30) << counter.first << right << setw(13) << counter.second << '\n';
+	if (MemoryMonitor::ENABLED) {
+		os << "  " << left << setw(30) << "heap peak" << right << setw(13) << stats.heapPeak << '\n';
+		// list the three phases that allocated the most memory
+		vector<pair<string,uint64_t>> allocs;
+		for (const auto &phase : stats.phases)
+			allocs.emplace_back(phase.first, phase.second.allocated);
+		size_t count = min(allocs.size(), size_t(3));
+		partial_sort(allocs.begin(), allocs.begin()+count, allocs.end(), [](const pair<string,uint64_t> &a, const pair<string,uint64_t> &b) {
+			return a.second > b.second;
+		});
+		os << "  " << left << setw(30) << "top allocations" << right;
+		for (size_t i=0; i < count && allocs[i].second > 0; i++)
+			os << (i > 0 ? ", " : "") << allocs[i].first << " (" << allocs[i].second << ')';
+		os << '\n';
+	}
+	if (stats.rssPeak > 0)
+		os << "  " << left << setw(30) << "max resident set size" << right << setw(13) << stats.rssPeak << '\n';
+}
+
+
+static void write_json (ostream &os, const Profiler::Stats &stats) {
+	os << "{";
+	if (stats.pageno > 0)
+		os << "\"page\":" << stats.pageno << ',';
+	os << "\"time\":" << stats.time << ",\"phases\":{";
+	for (auto it=stats.phases.begin(); it != stats.phases.end(); ++it) {
+		if (it != stats.phases.begin())
+			os << ',';
+		os << '"' << it->first << "\":{\"time\":" << it->second.time << ",\"calls\":" << it->second.calls;
+		if (MemoryMonitor::ENABLED)
+			os << ",\"allocated\":" << it->second.allocated;
+		os << '}';
+	}
+	os << "},\"counters\":{";
+	for (auto it=stats.counters.begin(); it != stats.counters.end(); ++it) {
+		if (it != stats.counters.begin())
+			os << ',';
+		os << '"' << it->first << "\":" << it->second;
+	}
+	os << '}';
+	if (MemoryMonitor::ENABLED)
+		os << ",\"heap_peak\":" << stats.heapPeak;
+	if (stats.rssPeak > 0)
+		os << ",\"max_rss\":" << stats.rssPeak;
+	os << '}';
+}
+
+
+/** Writes the collected statistics of all pages and the totals to a stream.
+ *  @param[in] os stream to write to
+ *  @param[in] json if true, the data is written in JSON format, otherwise as plain text */
+void Profiler::writeReport (ostream &os, bool json) const {
+	lock_guard<mutex> lock(_mutex);
+	auto flags = os.flags();
+	auto precision = os.precision(6);
+	os << fixed;
+	if (json) {
+		os << "{\"pages\":[";
+		for (auto it=_pages.begin(); it != _pages.end(); ++it) {
+			if (it != _pages.begin())
+				os << ",\n";
+			write_json(os, *it);
+		}
+		os << "],\n\"total\":";
+		write_json(os, totalStats());
+		os << "}\n";
+	}
+	else {
+		for (const Stats &stats : _pages)
+			write_text(os, "page "+to_string(stats.pageno), stats);
+		write_text(os, "total", totalStats());
+	}
+	os.flags(flags);
+	os.precision(precision);
+}
@@ -0,0 +1,103 @@
+/*************************************************************************
+** Profiler.hpp                                                         **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Collects the time spent in the main processing phases (DVI parsing, special
+ *  processing, Ghostscript, glyph extraction, etc.) as well as some counters,
+ *  separately for each converted page. The phases are measured by placing
+ *  Profiler::Scope objects in the corresponding functions. Nested scopes are
+ *  subtracted from their enclosing scope so that each phase only gets the time
+ *  spent in its own code. Phases executed concurrently in worker threads are
+ *  summed up over all threads. As long as the profiler is disabled, the scope
+ *  objects don't do anything apart from checking the ENABLED flag. */
+class Profiler {
+	using Clock = std::chrono::steady_clock;
+
+	public:
+		class Scope {
+			public:
+				explicit Scope (const char *phase, const char *subphase=nullptr);
+				Scope (const Scope &scope) =delete;
+				~Scope ();
+
+			private:
+				const char *_phase;
+				const char *_subphase;
+				Clock::time_point _start;
+				double _childTime=0;   ///< time spent in nested scopes (in seconds)
+				uint64_t _allocated=0; ///< number of bytes allocated while this scope was the innermost one
+				Scope *_parent=nullptr;
+				friend class Profiler;
+		};
+
+		struct Entry {
+			double time=0;       ///< accumulated time in seconds
+			uint64_t calls=0;    ///< number of measurements
+			uint64_t allocated=0; ///< number of bytes allocated on the heap
+		};
+
+		struct Stats {
+			Stats () =default;
+			explicit Stats (unsigned pno) : pageno(pno) {}
+			void add (const Stats &stats);
+			unsigned pageno=0;   ///< number of the page (0 if not page-specific)
+			double time=0;       ///< wall-clock time in seconds
+			uint64_t heapPeak=0; ///< maximum amount of heap memory allocated (in bytes)
+			uint64_t rssPeak=0;  ///< maximum resident set size of the process (in bytes)
+			std::map<std::string,Entry> phases;
+			std::map<std::string,uint64_t> counters;
+		};
+
+	public:
+		static Profiler& instance ();
+		void beginPage (unsigned pageno);
+		void endPage ();
+		void addTime (const std::string &phase, double time, uint64_t allocated=0);
+		void addCount (const std::string &name, uint64_t count);
+		void writeReport (std::ostream &os, bool json) const;
+		void reset ();
+		static void addAllocation (size_t size);
+		static bool ENABLED;
+
+	protected:
+		Profiler () : _startTime(Clock::now()) {}
+		Stats& currentStats ()  {return _pageActive ? _pages.back() : _nonPageStats;}
+		Stats totalStats () const;
+
+	private:
+		mutable std::mutex _mutex;
+		Clock::time_point _startTime;
+		Clock::time_point _pageStartTime;
+		bool _pageActive=false;
+		std::vector<Stats> _pages;  ///< statistics of the converted pages
+		Stats _nonPageStats;        ///< statistics of phases executed outside of pages
+};
+
+#endif
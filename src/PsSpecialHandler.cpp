@@ -18,23 +18,30 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <sstream>
+#include <valarray>
 #include "FileFinder.hpp"
 #include "FilePath.hpp"
 #include "FileSystem.hpp"
+#include "MemoryMonitor.hpp"
 #include "Message.hpp"
+#include "PageBudget.hpp"
 #include "PathClipper.hpp"
 #include "PSPattern.hpp"
 #include "PSPreviewHandler.hpp"
 #include "PsSpecialHandler.hpp"
+#include "ShadingArea.hpp"
 #include "SpecialActions.hpp"
 #include "SVGElement.hpp"
 #include "TensorProductPatch.hpp"
 #include "TriangularPatch.hpp"
 #include "utility.hpp"
+#include "XXHashFunction.hpp"
 
 using namespace std;
 
@@ -46,6 +53,18 @@ double PsSpecialHandler::SHADING_SIMPLIFY_DELTA = 0.01;
 string PsSpecialHandler::BITMAP_FORMAT;
 
 
+/** Returns the size of the color segments used to approximate shading patches.
+ *  If the time limit of the current page has been exceeded, each patch is
+ *  approximated by a single segment in order to finish the page quickly. */
+static int shading_segment_size () {
+	if (PageBudget::exceeded()) {
+		PageBudget::degrade(PageBudget::COARSE_SHADINGS);
+		return 1;
+	}
+	return PsSpecialHandler::SHADING_SEGMENT_SIZE;
+}
+
+
 PsSpecialHandler::PsSpecialHandler () : _psi(this), _previewHandler(_psi)
 {
 	_psi.setImageDevice(BITMAP_FORMAT);
@@ -96,9 +115,8 @@ void PsSpecialHandler::initgraphics () {
 
 void PsSpecialHandler::processHeaderFile (const char *name) {
 	if (const char *path = FileFinder::instance().lookup(name, false)) {
-		ifstream ifs(path);
 		_psi.execute(string("%%BeginProcSet: ")+name+" 0 0\n", false);
-		_psi.execute(ifs, false);
+		_psi.executeFile(path, false);
 		_psi.execute("%%EndProcSet\n", false);
 	}
 	else
@@ -130,23 +148,27 @@ void PsSpecialHandler::enterBodySection () {
 
 
 /** Move PS graphic position to current DVI location. */
-void PsSpecialHandler::moveToDVIPos () {
+void PsSpecialHandler::moveToDVIPos (bool flush) {
 	if (_actions) {
 		const double x = _actions->getX();
 		const double y = _actions->getY();
 		ostringstream oss;
 		oss << '\n' << x << ' ' << y << " moveto ";
-		_psi.execute(oss.str());
+		_psi.execute(oss.str(), flush);
 		_currentpoint = DPair(x, y);
 	}
 }
 
 
 /** Executes a PS snippet and optionally synchronizes the DVI cursor position
- *  with the current PS point.
+ *  with the current PS point. If the position is to be updated, the output of
+ *  the PS code isn't flushed immediately. Instead, the code of consecutive
+ *  PS specials is collected and passed to Ghostscript at once when the DVI
+ *  processing requires it (see synchronize()).
  *  @param[in] is  stream to read the PS code from
  *  @param[in] updatePos if true, move the DVI drawing position to the current PS point */
 void PsSpecialHandler::executeAndSync (istream &is, bool updatePos) {
+	bool colorChanged = false;
 	if (_actions && _actions->getFillColor() != _currentcolor) {
 		// update the PS graphics state if the color has been changed by a color special
 		double r, g, b;
@@ -154,19 +176,41 @@ void PsSpecialHandler::executeAndSync (istream &is, bool updatePos) {
 		ostringstream oss;
 		oss << '\n' << r << ' ' << g << ' ' << b << " setrgbcolor ";
 		_psi.execute(oss.str(), false);
+		colorChanged = true;
 	}
-	_psi.execute(is);
-	if (updatePos) {
-		// retrieve current PS position (stored in _currentpoint)
-		_psi.execute("\nquerypos ");
+	if (!updatePos)
+		_psi.execute(is);
+	else {
+		_psi.execute(is, false);
+		_outputPending = true;
+		// The fill color is updated by the output of the PS code. Thus, it must be
+		// processed before the next special compares it with the current DVI color.
+		if (colorChanged && _actions)
+			synchronize(*_actions);
 		if (_actions) {
-			_actions->setX(_currentpoint.x());
-			_actions->setY(_currentpoint.y());
+			// Since the ps specials call finishLine(), the DVI position change only affects
+			// the current DVI command. Therefore, we don't need to query the current PS point
+			// here. Reassigning the current position isn't a no-op, though: it clears the
+			// translation of the DVI position (see DVIToSVG::translateToX/Y) and forces the
+			// SVG tree to set the position of the following character explicitly.
+			_actions->setX(_actions->getX());
+			_actions->setY(_actions->getY());
 		}
 	}
 }
 
 
+/** Flushes the output of the PS specials processed since the last call of this function.
+ *  The function is called before a DVI command or another special is executed that might
+ *  depend on the graphics state changed by the PS code. */
+void PsSpecialHandler::synchronize (SpecialActions &actions) {
+	if (_outputPending) {
+		_outputPending = false;
+		_psi.flush();
+	}
+}
+
+
 void PsSpecialHandler::preprocess (const string &prefix, istream &is, SpecialActions &actions) {
 	initialize();
 	if (_psSection != PS_HEADERS)
@@ -204,11 +248,13 @@ bool PsSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 	initialize();
 	if (_psSection != PS_BODY)
 		enterBodySection();
+	if (prefix != "ps:" && prefix != "ps::" && prefix != "PST:")
+		synchronize(actions);
 
 	if (prefix == "\"" || prefix == "pst:") {
 		// read and execute literal PostScript code (isolated by a wrapping save/restore pair)
-		moveToDVIPos();
-		_psi.execute("\n@beginspecial @setspecial ");
+		moveToDVIPos(false);
+		_psi.execute("\n@beginspecial @setspecial ", false);
 		executeAndSync(is, false);
 		_psi.execute("\n@endspecial ");
 	}
@@ -247,7 +293,7 @@ bool PsSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 				code += char(is.get());
 
 			if (code == "[begin]" || code == "[nobreak]") {
-				moveToDVIPos();
+				moveToDVIPos(false);
 				executeAndSync(is, true);
 			}
 			else {
@@ -265,27 +311,40 @@ bool PsSpecialHandler::process (const string &prefix, istream &is, SpecialAction
 	else { // ps: ... or PST: ...
 		if (_actions)
 			_actions->finishLine();
-		moveToDVIPos();
+		moveToDVIPos(false);
 		StreamInputReader in(is);
 		if (in.check(" plotfile ")) { // ps: plotfile fname
 			string fname = in.getString();
-			ifstream ifs(fname);
-			if (ifs)
-				_psi.execute(ifs);
-			else
+			if (!_psi.executeFile(fname))
 				Message::wstream(true) << "file '" << fname << "' not found in ps: plotfile\n";
 		}
 		else {
 			// ps:<code> is almost identical to ps::[begin]<code> but does
-			// a final repositioning to the current DVI location
+			// a final repositioning to the current DVI location which is
+			// the current PS point or, if there's none, the initial position
 			executeAndSync(is, true);
-			moveToDVIPos();
+			ostringstream oss;
+			oss << "\n{currentpoint}stopped{$error/newerror false put "
+				<< _currentpoint.x() << ' ' << _currentpoint.y() << "}if moveto ";
+			_psi.execute(oss.str(), false);
 		}
 	}
 	return true;
 }
 
 
+/** Returns the path of an image file or an empty string if the file can't be found.
+ *  @param[in] fname file name/path of image file */
+static string find_image_file (const string &fname) {
+	string pathstr;
+	if (const char *path = FileFinder::instance().lookup(fname, false))
+		pathstr = FileSystem::ensureForwardSlashes(path);
+	if ((pathstr.empty() || !FileSystem::exists(pathstr)) && FileSystem::exists(fname))
+		pathstr = fname;
+	return pathstr;
+}
+
+
 /** Handles a psfile/pdffile special which places an external EPS/PDF graphic
  *  at the current DVI position. The lower left corner (llx,lly) of the
  *  given bounding box is placed at the DVI position.
@@ -311,7 +370,12 @@ void PsSpecialHandler::imgfile (FileType filetype, const string &fname, const ma
 	if (filetype == FileType::BITMAP || filetype == FileType::SVG)
 		swap(lly, ury);
 	else if (filetype == FileType::PDF && llx == 0 && lly == 0 && urx == 0 && ury == 0) {
-		BoundingBox pagebox = _psi.pdfPageBox(fname, pageno);
+		string path = find_image_file(fname);
+		if (path.empty())
+			path = fname;
+		else if (_keepPDFOpen && processPDFWithGS())
+			_psi.pdfOpen(path);
+		BoundingBox pagebox = _psi.pdfPageBox(path, pageno);
 		pagebox.transform(TranslationMatrix(-pagebox.minX(), -pagebox.minY()));
 		if (pagebox.valid()) {
 			llx = lly = 0.0;
@@ -395,11 +459,7 @@ static string image_base_path (const SpecialActions &actions) {
  *  @return pointer to the element or nullptr if there's no image data */
 PsSpecialHandler::ImageNode PsSpecialHandler::createImageNode (FileType type, const string &fname, int pageno, BoundingBox bbox, bool clip) {
 	ImageNode imgnode;
-	string pathstr;
-	if (const char *path = FileFinder::instance().lookup(fname, false))
-		pathstr = FileSystem::ensureForwardSlashes(path);
-	if ((pathstr.empty() || !FileSystem::exists(pathstr)) && FileSystem::exists(fname))
-		pathstr = fname;
+	string pathstr = find_image_file(fname);
 	if (pathstr.empty())
 		Message::wstream(true) << "file '" << fname << "' not found\n";
 	else if (type == FileType::BITMAP || type == FileType::SVG)
@@ -442,10 +502,12 @@ PsSpecialHandler::ImageNode PsSpecialHandler::createPSNode (const string &fname,
 		"/setpagedevice{@setpagedevice}def "     // activate processing of operator "setpagedevice"
 		"/@imgbase("+image_base_path(*_actions)+")store " // path and basename of image files
 		"matrix setmatrix"                       // don't apply outer PS transformations
-		"/FirstPage "+to_string(pageno)+" def"   // set number of first page to convert (PDF only)
-		"/LastPage "+to_string(pageno)+" def"    // set number of last page to convert (PDF only)
-		"(" + path + ")run "                  // execute file content
-		"@endspecial\n"                          // leave special environment
+		+ (_psi.pdfIsOpen(path)
+			? " "+to_string(pageno)+" @pdfpage "   // render page of the PDF file kept open
+			: "/FirstPage "+to_string(pageno)+" def" // set number of first page to convert (PDF only)
+			  "/LastPage "+to_string(pageno)+" def"  // set number of last page to convert (PDF only)
+			  "("+path+")run ")                      // execute file content
+		+ "@endspecial\n"                        // leave special environment
 	);
 	if (imgnode.element->empty())
 		imgnode.element.reset(nullptr);
@@ -463,8 +525,11 @@ PsSpecialHandler::ImageNode PsSpecialHandler::createPSNode (const string &fname,
 
 
 PsSpecialHandler::ImageNode PsSpecialHandler::createPDFNode (const string &fname, const string &path, int pageno, BoundingBox bbox, bool clip) {
-	if (_pdfProc == "gs" || (_pdfProc.empty() && _psi.supportsPDF()))
+	if (processPDFWithGS()) {
+		if (_keepPDFOpen)
+			_psi.pdfOpen(path);
 		return createPSNode(fname, path, pageno, bbox, clip);
+	}
 
 	ImageNode imgnode;
 	if (PDFHandler::available()) {
@@ -500,6 +565,25 @@ PsSpecialHandler::ImageNode PsSpecialHandler::createPDFNode (const string &fname
 }
 
 
+/** Returns true if PDF files are processed by Ghostscript rather than by mutool. */
+bool PsSpecialHandler::processPDFWithGS () const {
+	return _pdfProc == "gs" || (_pdfProc.empty() && _psi.supportsPDF());
+}
+
+
+/** Enables or disables keeping PDF files open in Ghostscript. If enabled, a PDF
+ *  file included by Ghostscript isn't closed after processing a page so that
+ *  following pages of the same file can be rendered without reading and parsing
+ *  the document structure again. This is useful if several pages of a PDF file
+ *  are converted consecutively. Disabling the mode closes the open file.
+ *  @param[in] keep true if PDF files should be kept open */
+void PsSpecialHandler::keepPDFOpen (bool keep) {
+	_keepPDFOpen = keep;
+	if (!keep)
+		_psi.pdfClose();
+}
+
+
 /** Apply transformation to width, height, and depth set by preview package.
  *  @param[in] matrix transformation matrix to apply
  *  @param[out] w width
@@ -533,10 +617,13 @@ static bool transform_box_extents (const Matrix &matrix, double &w, double &h, d
 void PsSpecialHandler::dviBeginPage (unsigned int pageno, SpecialActions &actions) {
 	_psi.execute("/@imgbase("+image_base_path(actions)+")store\n"); // path and basename of image files
 	_imgClipCount = 0;
+	_gradientCount = 0;
+	_bitmapIDs.clear();
 }
 
 
 void PsSpecialHandler::dviEndPage (unsigned, SpecialActions &actions) {
+	synchronize(actions);
 	_previewHandler.readDataFromStack();
 	BoundingBox bbox;
 	if (_previewHandler.getBoundingBox(bbox)) {  // is there any data written by preview package?
@@ -651,11 +738,13 @@ void PsSpecialHandler::moveto (vector<double> &p) {
 
 void PsSpecialHandler::lineto (vector<double> &p) {
 	_path.lineto(p[0], p[1]);
+	MemoryMonitor::checkPageLimit();
 }
 
 
 void PsSpecialHandler::curveto (vector<double> &p) {
 	_path.cubicto(p[0], p[1], p[2], p[3], p[4], p[5]);
+	MemoryMonitor::checkPageLimit();
 }
 
 
@@ -701,6 +790,7 @@ void PsSpecialHandler::setstrokeconstantalpha (vector<double> &p) {
 /** Draws the current path recorded by previously executed path commands (moveto, lineto,...).
  *  @param[in] p not used */
 void PsSpecialHandler::stroke (vector<double> &p) {
+	MemoryMonitor::checkPageLimit();
 	_path.removeRedundantCommands();
 	if ((_path.empty() && !_clipStack.prependedPath()) || !_actions)
 		return;
@@ -766,6 +856,7 @@ void PsSpecialHandler::stroke (vector<double> &p) {
  *  @param[in] p not used
  *  @param[in] evenodd true: use even-odd fill algorithm, false: use nonzero fill algorithm */
 void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
+	MemoryMonitor::checkPageLimit();
 	_path.removeRedundantCommands();
 	if ((_path.empty() && !_clipStack.prependedPath()) || (_patternEnabled && !_pattern) || !_actions)
 		return;
@@ -806,9 +897,44 @@ void PsSpecialHandler::fill (vector<double> &p, bool evenodd) {
 }
 
 
+/** Returns the ID of the defs element holding the data of a bitmap file written by the
+ *  PS interpreter. Bitmaps with identical contents are embedded only once per SVG document.
+ *  If the defs section doesn't contain the bitmap yet, a corresponding image element is added.
+ *  Otherwise, the given file is redundant and gets removed.
+ *  @param[in] fname name of the bitmap file
+ *  @param[in] width width of the bitmap in pixels
+ *  @param[in] height height of the bitmap in pixels
+ *  @param[in,out] svg SVG tree the image element is added to
+ *  @return ID of the image element in the defs section */
+string PsSpecialHandler::bitmapID (const string &fname, double width, double height, SVGTree &svg) {
+	XXH64HashFunction hashFunc;
+	ifstream ifs(fname, ios::binary);
+	hashFunc.update(ifs);
+	string id = "bmp"+hashFunc.digestString();
+	if (!_bitmapIDs.insert(id).second) {  // bitmap already present in defs section?
+		ifs.close();
+		if (!XMLNode::KEEP_ENCODED_FILES)
+			FileSystem::remove(fname);
+	}
+	else {
+		auto image = util::make_unique<SVGElement>("image");
+		image->addAttribute("id", id);
+		image->addAttribute("width", util::to_string(width));
+		image->addAttribute("height", util::to_string(height));
+		// To prevent memory issues, only add the filename to the href attribute and tag it by '@'
+		// for later base64 encoding.
+		image->addAttribute("@xlink:href", "data:"+util::mimetype(fname)+";base64,"+fname);
+		svg.appendToDefs(std::move(image));
+	}
+	return id;
+}
+
+
 /** Postprocesses the 'image' operation performed by the PS interpreter. If
  *  the PS image operator succeeded, there's now a PNG file that must be embedded
- *  into the SVG file. */
+ *  into the SVG file. Since documents often contain the same bitmap several times
+ *  (e.g. logos on every page), the bitmap data is added to the defs section once
+ *  and referenced by 'use' elements. */
 void PsSpecialHandler::image (std::vector<double> &p) {
 	int imgID = static_cast<int>(p[0]);   // ID of PNG file written
 	if (imgID < 0)  // no bitmap file written?
@@ -821,13 +947,12 @@ void PsSpecialHandler::image (std::vector<double> &p) {
 	ifstream ifs(fname, ios::binary);
 	if (ifs) {
 		ifs.close();
-		auto image = util::make_unique<XMLElement>("image");
+		auto image = util::make_unique<SVGElement>("use");
 		double x = _actions->getX();
 		double y = _actions->getY();
 		image->addAttribute("x", x);
 		image->addAttribute("y", y);
-		image->addAttribute("width", util::to_string(width));
-		image->addAttribute("height", util::to_string(height));
+		image->addAttribute("xlink:href", "#"+bitmapID(fname, width, height, _actions->svgTree()));
 
 		// The current transformation matrix (CTM) maps the unit square to the rectangular region
 		// of the target canvas showing the bitmap (see PS Reference Manual, 4.10.3). Therefore,
@@ -836,10 +961,6 @@ void PsSpecialHandler::image (std::vector<double> &p) {
 		Matrix matrix{width, 0, 0, 0, -height, height};  // maps unit square to bitmap rectangle
 		matrix = matrix.invert().lmultiply(_actions->getMatrix());
 		image->addAttribute("transform", matrix.toSVG());
-
-		// To prevent memory issues, only add the filename to the href attribute and tag it by '@'
-		// for later base64 encoding.
-		image->addAttribute("@xlink:href", "data:"+util::mimetype(fname)+";base64,"+fname);
 		// if set, assign clipping path to image
 		if (_clipStack.path()) {
 			auto group = util::make_unique<SVGElement>("g");
@@ -1029,12 +1150,13 @@ void PsSpecialHandler::clip (Path path, bool evenodd) {
 
 /** Applies a gradient fill to the current graphics path. Vector p contains the shading parameters
  *  in the following order:
- *  - shading type (6=Coons, 7=tensor product)
+ *  - shading type (2=axial, 3=radial, 4=free-form triangular, 5=lattice-form triangular, 6=Coons, 7=tensor product)
  *  - color space (1=gray, 3=rgb, 4=cmyk)
  *  - 1.0 followed by the background color components based on the declared color space, or 0.0
  *  - 1.0 followed by the bounding box coordinates, or 0.0
  *  - geometry and color parameters depending on the shading type */
 void PsSpecialHandler::shfill (vector<double> &params) {
+	MemoryMonitor::checkPageLimit();
 	if (params.size() < 9)
 		return;
 
@@ -1071,10 +1193,12 @@ void PsSpecialHandler::shfill (vector<double> &params) {
 		clip(std::move(bboxPath), false);
 	}
 	try {
-		if (shadingTypeID == 5)
-			processLatticeTriangularPatchMesh(colorSpace, it);
-		else
-			processSequentialPatchMesh(shadingTypeID, colorSpace, it);
+		switch (shadingTypeID) {
+			case 2: processAxialShading(colorSpace, it); break;
+			case 3: processRadialShading(colorSpace, it); break;
+			case 5: processLatticeTriangularPatchMesh(colorSpace, it); break;
+			default: processSequentialPatchMesh(shadingTypeID, colorSpace, it);
+		}
 	}
 	catch (ShadingException &e) {
 		Message::estream(false) << "PostScript error: " << e.what() << '\n';
@@ -1157,6 +1281,7 @@ class ShadingCallback : public ShadingPatch::Callback {
 			pathElem->addAttribute("d", oss.str());
 			pathElem->setFillColor(color);
 			_group->append(std::move(pathElem));
+			MemoryMonitor::checkPageLimit();
 		}
 
 	private:
@@ -1177,15 +1302,19 @@ void PsSpecialHandler::processSequentialPatchMesh (int shadingTypeID, ColorSpace
 		read_patch_data(*patch, edgeflag, it, points, colors);
 		patch->setPoints(points, edgeflag, previousPatch.get());
 		patch->setColors(colors, edgeflag, previousPatch.get());
-		ShadingCallback callback(*_actions, _xmlnode, _clipStack.topID());
+		// meshes consisting of a single, suitably shaped patch can be drawn without approximation
+		bool singlePatch = !previousPatch && !it.valid();
+		if (!singlePatch || !processLinearGradientPatch(*patch)) {
+			ShadingCallback callback(*_actions, _xmlnode, _clipStack.topID());
 #if 0
-		if (bgcolorGiven) {
-			// fill whole patch area with given background color
-			GraphicsPath<double> outline = patch->getBoundaryPath();
-			callback.patchSegment(outline, bgcolor);
-		}
+			if (bgcolorGiven) {
+				// fill whole patch area with given background color
+				GraphicsPath<double> outline = patch->getBoundaryPath();
+				callback.patchSegment(outline, bgcolor);
+			}
 #endif
-		patch->approximate(SHADING_SEGMENT_SIZE, SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
+			patch->approximate(shading_segment_size(), SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
+		}
 		if (!_xmlnode) {
 			// update bounding box
 			BoundingBox bbox = patch->getBBox();
@@ -1235,17 +1364,297 @@ void PsSpecialHandler::processLatticeTriangularPatchMesh (ColorSpace colorSpace,
 			const PatchVertex &v3 = (*rowptr2)[i], &v4 = (*rowptr2)[i+1];
 			patch.setPoints(v1.point, v2.point, v3.point);
 			patch.setColors(v1.color, v2.color, v3.color);
-			patch.approximate(SHADING_SEGMENT_SIZE, SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
+			patch.approximate(shading_segment_size(), SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
 
 			patch.setPoints(v2.point, v3.point, v4.point);
 			patch.setColors(v2.color, v3.color, v4.color);
-			patch.approximate(SHADING_SEGMENT_SIZE, SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
+			patch.approximate(shading_segment_size(), SHADING_SEGMENT_OVERLAP, SHADING_SIMPLIFY_DELTA, callback);
 		}
 		swap(rowptr1, rowptr2);
 	}
 }
 
 
+/** Parameters of a function segment that maps the parametric variable t of an axial or radial
+ *  shading to a color: The input value x is linearly mapped from the subdomain [s0,s1] to [e0,e1],
+ *  and the color components are computed by c0 + x^n*(c1-c0). Stitching functions consist of
+ *  several such segments, simple exponential interpolation functions of a single one. */
+struct ShadingFunctionSegment {
+	double s0, s1;  ///< subdomain covered by the segment
+	double e0, e1;  ///< encoding of the subdomain
+	double n;       ///< interpolation exponent
+	valarray<double> c0, c1;  ///< color components at the lower and upper end of the encoded subdomain
+
+	valarray<double> valueAt (double x) const {
+		double t = (s0 == s1) ? e0 : e0 + (x-s0)*(e1-e0)/(s1-s0);
+		return c0 + pow(t, n)*(c1-c0);
+	}
+};
+
+
+/** Reads the shading parameters common to axial and radial shadings and computes the
+ *  corresponding gradient stops. The data is expected in the following order:
+ *  - extend flags of the start and end of the gradient (0 or 1)
+ *  - domain of the parametric variable t (t0 t1)
+ *  - number of function segments, followed by the parameters of each segment:
+ *    subdomain (s0 s1), encoding (e0 e1), exponent N, components of C0 and C1
+ *  @param[in] colorSpace color space of the function values
+ *  @param[in,out] it iterator used to sequentially access the shading data
+ *  @param[out] extend extend flags of the start and end of the gradient
+ *  @param[out] stops offsets and colors of the gradient stops
+ *  @return false if the parameters don't describe a valid gradient */
+static bool read_gradient_data (Color::ColorSpace colorSpace, VectorIterator<double> &it,
+		bool extend[2], vector<pair<double,Color>> &stops)
+{
+	extend[0] = bool(*it++);
+	extend[1] = bool(*it++);
+	double t0 = *it++;
+	double t1 = *it++;
+	int numSegments = static_cast<int>(*it++);
+	const int numComponents = Color::numComponents(colorSpace);
+	vector<ShadingFunctionSegment> segments(max(0, numSegments));
+	for (ShadingFunctionSegment &segment : segments) {
+		segment.s0 = *it++;
+		segment.s1 = *it++;
+		segment.e0 = *it++;
+		segment.e1 = *it++;
+		segment.n = *it++;
+		segment.c0.resize(numComponents);
+		segment.c1.resize(numComponents);
+		for (double &c : segment.c0) c = *it++;
+		for (double &c : segment.c1) c = *it++;
+	}
+	if (t0 == t1 || segments.empty())
+		return false;
+	// SVG interpolates the colors of adjacent stops linearly in RGB space, so the color
+	// functions must be sampled if they are not linear in RGB space too
+	bool rgb = (colorSpace == Color::ColorSpace::RGB || colorSpace == Color::ColorSpace::GRAY);
+	for (const ShadingFunctionSegment &segment : segments) {
+		// restrict the segment to the domain of the shading
+		double x0 = max(min(segment.s0, segment.s1), min(t0, t1));
+		double x1 = min(max(segment.s0, segment.s1), max(t0, t1));
+		if (x0 > x1)
+			continue;
+		int numSamples = (rgb && segment.n == 1) ? 1 : max(1, shading_segment_size());
+		for (int i=0; i <= numSamples; i++) {
+			double x = x0 + (x1-x0)*i/numSamples;
+			stops.emplace_back((x-t0)/(t1-t0), Color(segment.valueAt(x), colorSpace));
+		}
+	}
+	if (stops.empty())
+		return false;
+	if (t0 > t1)
+		reverse(stops.begin(), stops.end());
+	return true;
+}
+
+
+/** Creates an SVG gradient element.
+ *  @param[in] name element name (linearGradient or radialGradient)
+ *  @param[in] stops offsets and colors of the gradient stops
+ *  @param[in] matrix transformation applied to the gradient coordinates */
+static unique_ptr<SVGElement> create_gradient (const string &name, const vector<pair<double,Color>> &stops, const Matrix &matrix) {
+	auto gradient = util::make_unique<SVGElement>(name);
+	gradient->addAttribute("gradientUnits", "userSpaceOnUse");
+	if (!matrix.isIdentity())
+		gradient->addAttribute("gradientTransform", matrix.toSVG());
+	for (const auto &stop : stops) {
+		auto stopElem = util::make_unique<SVGElement>("stop");
+		stopElem->addAttribute("offset", stop.first);
+		stopElem->addAttribute("stop-color", stop.second.svgColorString());
+		gradient->append(std::move(stopElem));
+	}
+	return gradient;
+}
+
+
+/** Returns the corners of a bounding box in user space coordinates.
+ *  @param[in] bbox box given in page coordinates
+ *  @param[in] matrix current transformation matrix */
+static vector<DPair> box_corners (const BoundingBox &bbox, const Matrix &matrix) {
+	vector<DPair> corners;
+	Matrix inverse = matrix;
+	inverse.invert();
+	for (const DPair &p : {DPair(bbox.minX(), bbox.minY()), DPair(bbox.maxX(), bbox.minY()),
+	                       DPair(bbox.maxX(), bbox.maxY()), DPair(bbox.minX(), bbox.maxY())})
+		corners.push_back(inverse*p);
+	return corners;
+}
+
+
+/** Returns the corners of the area a shading extends to in user space coordinates.
+ *  If a clipping path is active, which is also the case if the shading dictionary
+ *  contains a BBox entry, it's the bounding box of the clipping path. Otherwise, the
+ *  page box is used if it's known in advance. If neither is available, the vector is empty. */
+static vector<DPair> shading_area_corners (const GraphicsPath<double> *clippath, const SpecialActions &actions) {
+	if (clippath)
+		return box_corners(clippath->computeBBox(), actions.getMatrix());
+	BoundingBox pagebox = actions.getFixedPageBBox();
+	if (pagebox.valid())
+		return box_corners(pagebox, actions.getMatrix());
+	return vector<DPair>();
+}
+
+
+/** Draws an axial shading (shading type 2) by a path filled with a linear gradient.
+ *  The painted area is limited by the active clipping path or, if there's none, by the
+ *  page box (see shading_area_corners()). If neither is available, nothing is drawn.
+ *  The shading data is expected in the following order:
+ *  - start and end point of the axis (x0 y0 x1 y1)
+ *  - gradient data as described in read_gradient_data()
+ *  @param[in] colorSpace color space of the function values
+ *  @param[in,out] it iterator used to sequentially access the shading data */
+void PsSpecialHandler::processAxialShading (ColorSpace colorSpace, VectorIterator<double> &it) {
+	DPair p0(*it, *(it+1));
+	DPair p1(*(it+2), *(it+3));
+	it += 4;
+	bool extend[2];
+	vector<pair<double,Color>> stops;
+	if (!read_gradient_data(colorSpace, it, extend, stops) || p0 == p1 || abs(det(_actions->getMatrix())) < 1e-12)
+		return;
+
+	// If the extent of the shading is unknown, i.e. if there's neither a clipping path
+	// nor a fixed page box, the shading is skipped as it can't be limited properly.
+	Path path;
+	vector<DPair> corners = shading_area_corners(_clipStack.path(), *_actions);
+	if (!axial_shading_area(p0, p1, extend, corners, path))
+		return;
+	auto gradient = create_gradient("linearGradient", stops, _actions->getMatrix());
+	gradient->addAttribute("x1", p0.x());
+	gradient->addAttribute("y1", p0.y());
+	gradient->addAttribute("x2", p1.x());
+	gradient->addAttribute("y2", p1.y());
+	fillWithGradient(std::move(path), std::move(gradient));
+}
+
+
+static void add_circle (GraphicsPath<double> &path, const DPair &center, double r) {
+	path.moveto(center.x()+r, center.y());
+	path.arcto(r, r, 0, false, true, DPair(center.x()-r, center.y()));
+	path.arcto(r, r, 0, false, true, DPair(center.x()+r, center.y()));
+	path.closepath();
+}
+
+
+/** Draws a radial shading (shading type 3) by a path filled with a radial gradient.
+ *  SVG 1.1 radial gradients are restricted to a focal point located inside the end circle.
+ *  Thus, only shadings where one of the two circles is a point inside the other circle, or
+ *  where both circles are concentric, can be represented exactly and are drawn.
+ *  The shading data is expected in the following order:
+ *  - center and radius of the start and end circle (x0 y0 r0 x1 y1 r1)
+ *  - gradient data as described in read_gradient_data()
+ *  @param[in] colorSpace color space of the function values
+ *  @param[in,out] it iterator used to sequentially access the shading data */
+void PsSpecialHandler::processRadialShading (ColorSpace colorSpace, VectorIterator<double> &it) {
+	DPair c0(*it, *(it+1));
+	double r0 = *(it+2);
+	DPair c1(*(it+3), *(it+4));
+	double r1 = *(it+5);
+	it += 6;
+	bool extend[2];
+	vector<pair<double,Color>> stops;
+	if (!read_gradient_data(colorSpace, it, extend, stops) || abs(det(_actions->getMatrix())) < 1e-12)
+		return;
+
+	bool reversed = (r0 > r1);
+	if (reversed) {  // ensure the start circle to be the smaller one
+		swap(c0, c1);
+		swap(r0, r1);
+		swap(extend[0], extend[1]);
+	}
+	double dist = (c1-c0).length();
+	bool concentric = (dist < 1e-6*r1);
+	if (r0 < 0 || r1 <= 0 || (r0 > 0 && !concentric) || dist >= r1)
+		return;
+
+	// map the offsets of the stops to the radii of the end circle
+	for (auto &stop : stops) {
+		double offset = reversed ? 1-stop.first : stop.first;
+		stop.first = (r0 + offset*(r1-r0))/r1;
+	}
+	if (reversed)
+		reverse(stops.begin(), stops.end());
+
+	Path path;
+	vector<DPair> corners = shading_area_corners(_clipStack.path(), *_actions);
+	if (extend[1] && !corners.empty()) {
+		// fill the whole clipping area or page
+		path.moveto(corners[0]);
+		for (size_t i=1; i < corners.size(); i++)
+			path.lineto(corners[i]);
+		path.closepath();
+	}
+	else
+		add_circle(path, c1, r1);
+	if (!extend[0] && r0 > 0) {
+		// exclude the interior of the start circle
+		add_circle(path, c0, r0);
+		path.setWindingRule(Path::WindingRule::EVEN_ODD);
+	}
+
+	auto gradient = create_gradient("radialGradient", stops, _actions->getMatrix());
+	gradient->addAttribute("cx", c1.x());
+	gradient->addAttribute("cy", c1.y());
+	gradient->addAttribute("r", r1);
+	if (!concentric) {
+		gradient->addAttribute("fx", c0.x());
+		gradient->addAttribute("fy", c0.y());
+	}
+	fillWithGradient(std::move(path), std::move(gradient));
+}
+
+
+/** Draws a Coons or tensor-product patch by a single path filled with a linear gradient
+ *  if the shading can be represented exactly that way.
+ *  @param[in] patch the patch to draw
+ *  @return true if the patch was drawn */
+bool PsSpecialHandler::processLinearGradientPatch (const ShadingPatch &patch) {
+	if (patch.psShadingType() != 6 && patch.psShadingType() != 7)
+		return false;
+	Matrix matrix(1);
+	Color color1, color2;
+	if (!static_cast<const TensorProductPatch&>(patch).isLinearGradient(matrix, color1, color2))
+		return false;
+	// the gradient runs along the x-axis of the unit square mapped to the patch area
+	matrix.lmultiply(_actions->getMatrix());
+	auto gradient = create_gradient("linearGradient", {{0, color1}, {1, color2}}, matrix);
+	gradient->addAttribute("x2", 1);  // x1, y1, and y2 default to 0
+	fillWithGradient(patch.getBoundaryPath(), std::move(gradient));
+	return true;
+}
+
+
+/** Adds a gradient to the defs section and draws the given path filled with it.
+ *  @param[in] path the area to fill (in user space coordinates)
+ *  @param[in] gradient the gradient element without ID */
+void PsSpecialHandler::fillWithGradient (Path path, unique_ptr<SVGElement> gradient) {
+	string id = "grad"+to_string(++_gradientCount);
+	gradient->addAttribute("id", id);
+	_actions->svgTree().appendToDefs(std::move(gradient));
+
+	if (!_actions->getMatrix().isIdentity())
+		path.transform(_actions->getMatrix());
+	BoundingBox bbox = path.computeBBox();
+	ostringstream oss;
+	path.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS);
+	auto pathElem = util::make_unique<SVGElement>("path");
+	pathElem->addAttribute("d", oss.str());
+	pathElem->setFillPatternUrl(id);
+	pathElem->setFillRule(path.windingRule() == Path::WindingRule::EVEN_ODD ? SVGElement::FR_EVENODD : SVGElement::FR_NONZERO);
+	pathElem->setFillOpacity(_opacity);
+	if (_clipStack.path() && !_makingPattern) {
+		pathElem->setClipPathUrl("clip"+XMLString(_clipStack.topID()));
+		bbox.intersect(_clipStack.path()->computeBBox());
+	}
+	if (_xmlnode)
+		_xmlnode->append(std::move(pathElem));
+	else {
+		_actions->svgTree().appendToPage(std::move(pathElem));
+		_actions->embed(bbox);
+	}
+}
+
+
 /** Clears current path. */
 void PsSpecialHandler::newpath (vector<double> &p) {
 	bool calledByNewpathOp = (p[0] > 0);
@@ -25,6 +25,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "GraphicsPath.hpp"
 #include "PDFHandler.hpp"
@@ -35,7 +36,9 @@
 #include "SpecialHandler.hpp"
 
 class PSPattern;
+class ShadingPatch;
 class SVGElement;
+class SVGTree;
 class XMLElement;
 
 class PsSpecialHandler : public SpecialHandler, protected PSActions {
@@ -92,14 +95,18 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		PsSpecialHandler ();
 		~PsSpecialHandler () override;
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* info () const override {return "dvips PostScript specials";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "ps";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_BEGIN_PAGE|EV_END_PAGE;}
 		void setDviScaleFactor (double dvi2bp) override {_previewHandler.setDviScaleFactor(dvi2bp);}
 		void enterBodySection ();
 		PSInterpreter& psInterpreter () {return _psi;}
+		void keepPDFOpen (bool keep);
+		void clearBitmapIDs () {_bitmapIDs.clear();}
 
 	public:
 		static bool COMPUTE_CLIPPATHS_INTERSECTIONS;
@@ -111,7 +118,7 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 	protected:
 		void initialize ();
 		void initgraphics ();
-		void moveToDVIPos ();
+		void moveToDVIPos (bool flush=true);
 		void executeAndSync (std::istream &is, bool updatePos);
 		void processHeaderFile (const char *fname);
 		void imgfile (FileType type, const std::string &fname, const std::map<std::string,std::string> &attr);
@@ -119,11 +126,18 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		ImageNode createBitmapNode (const std::string &fname, const std::string &path, int pageno, BoundingBox bbox);
 		ImageNode createPSNode (const std::string &fname, const std::string &path, int pageno, BoundingBox bbox, bool clip);
 		ImageNode createPDFNode (const std::string &fname, const std::string &path, int pageno, BoundingBox bbox, bool clip);
+		bool processPDFWithGS () const;
+		std::string bitmapID (const std::string &fname, double width, double height, SVGTree &svg);
 		void dviBeginPage (unsigned int pageno, SpecialActions &actions) override;
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
+		void synchronize (SpecialActions &actions) override;
 		void clip (Path path, bool evenodd);
 		void processSequentialPatchMesh (int shadingTypeID, ColorSpace cspace, VectorIterator<double> &it);
 		void processLatticeTriangularPatchMesh (ColorSpace colorSpace, VectorIterator<double> &it);
+		void processAxialShading (ColorSpace colorSpace, VectorIterator<double> &it);
+		void processRadialShading (ColorSpace colorSpace, VectorIterator<double> &it);
+		bool processLinearGradientPatch (const ShadingPatch &patch);
+		void fillWithGradient (Path path, std::unique_ptr<SVGElement> gradient);
 
 		/// scale given value by current PS scale factors
 		double scale (double v) const {return v*(_sx*(1-_cos*_cos) + _sy*_cos*_cos);}
@@ -199,11 +213,15 @@ class PsSpecialHandler : public SpecialHandler, protected PSActions {
 		std::vector<double> _dashpattern;
 		ClippingStack _clipStack;
 		int _imgClipCount=0;               ///< current number of clip paths assigned to images
+		int _gradientCount=0;              ///< current number of gradients created from PS shadings
+		std::unordered_set<std::string> _bitmapIDs;  ///< IDs of the bitmaps already added to the defs section
+		bool _outputPending=false;         ///< true if the output of recently executed PS specials hasn't been flushed yet
 		bool _makingPattern=false;         ///< true if executing makepattern operator
 		std::map<int, std::unique_ptr<PSPattern>> _patterns;
 		PSTilingPattern *_pattern;         ///< current pattern
 		bool _patternEnabled;              ///< true if active color space is a pattern
 		std::string _pdfProc;              ///< tool to process PDF files ("gs" or "mutool")
+		bool _keepPDFOpen=false;           ///< if true, PDF files processed by Ghostscript are kept open between pages
 };
 
 #endif
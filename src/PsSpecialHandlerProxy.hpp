@@ -26,6 +26,7 @@ class PsSpecialHandlerProxy : public SpecialHandler {
 	public:
 		explicit PsSpecialHandlerProxy (bool pswarning) : _pswarning(pswarning) {}
 		void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool needsPreprocessing () const override {return true;}
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
 		const char* name () const override {return "ps";}
 		const char* info () const override;
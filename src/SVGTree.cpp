@@ -27,9 +27,12 @@
 #include "FileSystem.hpp"
 #include "Font.hpp"
 #include "FontManager.hpp"
+#include "FontEngine.hpp"
 #include "FontWriter.hpp"
+#include "Profiler.hpp"
 #include "SVGCharHandlerFactory.hpp"
 #include "SVGTree.hpp"
+#include "ThreadPool.hpp"
 #include "XMLDocument.hpp"
 #include "XMLString.hpp"
 
@@ -42,16 +45,22 @@ FontWriter::FontFormat SVGTree::FONT_FORMAT = FontWriter::FontFormat::SVG;
 bool SVGTree::CREATE_USE_ELEMENTS=false;
 bool SVGTree::RELATIVE_PATH_CMDS=false;
 bool SVGTree::MERGE_CHARS=true;
+bool SVGTree::MERGE_LINES=false;
 bool SVGTree::ADD_COMMENTS=false;
 bool SVGTree::EMBED_BITMAP_DATA = false;
 double SVGTree::ZOOM_FACTOR=1.0;
 
 
-SVGTree::SVGTree () : _charHandler(SVGCharHandlerFactory::createHandler()) {
+/** Creates a new SVG tree.
+ *  @param[in] numThreads number of worker threads used to process the fonts (0: default number) */
+SVGTree::SVGTree (unsigned numThreads) : _charHandler(SVGCharHandlerFactory::createHandler()), _numThreads(numThreads) {
 	reset();
 }
 
 
+SVGTree::~SVGTree () =default;
+
+
 /** Clears the SVG tree and initializes the root element. */
 void SVGTree::reset () {
 	_doc.clear();
@@ -63,6 +72,71 @@ void SVGTree::reset () {
 	_doc.setRootNode(std::move(rootNode));
 	_page = _defs = nullptr;
 	_styleCDataNode = nullptr;
+	_mergePath = nullptr;
+}
+
+
+/** Stream buffer that forwards all characters to another stream buffer and counts them. */
+class CountingStreamBuffer : public streambuf {
+	public:
+		explicit CountingStreamBuffer (streambuf *sink) : _sink(sink) {}
+		uint64_t count () const {return _count;}
+
+	protected:
+		int_type overflow (int_type c) override {
+			if (traits_type::eq_int_type(c, traits_type::eof()))
+				return traits_type::not_eof(c);
+			if (traits_type::eq_int_type(_sink->sputc(traits_type::to_char_type(c)), traits_type::eof()))
+				return traits_type::eof();
+			_count++;
+			return c;
+		}
+
+		streamsize xsputn (const char *s, streamsize n) override {
+			streamsize written = _sink->sputn(s, n);
+			_count += written;
+			return written;
+		}
+
+		int sync () override {return _sink->pubsync();}
+
+	private:
+		streambuf *_sink;
+		uint64_t _count=0;
+};
+
+
+/** Returns the number of nodes of an XML subtree. */
+static uint64_t count_nodes (const XMLElement &elem) {
+	uint64_t count=1;
+	for (const XMLNode *child : elem) {
+		if (const XMLElement *childElem = child->toElement())
+			count += count_nodes(*childElem);
+		else
+			count++;
+	}
+	return count;
+}
+
+
+/** Writes the SVG document to a given output stream. Files referenced by deferred
+ *  attributes (see XMLElement::embedDeferredFiles) are encoded and embedded beforehand.
+ *  @param[in] os stream to write to
+ *  @return true on success */
+bool SVGTree::write (ostream &os) {
+	Profiler::Scope scope("svg output");
+	if (_root)
+		_root->embedDeferredFiles();
+	if (!Profiler::ENABLED)
+		return bool(_doc.write(os));
+	// collect the number of nodes and bytes written
+	CountingStreamBuffer countingBuffer(os.rdbuf());
+	ostream countingStream(&countingBuffer);
+	bool success = _doc.write(countingStream) && os;
+	Profiler::instance().addCount("bytes written", countingBuffer.count());
+	if (_root)
+		Profiler::instance().addCount("nodes", count_nodes(*_root));
+	return success;
 }
 
 
@@ -133,6 +207,7 @@ void SVGTree::newPage (int pageno) {
 	_root->append(std::move(pageNode));
 	_defsContextStack = stack<SVGElement*>();
 	_pageContextStack = stack<SVGElement*>();
+	_mergePath = nullptr;
 }
 
 
@@ -148,17 +223,44 @@ void SVGTree::appendToDefs (unique_ptr<XMLNode> node) {
 
 
 void SVGTree::appendToPage (unique_ptr<XMLNode> node) {
-	SVGElement *parent = _pageContextStack.empty() ? _page : _pageContextStack.top();
+	SVGElement *parent = pageContextNode();
 	parent->append(std::move(node));
 	_charHandler->setInitialContextNode(parent);
 }
 
 
+/** Appends a path element to the current page. If the preceding node was also
+ *  added by this function and has the same attributes, the path data is appended
+ *  to the existing element instead. This way, a sequence of shapes drawn with
+ *  identical properties results in a single path element with several subpaths.
+ *  @param[in] path element providing all attributes except the path data
+ *  @param[in] data path data of the shape (must start with a moveto command) */
+void SVGTree::appendPathToPage (unique_ptr<SVGElement> path, const string &data) {
+	if (_mergePath && pageContextNode()->lastChild() == _mergePath) {
+		const XMLElement::Attributes &attribs1 = _mergePath->attributes();
+		const XMLElement::Attributes &attribs2 = path->attributes();
+		bool equalAttribs = attribs1.size() == attribs2.size()+1
+			&& equal(attribs2.begin(), attribs2.end(), attribs1.begin()+1, [](const XMLElement::Attribute &attr1, const XMLElement::Attribute &attr2) {
+				return attr1.name == attr2.name && attr1.value == attr2.value;
+			});
+		if (equalAttribs) {
+			string &d = _mergePath->attributes().front().value;
+			// the initial moveto of a path is always absolute, so 'm' must be turned into 'M'
+			d += data;
+			if (data[0] == 'm')
+				d[d.length()-data.length()] = 'M';
+			return;
+		}
+	}
+	XMLElement::Attributes &attribs = path->attributes();
+	attribs.emplace(attribs.begin(), "d", data);
+	_mergePath = path.get();
+	appendToPage(std::move(path));
+}
+
+
 void SVGTree::prependToPage (unique_ptr<XMLNode> node) {
-	if (_pageContextStack.empty())
-		_page->prepend(std::move(node));
-	else
-		_pageContextStack.top()->prepend(std::move(node));
+	pageContextNode()->prepend(std::move(node));
 }
 
 
@@ -167,18 +269,28 @@ void SVGTree::transformPage (const Matrix &usermatrix) {
 }
 
 
+/** Returns the factors to scale the glyph outlines of a font by. */
+static pair<double,double> glyph_scale_factors (const PhysicalFont &font) {
+	if (SVGTree::USE_FONTS)
+		return {1.0, 1.0};
+	double sx = font.scaledSize()/font.unitsPerEm();
+	return {sx, -sx};
+}
+
+
 /** Creates an SVG element for a single glyph.
  *  @param[in] c character number
  *  @param[in] font font to extract the glyph from
  *  @param[in] cb pointer to callback object for sending feedback to the glyph tracer (may be 0)
+ *  @param[in] path if not 0, already extracted outline (flag and path data) to be used
  *  @return pointer to element node if glyph exists, 0 otherwise */
-static unique_ptr<XMLElement> createGlyphNode (int c, const PhysicalFont &font, GFGlyphTracer::Callback *cb) {
+static unique_ptr<XMLElement> createGlyphNode (int c, const PhysicalFont &font, GFGlyphTracer::Callback *cb, const pair<bool,string> *path=nullptr) {
 	Glyph glyph;
-	if (!font.getGlyph(c, glyph, cb) || (!SVGTree::USE_FONTS && !SVGTree::CREATE_USE_ELEMENTS))
+	if (path ? !path->first : !font.getGlyph(c, glyph, cb))
+		return nullptr;
+	if (!SVGTree::USE_FONTS && !SVGTree::CREATE_USE_ELEMENTS)
 		return nullptr;
 
-	double sx=1.0, sy=1.0;
-	double upem = font.unitsPerEm();
 	unique_ptr<XMLElement> glyphNode;
 	if (SVGTree::USE_FONTS) {
 		double extend = font.style() ? font.style()->extend : 1;
@@ -193,16 +305,53 @@ static unique_ptr<XMLElement> createGlyphNode (int c, const PhysicalFont &font,
 	else {
 		glyphNode = util::make_unique<XMLElement>("path");
 		glyphNode->addAttribute("id", "g"+to_string(FontManager::instance().fontID(&font))+"-"+to_string(c));
-		sx = font.scaledSize()/upem;
-		sy = -sx;
 	}
-	ostringstream oss;
-	glyph.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS, sx, sy);
-	glyphNode->addAttribute("d", oss.str());
+	if (path)
+		glyphNode->addAttribute("d", path->second);
+	else {
+		auto scale = glyph_scale_factors(font);
+		ostringstream oss;
+		glyph.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS, scale.first, scale.second);
+		glyphNode->addAttribute("d", oss.str());
+	}
 	return glyphNode;
 }
 
 
+/** Extracts the outlines of several glyphs of a vector font and returns their SVG path data.
+ *  The function only accesses the FreeType objects of the calling thread and can therefore
+ *  be executed concurrently.
+ *  @param[in] font font to extract the glyphs from
+ *  @param[in] path path of the font file
+ *  @param[in] chars characters to look up in the font file
+ *  @param[in] scale horizontal and vertical scale factors applied to the outlines
+ *  @return pairs of validity flag and path data in the order of the given characters */
+static vector<pair<bool,string>> trace_glyph_outlines (const PhysicalFont *font, const string &path, const vector<Character> &chars, pair<double,double> scale) {
+	vector<pair<bool,string>> paths;
+	paths.reserve(chars.size());
+	FontEngine &engine = FontEngine::instance();
+	bool fontSet = engine.setFont(*font, path);
+	for (const Character &c : chars) {
+		Glyph glyph;
+		bool ok = fontSet && engine.traceOutline(c, glyph, false);
+		glyph.closeOpenSubPaths();
+		ostringstream oss;
+		glyph.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS, scale.first, scale.second);
+		paths.emplace_back(ok, oss.str());
+	}
+	return paths;
+}
+
+
+/** Returns true if the glyph outlines of a font are required to embed it. */
+static bool glyph_outlines_required (const PhysicalFont &font) {
+	if (SVGTree::USE_FONTS)
+		return SVGTree::FONT_FORMAT == FontWriter::FontFormat::SVG;
+	// without use elements, the glyphs are drawn on the page directly and not embedded
+	return SVGTree::CREATE_USE_ELEMENTS && &font == font.uniqueFont();
+}
+
+
 static string font_info (const Font &font) {
 	ostringstream oss;
 	if (auto nf = font_cast<const NativeFont*>(&font)) {
@@ -253,7 +402,80 @@ void SVGTree::appendFontStyles (const unordered_set<const Font*> &fonts) {
  *  @param[in] font font to be appended
  *  @param[in] chars codes of the characters whose glyph outlines should be appended
  *  @param[in] callback pointer to callback object for sending feedback to the glyph tracer (may be 0) */
-void SVGTree::append (const PhysicalFont &font, const set<int> &chars, GFGlyphTracer::Callback *callback) {
+void SVGTree::append (const PhysicalFont &font, const CharSet &chars, GFGlyphTracer::Callback *callback) {
+	append(font, chars, callback, nullptr);
+}
+
+
+/** Appends glyph definitions of several fonts to the defs section of the SVG tree.
+ *  The outlines of the glyphs of different vector fonts are extracted concurrently,
+ *  while the resulting elements are appended in the order of the given font list.
+ *  If the fonts are embedded as TTF, WOFF, or WOFF2 data, the font files are compressed
+ *  concurrently.
+ *  @param[in] fontchars fonts together with the codes of the characters to be appended
+ *  @param[in] callback pointer to callback object for sending feedback to the glyph tracer (may be 0) */
+void SVGTree::append (const vector<FontChars> &fontchars, GFGlyphTracer::Callback *callback) {
+	if (USE_FONTS && FONT_FORMAT != FontWriter::FontFormat::SVG) {
+		vector<future<string>> fontfaces;
+		for (const FontChars &fc : fontchars) {
+			if (!fc.second->empty())
+				fontfaces.push_back(FontWriter(*fc.first).createCSSFontFace(FONT_FORMAT, *fc.second, threadPool(), callback));
+		}
+		for (auto &fontface : fontfaces) {
+			string css = fontface.get();
+			if (!css.empty())
+				styleCDataNode()->append(std::move(css));
+		}
+		Message::flush();  // print the messages written by the worker threads
+		return;
+	}
+	vector<size_t> indexes;  // indexes of the fonts whose glyphs are traced by FreeType
+	for (size_t i=0; i < fontchars.size(); i++) {
+		const PhysicalFont &font = *fontchars[i].first;
+		if (!fontchars[i].second->empty() && font.type() != PhysicalFont::Type::MF && glyph_outlines_required(font))
+			indexes.push_back(i);
+	}
+	vector<future<GlyphPaths>> futures(fontchars.size());
+	if (indexes.size() > 1 && threadPool().numThreads() > 1) {
+		for (size_t i : indexes) {
+			const PhysicalFont *font = fontchars[i].first;
+			if (const char *path = font->path()) {
+				// evaluate the font map and encoding data here as they aren't thread-safe
+				vector<Character> chars;
+				for (int c : *fontchars[i].second)
+					chars.push_back(font->decodeGlyphChar(c));
+				futures[i] = threadPool().enqueue(trace_glyph_outlines, font, string(path), std::move(chars), glyph_scale_factors(*font));
+			}
+		}
+	}
+	for (size_t i=0; i < fontchars.size(); i++) {
+		if (!futures[i].valid())
+			append(*fontchars[i].first, *fontchars[i].second, callback);
+		else {
+			GlyphPaths paths = futures[i].get();
+			append(*fontchars[i].first, *fontchars[i].second, callback, &paths);
+		}
+	}
+	Message::flush();  // print the messages written by the worker threads
+}
+
+
+/** Returns the pool of worker threads used to process the fonts. It's kept alive
+ *  together with the tree so that the threads can reuse their FontEngine objects,
+ *  and thus the already loaded fonts, when processing the following pages. */
+ThreadPool& SVGTree::threadPool () {
+	if (!_threadPool)
+		_threadPool = util::make_unique<ThreadPool>(_numThreads);
+	return *_threadPool;
+}
+
+
+/** Appends glyph definitions of a given font to the defs section of the SVG tree.
+ *  @param[in] font font to be appended
+ *  @param[in] chars codes of the characters whose glyph outlines should be appended
+ *  @param[in] callback pointer to callback object for sending feedback to the glyph tracer (may be 0)
+ *  @param[in] paths if not 0, already extracted glyph outlines in the order of the given characters */
+void SVGTree::append (const PhysicalFont &font, const CharSet &chars, GFGlyphTracer::Callback *callback, const GlyphPaths *paths) {
 	if (chars.empty())
 		return;
 
@@ -283,8 +505,9 @@ void SVGTree::append (const PhysicalFont &font, const set<int> &chars, GFGlyphTr
 				faceNode->addAttribute("descent", font.descent());
 			}
 			fontNode->append(std::move(faceNode));
+			size_t index=0;
 			for (int c : chars)
-				fontNode->append(createGlyphNode(c, font, callback));
+				fontNode->append(createGlyphNode(c, font, callback, paths ? &(*paths)[index++] : nullptr));
 			appendToDefs(std::move(fontNode));
 		}
 	}
@@ -304,8 +527,9 @@ void SVGTree::append (const PhysicalFont &font, const set<int> &chars, GFGlyphTr
 		}
 	}
 	else {
+		size_t index=0;
 		for (int c : chars)
-			appendToDefs(createGlyphNode(c, font, callback));
+			appendToDefs(createGlyphNode(c, font, callback, paths ? &(*paths)[index++] : nullptr));
 	}
 }
 
@@ -23,9 +23,12 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <stack>
+#include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
+#include "CharSet.hpp"
 #include "Color.hpp"
 #include "FontWriter.hpp"
 #include "GFGlyphTracer.hpp"
@@ -40,21 +43,29 @@ class Font;
 class Matrix;
 class Opacity;
 class PhysicalFont;
+class ThreadPool;
 
 class SVGTree {
+	using GlyphPaths = std::vector<std::pair<bool,std::string>>;  ///< validity flags and SVG path data of glyph outlines
+
 	public:
-		SVGTree ();
+		using FontChars = std::pair<const PhysicalFont*, const CharSet*>;
+
+		explicit SVGTree (unsigned numThreads=0);
+		~SVGTree ();
 		void reset ();
-		bool write (std::ostream &os) const {return bool(_doc.write(os));}
+		bool write (std::ostream &os);
 		void newPage (int pageno);
 		void appendToDefs (std::unique_ptr<XMLNode> node);
 		void appendToPage (std::unique_ptr<XMLNode> node);
 		void prependToPage (std::unique_ptr<XMLNode> node);
+		void appendPathToPage (std::unique_ptr<SVGElement> path, const std::string &data);
 		void appendToDoc (std::unique_ptr<XMLNode> node)  {_doc.append(std::move(node));}
 		void appendToRoot (std::unique_ptr<XMLNode> node) {_root->append(std::move(node));}
 		void appendChar (int c, double x, double y) {_charHandler->appendChar(c, x, y);}
 		void appendFontStyles (const std::unordered_set<const Font*> &fonts);
-		void append (const PhysicalFont &font, const std::set<int> &chars, GFGlyphTracer::Callback *callback=nullptr);
+		void append (const PhysicalFont &font, const CharSet &chars, GFGlyphTracer::Callback *callback=nullptr);
+		void append (const std::vector<FontChars> &fontchars, GFGlyphTracer::Callback *callback=nullptr);
 		void pushDefsContext (std::unique_ptr<SVGElement> node);
 		void popDefsContext ();
 		void pushPageContext (std::unique_ptr<SVGElement> node);
@@ -78,9 +89,12 @@ class SVGTree {
 		XMLElement* rootNode () const       {return _root;}
 		XMLElement* defsNode () const       {return _defs;}
 		XMLElement* pageNode () const       {return _page;}
+		SVGElement* pageContextNode () const {return _pageContextStack.empty() ? _page : _pageContextStack.top();}
 
 	protected:
 		XMLCData* styleCDataNode ();
+		ThreadPool& threadPool ();
+		void append (const PhysicalFont &font, const CharSet &chars, GFGlyphTracer::Callback *callback, const GlyphPaths *paths);
 
 	public:
 		static bool USE_FONTS;           ///< if true, create font references and don't draw paths directly
@@ -89,6 +103,7 @@ class SVGTree {
 		static FontWriter::FontFormat FONT_FORMAT;   ///< format of fonts to be embedded
 		static bool RELATIVE_PATH_CMDS;  ///< relative path commands rather than absolute ones?
 		static bool MERGE_CHARS;         ///< whether to merge chars with common properties into the same <text> tag
+		static bool MERGE_LINES;         ///< whether to merge lines with common properties into the same <path> element
 		static bool ADD_COMMENTS;        ///< add comments with additional information
 		static double ZOOM_FACTOR;       ///< factor applied to width/height attribute
 		static bool EMBED_BITMAP_DATA;   ///< if true, bitmaps are embedded into the SVG document
@@ -97,9 +112,12 @@ class SVGTree {
 		XMLDocument _doc;
 		SVGElement *_root=nullptr, *_page=nullptr, *_defs=nullptr;
 		XMLCData *_styleCDataNode=nullptr;
+		SVGElement *_mergePath=nullptr;  ///< most recent path element created by appendPathToPage()
 		std::unique_ptr<SVGCharHandler> _charHandler;
 		std::stack<SVGElement*> _defsContextStack;
 		std::stack<SVGElement*> _pageContextStack;
+		unsigned _numThreads;  ///< number of worker threads used to process the fonts (0: default number)
+		std::unique_ptr<ThreadPool> _threadPool;  ///< worker threads extracting glyph outlines and creating font files
 };
 
 #endif
@@ -0,0 +1,63 @@
+/*************************************************************************
+** ShadingArea.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <algorithm>
+#include <limits>
+#include "ShadingArea.hpp"
+
+using namespace std;
+
+
+/** Computes the area covered by an axial shading inside a given quadrilateral.
+ *  @param[in] p0 start point of the axis
+ *  @param[in] p1 end point of the axis
+ *  @param[in] extend flags indicating whether the shading extends beyond p0 and p1
+ *  @param[in] corners corners of the quadrilateral limiting the shading area
+ *  @param[out] path the computed area (rectangle with two edges parallel to the axis)
+ *  @return true if a non-empty area was computed */
+bool axial_shading_area (const DPair &p0, const DPair &p1, const bool extend[2], const vector<DPair> &corners, GraphicsPath<double> &path) {
+	if (corners.empty() || p0 == p1)
+		return false;
+	// Compute the area to be painted in coordinates relative to the axis, where t specifies the
+	// position along the axis (t=0 at p0, t=1 at p1), and s the distance from the axis.
+	DPair axis = p1-p0;
+	DPair normal = axis.ortho()/axis.length();
+	double tmin, tmax, smin, smax;
+	tmin = smin = numeric_limits<double>::max();
+	tmax = smax = numeric_limits<double>::lowest();
+	for (const DPair &corner : corners) {
+		double t = dot(corner-p0, axis)/dot(axis, axis);
+		double s = dot(corner-p0, normal);
+		tmin = min(tmin, t); tmax = max(tmax, t);
+		smin = min(smin, s); smax = max(smax, s);
+	}
+	// without extension, the shading is restricted to the area between the normals through p0 and p1
+	if (!extend[0]) tmin = max(tmin, 0.0);
+	if (!extend[1]) tmax = min(tmax, 1.0);
+	if (tmin >= tmax || smin >= smax)
+		return false;
+	path.clear();
+	path.moveto(p0 + axis*tmin + normal*smin);
+	path.lineto(p0 + axis*tmax + normal*smin);
+	path.lineto(p0 + axis*tmax + normal*smax);
+	path.lineto(p0 + axis*tmin + normal*smax);
+	path.closepath();
+	return true;
+}
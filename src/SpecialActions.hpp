@@ -53,6 +53,7 @@ class SpecialActions {
 		virtual void setMatrix (const Matrix &m) =0;
 		virtual const Matrix& getMatrix () const =0;
 		virtual Matrix getPageTransformation () const {return Matrix(1);}
+		virtual BoundingBox getFixedPageBBox () const {return BoundingBox();}
 		virtual void setBgColor (const Color &color) =0;
 		virtual void setOpacity (const Opacity &opacity) =0;
 		virtual const Opacity& getOpacity () const =0;
@@ -0,0 +1,55 @@
+/*************************************************************************
+** SpecialHandler.cpp                                                   **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <istream>
+#include "InputReader.hpp"
+#include "SpecialHandler.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+
+/** Preprocesses a special whose text is available in memory. By default, the
+ *  unread characters are passed to preprocess() as a stream. Handlers parsing
+ *  the text with an InputReader can override this function to read the
+ *  characters directly.
+ *  @param[in] prefix special prefix read by the SpecialManager
+ *  @param[in] ir reader providing the special text following the prefix
+ *  @param[in] actions actions the special handler can perform */
+void SpecialHandler::preprocessText (const string &prefix, CharInputReader &ir, SpecialActions &actions) {
+	util::CharStreamBuffer buf(ir.pos(), ir.remaining());
+	istream is(&buf);
+	preprocess(prefix, is, actions);
+}
+
+
+/** Processes a special whose text is available in memory. By default, the
+ *  unread characters are passed to process() as a stream. Handlers parsing
+ *  the text with an InputReader can override this function to read the
+ *  characters directly.
+ *  @param[in] prefix special prefix read by the SpecialManager
+ *  @param[in] ir reader providing the special text following the prefix
+ *  @param[in] actions actions the special handler can perform
+ *  @return true if the special could be processed successfully */
+bool SpecialHandler::processText (const string &prefix, CharInputReader &ir, SpecialActions &actions) {
+	util::CharStreamBuffer buf(ir.pos(), ir.remaining());
+	istream is(&buf);
+	return process(prefix, is, actions);
+}
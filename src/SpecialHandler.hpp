@@ -25,10 +25,20 @@
 #include <list>
 #include <vector>
 
+class CharInputReader;
 class SpecialActions;
 class SpecialManager;
 
 class SpecialHandler {
+	public:
+		/** DVI events handlers can subscribe to (see SpecialManager::subscribe).
+		 *  Only subscribed handlers get the corresponding dviXXX function called. */
+		enum Event {
+			EV_BEGIN_PAGE=1,  ///< beginning of a page (dviBeginPage)
+			EV_END_PAGE=2,    ///< end of a page (dviEndPage)
+			EV_MOVE=4         ///< change of the current DVI position (dviMovedTo)
+		};
+
 	public:
 		virtual ~SpecialHandler () =default;
 		virtual const char* info () const =0;
@@ -36,11 +46,20 @@ class SpecialHandler {
 		virtual std::vector<const char*> prefixes () const =0;
 		virtual void setDviScaleFactor (double dvi2bp) {}
 		virtual void preprocess (const std::string &prefix, std::istream &is, SpecialActions &actions) {}
+		virtual void preprocessText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions);
+		/** Returns true if the handler evaluates its specials while the DVI file is being preprocessed. */
+		virtual bool needsPreprocessing () const {return false;}
 		virtual bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) =0;
+		virtual bool processText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions);
+		/** Returns the events (bitwise or'ed Event values) the handler subscribes to on registration. */
+		virtual unsigned subscribedEvents () const {return 0;}
 		virtual void dviPreprocessingFinished () {}
 		virtual void dviBeginPage (unsigned pageno, SpecialActions &actions) {}
 		virtual void dviEndPage (unsigned pageno, SpecialActions &actions) {}
 		virtual void dviMovedTo (double x, double y, SpecialActions &actions) {}
+		/** Called before a DVI command or a special of another handler is executed.
+		 *  Handlers that defer operations across consecutive specials must finish them here. */
+		virtual void synchronize (SpecialActions &actions) {}
 };
 
 #endif
@@ -18,9 +18,14 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
+#include <istream>
 #include <map>
-#include <sstream>
+#include "InputReader.hpp"
+#include "Profiler.hpp"
 #include "SpecialActions.hpp"
 #include "SpecialHandler.hpp"
 #include "SpecialManager.hpp"
@@ -40,6 +45,10 @@ SpecialManager& SpecialManager::instance() {
 void SpecialManager::unregisterHandlers () {
 	_handlerPool.clear();
 	_handlersByPrefix.clear();
+	_beginPageSubscribers.clear();
+	_endPageSubscribers.clear();
+	_moveSubscribers.clear();
+	_unsyncedHandlers.clear();
 }
 
 
@@ -49,9 +58,18 @@ void SpecialManager::unregisterHandlers () {
 void SpecialManager::registerHandler (unique_ptr<SpecialHandler> handler) {
 	if (handler) {
 		// get array of prefixes this handler is responsible for
-		for (const char *prefix : handler->prefixes())
-			_handlersByPrefix[prefix] = handler.get();
+		for (const char *prefix : handler->prefixes()) {
+			auto it = lower_bound(_handlersByPrefix.begin(), _handlersByPrefix.end(), prefix, [](const PrefixEntry &entry, const char *prefix) {
+				return entry.first < prefix;
+			});
+			if (it != _handlersByPrefix.end() && it->first == prefix)
+				it->second = handler.get();
+			else
+				_handlersByPrefix.emplace(it, prefix, handler.get());
+		}
+		SpecialHandler *handlerPtr = handler.get();
 		_handlerPool.emplace_back(std::move(handler));
+		subscribe(handlerPtr, handlerPtr->subscribedEvents());
 	}
 }
 
@@ -91,25 +109,97 @@ void SpecialManager::unregisterHandler (SpecialHandler *handler) {
 			return h.get() == handler;
 		});
 		if (it != _handlerPool.end()) {
-			for (const char *prefix : handler->prefixes())
-				_handlersByPrefix.erase(prefix);
+			for (const char *prefix : handler->prefixes()) {
+				if (const PrefixEntry *entry = findPrefixEntry(prefix, strlen(prefix)))
+					_handlersByPrefix.erase(_handlersByPrefix.begin()+(entry-_handlersByPrefix.data()));
+			}
+			unsubscribe(handler, SpecialHandler::EV_BEGIN_PAGE|SpecialHandler::EV_END_PAGE|SpecialHandler::EV_MOVE);
+			_unsyncedHandlers.erase(remove(_unsyncedHandlers.begin(), _unsyncedHandlers.end(), handler), _unsyncedHandlers.end());
 			_handlerPool.erase(it);
 		}
 	}
 }
 
 
+/** Returns the position of a handler in the handler pool, i.e. the number of
+ *  handlers registered before it, or the pool size if the handler isn't registered. */
+size_t SpecialManager::poolIndex (const SpecialHandler *handler) const {
+	auto it = find_if(_handlerPool.begin(), _handlerPool.end(), [=](const unique_ptr<SpecialHandler> &h) {
+		return h.get() == handler;
+	});
+	return size_t(it-_handlerPool.begin());
+}
+
+
+/** Returns the list of handlers subscribed to a given event. */
+SpecialManager::SubscriberList& SpecialManager::subscribers (SpecialHandler::Event event) {
+	switch (event) {
+		case SpecialHandler::EV_BEGIN_PAGE: return _beginPageSubscribers;
+		case SpecialHandler::EV_END_PAGE:   return _endPageSubscribers;
+		default: return _moveSubscribers;
+	}
+}
+
+
+/** Subscribes a registered handler to one or more DVI events. Afterwards, the
+ *  corresponding dviXXX functions of the handler are called when the events occur.
+ *  The subscribers of an event are notified in the order of their registration.
+ *  Handlers can subscribe and unsubscribe at any time, e.g. in order to get notified
+ *  about position changes only while an operation is in progress.
+ *  @param[in] handler handler to subscribe (calls for unregistered handlers are ignored)
+ *  @param[in] events bitwise or'ed SpecialHandler::Event values */
+void SpecialManager::subscribe (SpecialHandler *handler, unsigned events) {
+	size_t index = poolIndex(handler);
+	if (index == _handlerPool.size())  // handler not registered?
+		return;
+	for (auto event : {SpecialHandler::EV_BEGIN_PAGE, SpecialHandler::EV_END_PAGE, SpecialHandler::EV_MOVE}) {
+		SubscriberList &list = subscribers(event);
+		if ((events & event) && find(list.begin(), list.end(), handler) == list.end()) {
+			auto it = find_if(list.begin(), list.end(), [&](const SpecialHandler *subscriber) {
+				return poolIndex(subscriber) > index;
+			});
+			list.insert(it, handler);
+		}
+	}
+}
+
+
+/** Removes a handler from the subscribers of one or more DVI events.
+ *  @param[in] handler handler to unsubscribe
+ *  @param[in] events bitwise or'ed SpecialHandler::Event values */
+void SpecialManager::unsubscribe (SpecialHandler *handler, unsigned events) {
+	for (auto event : {SpecialHandler::EV_BEGIN_PAGE, SpecialHandler::EV_END_PAGE, SpecialHandler::EV_MOVE}) {
+		if (events & event) {
+			SubscriberList &list = subscribers(event);
+			list.erase(remove(list.begin(), list.end(), handler), list.end());
+		}
+	}
+}
+
+
 /** Looks for a handler responsible for a given special prefix.
  *  @param[in] prefix the special prefix, e.g. "color" or "em"
  *  @return in case of success: pointer to handler, 0 otherwise */
 SpecialHandler* SpecialManager::findHandlerByPrefix (const string &prefix) const {
-	auto it = _handlersByPrefix.find(prefix);
-	if (it != _handlersByPrefix.end())
-		return it->second;
+	if (const PrefixEntry *entry = findPrefixEntry(prefix.data(), prefix.length()))
+		return entry->second;
 	return nullptr;
 }
 
 
+/** Looks up the entry of a given special prefix in the sorted prefix table.
+ *  @param[in] prefix pointer to the first character of the prefix
+ *  @param[in] len number of characters of the prefix
+ *  @return in case of success: pointer to the entry, 0 otherwise */
+const SpecialManager::PrefixEntry* SpecialManager::findPrefixEntry (const char *prefix, size_t len) const {
+	auto it = lower_bound(_handlersByPrefix.begin(), _handlersByPrefix.end(), 0, [&](const PrefixEntry &entry, int) {
+		return entry.first.compare(0, string::npos, prefix, len) < 0;
+	});
+	if (it != _handlersByPrefix.end() && it->first.compare(0, string::npos, prefix, len) == 0)
+		return &(*it);
+	return nullptr;
+}
+
 /** Looks for a handler with a given name.
  *  @param[in] name name of handler to look for, e.g. "papersize"
  *  @return in case of success: pointer to handler, 0 otherwise */
@@ -122,24 +212,56 @@ SpecialHandler* SpecialManager::findHandlerByName (const string &name) const {
 }
 
 
-static string extract_prefix (istream &is) {
-	int c;
-	string prefix;
-	while (isalnum(c=is.get()))
-		prefix += char(c);
-	if (ispunct(c)) // also add separation character to identifying prefix
-		prefix += char(c);
-	if (prefix == "ps:" && is.peek() == ':')
-		prefix += char(is.get());
-	return prefix;
+/** Determines the prefix of a special and looks up the entry of the responsible handler.
+ *  The prefix consists of the leading alphanumeric characters and an optional
+ *  punctuation character, e.g. "color" or "em:". The character following the
+ *  alphanumeric characters is skipped in any case.
+ *  @param[in] special the special expression
+ *  @param[out] pos position of the first character following the prefix
+ *  @return in case of success: pointer to the prefix entry, 0 otherwise */
+const SpecialManager::PrefixEntry* SpecialManager::extractPrefix (const string &special, size_t &pos) const {
+	size_t len=0;
+	while (len < special.length() && isalnum(uint8_t(special[len])))
+		len++;
+	pos = len;
+	if (pos < special.length()) {
+		if (ispunct(uint8_t(special[pos]))) // also add separation character to identifying prefix
+			len++;
+		pos++;
+	}
+	if (len == 3 && special.compare(0, 3, "ps:") == 0 && pos < special.length() && special[pos] == ':')
+		len = ++pos;
+	return findPrefixEntry(special.data(), len);
+}
+
+
+/** Returns true if at least one of the registered handlers evaluates
+ *  specials while the DVI file is being preprocessed. */
+bool SpecialManager::needsPreprocessing () const {
+	for (const auto &handler : _handlerPool)
+		if (handler->needsPreprocessing())
+			return true;
+	return false;
+}
+
+
+/** Returns true if the given special must be passed to preprocess(), i.e.
+ *  if it's assigned to a handler that evaluates specials during preprocessing.
+ *  Since the function doesn't modify any data, it can be called concurrently.
+ *  @param[in] special the special expression */
+bool SpecialManager::needsPreprocessing (const string &special) const {
+	size_t pos;
+	const PrefixEntry *entry = extractPrefix(special, pos);
+	return entry && entry->second->needsPreprocessing();
 }
 
 
 void SpecialManager::preprocess (const string &special, SpecialActions &actions) const {
-	istringstream iss(special);
-	const string prefix = extract_prefix(iss);
-	if (SpecialHandler *handler = findHandlerByPrefix(prefix))
-		handler->preprocess(prefix, iss, actions);
+	size_t pos;
+	if (const PrefixEntry *entry = extractPrefix(special, pos)) {
+		CharInputReader ir(special.data()+pos, special.length()-pos);
+		entry->second->preprocessText(entry->first, ir, actions);
+	}
 }
 
 
@@ -150,12 +272,25 @@ void SpecialManager::preprocess (const string &special, SpecialActions &actions)
  *  @return true if the special could be processed successfully
  *  @throw SpecialException in case of errors during special processing */
 bool SpecialManager::process (const string &special, double dvi2bp, SpecialActions &actions) const {
-	istringstream iss(special);
-	const string prefix = extract_prefix(iss);
+	size_t pos;
 	bool success=false;
-	if (SpecialHandler *handler = findHandlerByPrefix(prefix)) {
+	if (const PrefixEntry *entry = extractPrefix(special, pos)) {
+		SpecialHandler *handler = entry->second;
+		Profiler::Scope scope("special", handler->name());
+		synchronize(actions, handler);
 		handler->setDviScaleFactor(dvi2bp);
-		success = handler->process(prefix, iss, actions);
+		CharInputReader ir(special.data()+pos, special.length()-pos);
+		// add the handler before processing the special because it might replace itself
+		// (see PsSpecialHandlerProxy), in which case unregisterHandler() removes it again
+		if (find(_unsyncedHandlers.begin(), _unsyncedHandlers.end(), handler) == _unsyncedHandlers.end())
+			_unsyncedHandlers.push_back(handler);
+		success = handler->processText(entry->first, ir, actions);
+		if (find(_unsyncedHandlers.begin(), _unsyncedHandlers.end(), handler) == _unsyncedHandlers.end()) {
+			// the special was processed by the replacement handler
+			if ((entry = extractPrefix(special, pos)) != nullptr
+				&& find(_unsyncedHandlers.begin(), _unsyncedHandlers.end(), entry->second) == _unsyncedHandlers.end())
+				_unsyncedHandlers.push_back(entry->second);
+		}
 	}
 	return success;
 }
@@ -168,23 +303,41 @@ void SpecialManager::notifyPreprocessingFinished () const {
 
 
 void SpecialManager::notifyBeginPage (unsigned pageno, SpecialActions &actions) const {
-	for (auto &handler : _handlerPool)
+	// iterate over a copy as the handlers may change their subscriptions
+	SubscriberList handlers = _beginPageSubscribers;
+	for (SpecialHandler *handler : handlers)
 		handler->dviBeginPage(pageno, actions);
 }
 
 
 void SpecialManager::notifyEndPage (unsigned pageno, SpecialActions &actions) const {
-	for (auto &handler : _handlerPool)
+	synchronize(actions);
+	SubscriberList handlers = _endPageSubscribers;
+	for (SpecialHandler *handler : handlers)
 		handler->dviEndPage(pageno, actions);
 }
 
 
-void SpecialManager::notifyPositionChange (double x, double y, SpecialActions &actions) const {
-	for (auto &handler : _handlerPool)
-		handler->dviMovedTo(x, y, actions);
+/** Tells the special handlers to finish all deferred operations because the
+ *  following DVI command or special might depend on their results. Only the
+ *  handlers that processed specials since their last synchronization are affected.
+ *  @param[in] actions actions the special handlers can perform
+ *  @param[in] excludedHandler handler that doesn't need to be synchronized */
+void SpecialManager::synchronize (SpecialActions &actions, const SpecialHandler *excludedHandler) const {
+	if (!_unsyncedHandlers.empty()) {
+		SubscriberList handlers;
+		handlers.swap(_unsyncedHandlers);
+		for (SpecialHandler *handler : handlers) {
+			if (handler == excludedHandler)
+				_unsyncedHandlers.push_back(handler);
+			else
+				handler->synchronize(actions);
+		}
+	}
 }
 
 
+
 void SpecialManager::writeHandlerInfo (ostream &os) const {
 	ios::fmtflags osflags(os.flags());
 	map<string,SpecialHandler*> sortmap;
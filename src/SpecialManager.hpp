@@ -25,7 +25,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "SpecialHandler.hpp"
 #include "utility.hpp"
@@ -35,7 +35,9 @@ class SpecialActions;
 class SpecialManager {
 	private:
 		using HandlerPool = std::vector<std::unique_ptr<SpecialHandler>>;
-		using HandlerMap = std::unordered_map<std::string,SpecialHandler*>;
+		using PrefixEntry = std::pair<std::string,SpecialHandler*>;
+		using HandlerMap = std::vector<PrefixEntry>;  ///< prefix/handler pairs sorted by prefix
+		using SubscriberList = std::vector<SpecialHandler*>;
 
 	public:
 		SpecialManager (const SpecialManager &) =delete;
@@ -53,22 +55,42 @@ class SpecialManager {
 		void registerHandlers (std::vector<std::unique_ptr<SpecialHandler>> &handlers, const char *ignorelist);
 		void unregisterHandler (SpecialHandler *handler);
 		void unregisterHandlers ();
+		bool needsPreprocessing () const;
+		bool needsPreprocessing (const std::string &special) const;
 		void preprocess (const std::string &special, SpecialActions &actions) const;
 		bool process (const std::string &special, double dvi2bp, SpecialActions &actions) const;
 		void notifyPreprocessingFinished () const;
 		void notifyBeginPage (unsigned pageno, SpecialActions &actions) const;
 		void notifyEndPage (unsigned pageno, SpecialActions &actions) const;
-		void notifyPositionChange (double x, double y, SpecialActions &actions) const;
+		void subscribe (SpecialHandler *handler, unsigned events);
+		void unsubscribe (SpecialHandler *handler, unsigned events);
+		bool trackingPosition () const {return !_moveSubscribers.empty();}
+
+		/** Notifies the handlers subscribed to SpecialHandler::EV_MOVE about a position change. */
+		void notifyPositionChange (double x, double y, SpecialActions &actions) const {
+			for (SpecialHandler *handler : _moveSubscribers)
+				handler->dviMovedTo(x, y, actions);
+		}
+
+		void synchronize (SpecialActions &actions, const SpecialHandler *excludedHandler=nullptr) const;
 		void writeHandlerInfo (std::ostream &os) const;
 		SpecialHandler* findHandlerByName (const std::string &name) const;
 
 	protected:
 		SpecialManager () =default;
 		SpecialHandler* findHandlerByPrefix (const std::string &prefix) const;
+		size_t poolIndex (const SpecialHandler *handler) const;
+		SubscriberList& subscribers (SpecialHandler::Event event);
+		const PrefixEntry* findPrefixEntry (const char *prefix, size_t len) const;
+		const PrefixEntry* extractPrefix (const std::string &special, size_t &pos) const;
 
 	private:
 		HandlerPool _handlerPool;      ///< stores pointers to all handlers
 		HandlerMap _handlersByPrefix;  ///< pointers to handlers for corresponding prefixes
+		SubscriberList _beginPageSubscribers;  ///< handlers to be notified at the beginning of a page
+		SubscriberList _endPageSubscribers;    ///< handlers to be notified at the end of a page
+		SubscriberList _moveSubscribers;       ///< handlers to be notified about position changes
+		mutable SubscriberList _unsyncedHandlers;  ///< handlers that processed specials since their last synchronization
 };
 
 #endif
@@ -112,11 +112,23 @@ string StreamReader::readString (HashFunction &hashfunc, bool finalZero) {
  *  @return the string read */
 string StreamReader::readString (int length) {
 	string str;
-	if (_is) {
+	readString(length, str);
+	return str;
+}
+
+
+/** Reads a string of a given length into an existing string object. Since the
+ *  memory already allocated by the string is reused, this function is
+ *  preferable if many strings are read one after another.
+ *  @param[in] length number of characters to read
+ *  @param[out] str the string read */
+void StreamReader::readString (int length, string &str) {
+	if (!_is)
+		str.clear();
+	else {
 		str.resize(max(0, length));
 		_is->read(&str[0], streamsize(str.length()));  // read 'length' bytes and append '\0'
 	}
-	return str;
 }
 
 
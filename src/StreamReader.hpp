@@ -43,6 +43,7 @@ class StreamReader {
 		std::string readString ();
 		std::string readString (HashFunction &hashfunc, bool finalZero=false);
 		std::string readString (int length);
+		void readString (int length, std::string &str);
 		std::string readString (int length, HashFunction &hashfunc);
 		std::vector<uint8_t> readBytes (int n);
 		std::vector<uint8_t> readBytes (int n, HashFunction &hash);
@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <cmath>
 #include <valarray>
 #include "TensorProductPatch.hpp"
 
@@ -180,6 +181,49 @@ GraphicsPath<double> TensorProductPatch::getBoundaryPath () const {
 }
 
 
+/** Checks whether the patch can be drawn exactly by a linear color gradient. This is the case
+ *  if the patch surface is a parallelogram that is uniformly parametrized by (u,v), and if the
+ *  vertex colors change along one parameter axis only. Since SVG interpolates gradient colors
+ *  in RGB space, only patches with RGB or gray colors are considered.
+ *  @param[out] matrix maps the unit square to the patch surface with the gradient running along the x-axis
+ *  @param[out] color1 color at the start of the gradient (x=0)
+ *  @param[out] color2 color at the end of the gradient (x=1)
+ *  @return true if the patch describes a linear gradient */
+bool TensorProductPatch::isLinearGradient (Matrix &matrix, Color &color1, Color &color2) const {
+	if (colorSpace() != Color::ColorSpace::RGB && colorSpace() != Color::ColorSpace::GRAY)
+		return false;
+	const DPair origin = _points[0][0];
+	const DPair uvec = _points[0][3]-origin;
+	const DPair vvec = _points[3][0]-origin;
+	const double eps = 1e-6*(uvec.length()+vvec.length());
+	if (abs(det(uvec, vvec)) < eps*eps)  // degenerated patch?
+		return false;
+	// all control points must be located on the grid of the uniformly subdivided parallelogram
+	for (int i=0; i < 4; i++) {
+		for (int j=0; j < 4; j++) {
+			DPair gridpoint = origin + uvec*(j/3.0) + vvec*(i/3.0);
+			if ((_points[i][j]-gridpoint).length() > eps)
+				return false;
+		}
+	}
+	DPair xvec, yvec;
+	if (_colors[0] == _colors[2] && _colors[1] == _colors[3]) {  // colors change along u only?
+		xvec = uvec, yvec = vvec;
+		color1 = _colors[0];
+		color2 = _colors[1];
+	}
+	else if (_colors[0] == _colors[1] && _colors[2] == _colors[3]) {  // colors change along v only?
+		xvec = vvec, yvec = uvec;
+		color1 = _colors[0];
+		color2 = _colors[2];
+	}
+	else
+		return false;
+	matrix = Matrix{xvec.x(), yvec.x(), origin.x(), xvec.y(), yvec.y(), origin.y()};
+	return true;
+}
+
+
 /** Computes the bicubically interpolated isoparametric Bézier curve P(u,t) that
  *  runs "vertically" from P(u,0) to P(u,1) through the patch P.
  *  @param[in] u "horizontal" parameter in the range from 0 to 1
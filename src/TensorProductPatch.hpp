@@ -26,6 +26,7 @@
 #include <vector>
 #include "Bezier.hpp"
 #include "Color.hpp"
+#include "Matrix.hpp"
 #include "MessageException.hpp"
 #include "Pair.hpp"
 #include "ShadingPatch.hpp"
@@ -51,6 +52,7 @@ class TensorProductPatch : public ShadingPatch {
 		CubicBezier verticalCurve (double u) const;
 		GraphicsPath<double> getBoundaryPath () const override;
 		void subpatch (double u1, double u2, double v1, double v2, TensorProductPatch &patch) const;
+		bool isLinearGradient (Matrix &matrix, Color &color1, Color &color2) const;
 		DPair blossomValue (double u1, double u2, double u3, double v1, double v2, double v3) const;
 		DPair blossomValue (double u[3], double v[3]) const {return blossomValue(u[0], u[1], u[2], v[0], v[1], v[2]);}
 		void approximate (int gridsize, bool overlap, double delta, Callback &callback) const override;
@@ -0,0 +1,102 @@
+/*************************************************************************
+** ThreadPool.cpp                                                       **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <algorithm>
+#include <system_error>
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+unsigned ThreadPool::MAX_THREADS = 0;
+
+static thread_local bool is_worker_thread = false;
+
+
+/** Creates a new pool of worker threads.
+ *  @param[in] numThreads number of threads to create (0: use default number).
+ *  If the number of threads is 1, no additional thread is started and all
+ *  tasks are processed in the calling thread. */
+ThreadPool::ThreadPool (unsigned numThreads) {
+	if (numThreads == 0)
+		numThreads = defaultNumThreads();
+	if (MAX_THREADS > 0)
+		numThreads = min(numThreads, MAX_THREADS);
+	if (numThreads > 1) {
+		_workers.reserve(numThreads);
+		try {
+			for (unsigned i=0; i < numThreads; i++)
+				_workers.emplace_back(&ThreadPool::run, this);
+		}
+		catch (system_error&) {
+			// if creating further threads fails, just use those started so far
+		}
+	}
+}
+
+
+/** Waits until all queued tasks have been processed and terminates the worker threads.
+ *  Afterwards, the messages written by the tasks are printed in the order the tasks
+ *  were enqueued. */
+ThreadPool::~ThreadPool () {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_all();
+	for (thread &worker : _workers)
+		worker.join();
+	if (!_workers.empty())
+		Message::flush();  // print the messages written by the tasks
+}
+
+
+/** Returns the number of threads used by default. */
+unsigned ThreadPool::defaultNumThreads () {
+	unsigned num = thread::hardware_concurrency();
+	if (MAX_THREADS > 0)
+		num = min(num, MAX_THREADS);
+	return max(num, 1u);
+}
+
+
+/** Returns true if the calling thread is a worker thread of a pool. Tasks can use this
+ *  to avoid creating nested pools that multiply the number of running threads. */
+bool ThreadPool::inWorkerThread () {
+	return is_worker_thread;
+}
+
+
+/** Main loop of the worker threads: fetches the next task from the queue
+ *  and processes it. */
+void ThreadPool::run () {
+	is_worker_thread = true;
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(_mutex);
+			_condition.wait(lock, [this]() {return _stop || !_tasks.empty();});
+			if (_tasks.empty())  // => _stop == true
+				return;
+			task = std::move(_tasks.front());
+			_tasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,88 @@
+/*************************************************************************
+** ThreadPool.hpp                                                       **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Message.hpp"
+
+/** Simple pool of worker threads processing queued tasks in FIFO order.
+ *  The results of the tasks are provided by std::future objects. Exceptions
+ *  thrown by a task are propagated to the caller of the corresponding future's
+ *  get() function. */
+class ThreadPool {
+	public:
+		explicit ThreadPool (unsigned numThreads=0);
+		ThreadPool (const ThreadPool &pool) =delete;
+		~ThreadPool ();
+		ThreadPool& operator = (const ThreadPool &pool) =delete;
+		unsigned numThreads () const {return unsigned(_workers.size());}
+		static unsigned defaultNumThreads ();
+		static bool inWorkerThread ();
+
+		/** Adds a task to the queue of the pool.
+		 *  @param[in] f function to be called by one of the worker threads
+		 *  @param[in] args arguments passed to f
+		 *  @return future providing the return value of f */
+		template <typename F, typename... Args>
+		std::future<typename std::result_of<F(Args...)>::type> enqueue (F &&f, Args&&... args) {
+			using ResultType = typename std::result_of<F(Args...)>::type;
+			auto task = std::make_shared<std::packaged_task<ResultType()>>(
+				std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+			std::future<ResultType> result = task->get_future();
+			if (_workers.empty())  // no worker threads available => process task immediately
+				(*task)();
+			else {
+				std::lock_guard<std::mutex> lock(_mutex);
+				// order the messages of the tasks by their creation
+				Message::OrderKey key = Message::childOrderKey(_numEnqueued++);
+				_tasks.emplace([task, key]() {
+					Message::setOrderKey(key);
+					(*task)();
+				});
+				_condition.notify_one();
+			}
+			return result;
+		}
+
+		static unsigned MAX_THREADS;  ///< maximal number of threads used per pool (0: number of hardware threads)
+
+	protected:
+		void run ();
+
+	private:
+		std::vector<std::thread> _workers;
+		std::queue<std::function<void()>> _tasks;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		bool _stop=false;
+		unsigned _numEnqueued=0;  ///< number of tasks added to the queue so far
+};
+
+#endif
@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <bitset>
 #include <cstring>
 #include <sstream>
@@ -113,6 +114,27 @@ void TpicSpecialHandler::drawLines (double ddist, SpecialActions &actions) {
 			elem = create_ellipse_element(p.x()+actions.getX(), p.y()+actions.getY(), _penwidth/2.0, _penwidth/2.0);
 			actions.embed(p, _penwidth/2.0);
 		}
+		else if (SVGTree::MERGE_LINES && (_points.size() == 2 || (_grayLevel < 0 && _points.front() != _points.back()))
+				&& size_t(count(_points.begin(), _points.end(), _points.front())) < _points.size()) {
+			// draw polyline as subpath of a path element shared with adjacent lines of same style
+			// (degenerated polylines are excluded as zero-length subpaths don't get round caps)
+			GraphicsPath<double> path;
+			for (const DPair &p : _points) {
+				DPair q(p.x()+actions.getX(), p.y()+actions.getY());
+				if (path.empty())
+					path.moveto(q);
+				else
+					path.lineto(q);
+				actions.embed(q);
+			}
+			ostringstream oss;
+			path.writeSVG(oss, SVGTree::RELATIVE_PATH_CMDS);
+			elem = util::make_unique<SVGElement>("path");
+			elem->setNoFillColor();
+			elem->setStrokeLineCap(SVGElement::LC_ROUND);
+			add_stroke_attribs(elem.get(), _penwidth, Color::BLACK, ddist);
+			actions.svgTree().appendPathToPage(std::move(elem), oss.str());
+		}
 		else {
 			if (_points.size() == 2 || (_grayLevel < 0 && _points.front() != _points.back())) {
 				elem = util::make_unique<SVGElement>("polyline");
@@ -138,7 +160,8 @@ void TpicSpecialHandler::drawLines (double ddist, SpecialActions &actions) {
 			elem->setPoints(points);
 			add_stroke_attribs(elem.get(), _penwidth, Color::BLACK, ddist);
 		}
-		actions.svgTree().appendToPage(std::move(elem));
+		if (elem)
+			actions.svgTree().appendToPage(std::move(elem));
 	}
 	reset();
 }
@@ -269,12 +292,27 @@ constexpr int cmd_id (const char *cmd) {
 
 
 bool TpicSpecialHandler::process (const string &prefix, istream &is, SpecialActions &actions) {
+	StreamInputBuffer ib(is);
+	BufferInputReader ir(ib);
+	return processSpecial(prefix, ir, actions);
+}
+
+
+bool TpicSpecialHandler::processText (const string &prefix, CharInputReader &ir, SpecialActions &actions) {
+	return processSpecial(prefix, ir, actions);
+}
+
+
+/** Evaluates a TPIC special statement.
+ *  @param[in] prefix the TPIC command
+ *  @param[in] ir reader providing the parameters of the command
+ *  @param[in] actions actions the special handler can perform
+ *  @return true if the command is known */
+bool TpicSpecialHandler::processSpecial (const string &prefix, InputReader &ir, SpecialActions &actions) {
 	if (prefix.length() != 2)
 		return false;
 	_dviColor = actions.getFillColor();
 	const double mi2bp=0.072; // factor for milli-inch to PS points
-	StreamInputBuffer ib(is);
-	BufferInputReader ir(ib);
 	switch (cmd_id(prefix.c_str())) {
 		case cmd_id("pn"): // set pen width in milli-inches
 			_penwidth = max(0.0, ir.getDouble()*mi2bp);
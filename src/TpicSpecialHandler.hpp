@@ -25,20 +25,25 @@
 #include "Pair.hpp"
 #include "SpecialHandler.hpp"
 
+class InputReader;
+
 class TpicSpecialHandler : public SpecialHandler {
 	public:
 		TpicSpecialHandler ();
 		bool process (const std::string &prefix, std::istream &is, SpecialActions &actions) override;
+		bool processText (const std::string &prefix, CharInputReader &ir, SpecialActions &actions) override;
 		const char* info () const override {return "TPIC specials";}
 		const char* name () const override {return handlerName();}
 		static const char* handlerName ()  {return "tpic";}
 		std::vector<const char*> prefixes () const override;
+		unsigned subscribedEvents () const override {return EV_END_PAGE;}
 		double penwidth () const  {return _penwidth;}
 		double grayLevel () const {return _grayLevel;}
 		Color fillColor (bool grayOnly) const;
 
 	protected:
 		void dviEndPage (unsigned pageno, SpecialActions &actions) override;
+		bool processSpecial (const std::string &prefix, InputReader &ir, SpecialActions &actions);
 		void reset ();
 		void drawLines (double ddist, SpecialActions &actions);
 		void drawSplines (double ddist, SpecialActions &actions);
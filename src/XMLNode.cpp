@@ -20,10 +20,13 @@
 
 #include <algorithm>
 #include <fstream>
+#include <future>
+#include <iterator>
 #include <list>
 #include <map>
 #include <sstream>
 #include "FileSystem.hpp"
+#include "ThreadPool.hpp"
 #include "utility.hpp"
 #include "XMLNode.hpp"
 #include "XMLString.hpp"
@@ -376,6 +379,79 @@ XMLElement* XMLElement::getFirstDescendant (const char *name, const char *attrNa
 }
 
 
+/** Returns the base64-encoded contents of a file preceded by a newline.
+ *  If the file can't be read, the returned string is empty. */
+static string base64_encode_file (const string &fname) {
+	string encoded;
+	ifstream ifs(fname, ios::binary);
+	if (ifs) {
+		auto size = FileSystem::filesize(fname);
+		encoded.reserve(size_t(size+2)/3*4 + size/150 + 2);
+		encoded.push_back('\n');
+		util::base64_copy(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>(), back_inserter(encoded), 200);
+	}
+	return encoded;
+}
+
+
+/** Embeds the contents of all files referenced by deferred attributes of this element
+ *  and its descendants. Deferred attributes are marked by a leading '@' (or '@@') and
+ *  contain a value of the form "...base64,filename". The referenced files are
+ *  base64-encoded concurrently, and the resulting data replaces the filenames in the
+ *  attribute values. Afterwards, the files are removed unless they are referenced by
+ *  an '@@' attribute only or if XMLNode::KEEP_ENCODED_FILES is set. Calling this function
+ *  prior to writing the element gives the same output as processing the deferred
+ *  attributes sequentially in XMLElement::write(). */
+void XMLElement::embedDeferredFiles () {
+	struct DeferredFile {
+		string data;  // base64-encoded file contents
+		int refcount=0;  // number of attributes referencing the file
+		bool remove=false;
+	};
+	vector<XMLElement*> elements{this};
+	getDescendants(nullptr, nullptr, elements);
+	vector<Attribute*> attributes;
+	map<string, DeferredFile> files;  // filename -> file data
+	for (XMLElement *elem : elements) {
+		for (Attribute &attrib : elem->_attributes) {
+			if (attrib.name.front() == '@') {
+				bool keep = (attrib.name.size() > 1 && attrib.name[1] == '@');
+				auto pos = attrib.value.find("base64,");
+				if (pos != string::npos) {
+					DeferredFile &file = files[attrib.value.substr(pos+7)];
+					file.refcount++;
+					file.remove = file.remove || (!KEEP_ENCODED_FILES && !keep);
+				}
+				attrib.name.erase(0, keep ? 2 : 1);
+				attributes.push_back(&attrib);
+			}
+		}
+	}
+	if (files.empty())
+		return;
+	vector<future<string>> results;
+	results.reserve(files.size());
+	ThreadPool pool(min(unsigned(files.size()), ThreadPool::defaultNumThreads()));
+	for (const auto &entry : files)
+		results.emplace_back(pool.enqueue(base64_encode_file, entry.first));
+	auto resultIt = results.begin();
+	for (auto &entry : files) {
+		entry.second.data = (resultIt++)->get();
+		if (entry.second.remove && !entry.second.data.empty())
+			FileSystem::remove(entry.first);
+	}
+	for (Attribute *attrib : attributes) {
+		auto pos = attrib->value.find("base64,");
+		if (pos != string::npos) {
+			auto it = files.find(attrib->value.substr(pos+7));
+			attrib->value.replace(pos+7, string::npos, it->second.data);
+			if (--it->second.refcount == 0)
+				files.erase(it);  // release the data as soon as it's no longer needed
+		}
+	}
+}
+
+
 ostream& XMLElement::write (ostream &os) const {
 	os << '<' << _name;
 	for (const auto &attrib : _attributes) {
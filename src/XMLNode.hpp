@@ -149,6 +149,7 @@ class XMLElement : public XMLNode {
 		XMLNode* lastChild () const {return _lastChild;}
 		std::ostream& write (std::ostream &os) const override;
 		bool empty (bool ignoreWhitespace=false) const;
+		void embedDeferredFiles ();
 		Attributes& attributes () {return _attributes;}
 		const Attributes& attributes () const {return _attributes;}
 		XMLNodeIterator begin () {return XMLNodeIterator(_firstChild.get());}
@@ -180,8 +180,7 @@ XMLElement* XMLParser::finishPushContext (unique_ptr<XMLElement> elem) {
 /** Processes an opening element tag.
  *  @param[in] tag tag without leading and trailing angle brackets */
 XMLElement* XMLParser::openElement (const string &tag) {
-	StringInputBuffer ib(tag);
-	BufferInputReader ir(ib);
+	CharInputReader ir(tag);
 	string name = ir.getString("/ \t\n\r");
 	ir.skipSpace();
 	unique_ptr<XMLElement> elemNode{createElementPtr(name)};
@@ -209,8 +208,7 @@ XMLElement* XMLParser::openElement (const string &tag) {
 /** Processes a closing element tag.
  *  @param[in] tag tag without leading and trailing angle brackets */
 void XMLParser::closeElement (const string &tag) {
-	StringInputBuffer ib(tag);
-	BufferInputReader ir(ib);
+	CharInputReader ir(tag);
 	string name = ir.getString(" \t\n\r");
 	ir.skipSpace();
 	if (ir.peek() >= 0)
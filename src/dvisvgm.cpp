@@ -30,6 +30,7 @@
 #include "CommandLine.hpp"
 #include "DVIToSVG.hpp"
 #include "DVIToSVGActions.hpp"
+#include "EventStream.hpp"
 #include "EPSToSVG.hpp"
 #include "FileFinder.hpp"
 #include "FileSystem.hpp"
@@ -38,10 +39,13 @@
 #include "Ghostscript.hpp"
 #include "HashFunction.hpp"
 #include "HyperlinkManager.hpp"
+#include "MemoryMonitor.hpp"
 #include "Message.hpp"
+#include "PageBudget.hpp"
 #include "PageSize.hpp"
 #include "PDFHandler.hpp"
 #include "PDFToSVG.hpp"
+#include "Profiler.hpp"
 #include "PSInterpreter.hpp"
 #include "PsSpecialHandler.hpp"
 #include "SignalHandler.hpp"
@@ -344,6 +348,23 @@ static void set_variables (const CommandLine &cmdline) {
 		DVIToSVG::COMPUTE_PROGRESS = true;
 		SpecialActions::PROGRESSBAR_DELAY = cmdline.progressOpt.value();
 	}
+	if ((Profiler::ENABLED = cmdline.statsOpt.given())) {
+		if (cmdline.statsOpt.value() != "text" && cmdline.statsOpt.value() != "json")
+			throw CL::CommandLineException("unknown statistics format '"+cmdline.statsOpt.value()+"' (supported formats: text, json)");
+		Profiler::instance().reset();
+	}
+	if (cmdline.maxPageMemoryOpt.given()) {
+		if (MemoryMonitor::available())
+			MemoryMonitor::setPageLimit(uint64_t(cmdline.maxPageMemoryOpt.value()) << 20);
+		else
+			Message::wstream(true) << "option --max-page-memory is not supported on this platform\n";
+	}
+	MemoryMonitor::ENABLED = MemoryMonitor::available() && (Profiler::ENABLED || cmdline.maxPageMemoryOpt.given());
+	if (cmdline.pageTimeoutOpt.given()) {
+		if (cmdline.pageTimeoutOpt.value() <= 0)
+			throw CL::CommandLineException("page timeout must be a positive number");
+		PageBudget::setTimeout(cmdline.pageTimeoutOpt.value());
+	}
 	Color::SUPPRESS_COLOR_NAMES = !cmdline.colornamesOpt.given();
 	if ((SVGElement::USE_CURRENTCOLOR = cmdline.currentcolorOpt.given())) {
 		Color color;
@@ -366,6 +387,8 @@ static void set_variables (const CommandLine &cmdline) {
 	SVGTree::ZOOM_FACTOR = cmdline.zoomOpt.value();
 	SVGTree::RELATIVE_PATH_CMDS = cmdline.relativeOpt.given();
 	SVGTree::MERGE_CHARS = !cmdline.noMergeOpt.given();
+	SVGTree::MERGE_LINES = cmdline.mergeLinesOpt.given();
+	DVIToSVGActions::MERGE_RULES = cmdline.mergeRulesOpt.given();
 	SVGTree::ADD_COMMENTS = cmdline.commentsOpt.given();
 	DVIToSVG::TRACE_MODE = cmdline.traceAllOpt.given() ? (cmdline.traceAllOpt.value() ? 'a' : 'm') : 0;
 	Message::LEVEL = cmdline.verbosityOpt.value();
@@ -379,6 +402,9 @@ static void set_variables (const CommandLine &cmdline) {
 	PsSpecialHandler::SHADING_SEGMENT_SIZE = max(1, cmdline.gradSegmentsOpt.value());
 	PsSpecialHandler::SHADING_SIMPLIFY_DELTA = cmdline.gradSimplifyOpt.value();
 	PsSpecialHandler::BITMAP_FORMAT = util::tolower(cmdline.bitmapFormatOpt.value());
+#ifndef DISABLE_WOFF
+	ttf::TTFWriter::COMPRESSION_LEVEL = max(0, min(11, cmdline.fontCompressionOpt.value()));
+#endif
 #ifdef TTFDEBUG
 	ttf::TTFWriter::CREATE_PS_GLYPH_OUTLINES = cmdline.debugGlyphsOpt.given();
 #endif
@@ -427,6 +453,8 @@ static void convert_file (size_t fnameIndex, const CommandLine &cmdline) {
 
 	double start_time = System::time();
 	set_variables(cmdline);
+	if (EventStream::enabled())
+		EventStream::instance().write(EventStream::Event("file-started").add("file", srcin.getMessageFileName()));
 	SVGOutput out(cmdline.stdoutOpt.given() ? "" : srcin.getFileName(),
 					  cmdline.outputOpt.value(),
 					  cmdline.zipOpt.given() ? cmdline.zipOpt.value() : 0);
@@ -457,6 +485,14 @@ static void convert_file (size_t fnameIndex, const CommandLine &cmdline) {
 			timer_message(start_time, &pageinfo);
 		}
 	}
+	if (Profiler::ENABLED)
+		Profiler::instance().writeReport(cerr, cmdline.statsOpt.value() == "json");
+	if (EventStream::enabled()) {
+		EventStream::instance().write(EventStream::Event("file-finished")
+			.add("file", srcin.getMessageFileName())
+			.add("pages", pageinfo.first)
+			.add("duration", System::time()-start_time));
+	}
 }
 
 
@@ -486,6 +522,8 @@ int main (int argc, char *argv[]) {
 		if (!set_cache_dir(cmdline) || !set_temp_dir(cmdline))
 			return 0;
 		check_bbox(cmdline.bboxOpt.value());
+		if (cmdline.eventsOpt.given() && !EventStream::instance().open(cmdline.eventsOpt.value()))
+			throw MessageException("can't open event stream '"+cmdline.eventsOpt.value()+"'");
 		if (!HyperlinkManager::setLinkMarker(cmdline.linkmarkOpt.value()))
 			Message::wstream(true) << "invalid argument '"+cmdline.linkmarkOpt.value()+"' supplied for option --linkmark\n";
 		if (cmdline.stdinOpt.given() || cmdline.singleDashGiven()) {
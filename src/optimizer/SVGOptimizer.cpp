@@ -23,6 +23,7 @@
 #include <map>
 #include <set>
 #include "SVGOptimizer.hpp"
+#include "../Profiler.hpp"
 #include "../SVGTree.hpp"
 
 #include "AttributeExtractor.hpp"
@@ -84,8 +85,10 @@ void SVGOptimizer::execute () {
 	// execute optimizer modules
 	for (const string &name: names) {
 		if (removedNames.find(name) == removedNames.end()) {
-			if (OptimizerModule *module = getModule(name))
+			if (OptimizerModule *module = getModule(name)) {
+				Profiler::Scope scope("optimizer", name.c_str());
 				module->execute(_svg->defsNode(), _svg->pageNode());
+			}
 		}
 	}
 }
@@ -71,96 +71,116 @@ const char *PSInterpreter::PSDEFS =
 "wapcolors}bind def @SD/clip{:clip @GD/@nulldev get not{0 1(newpath)prcmd prpat"
 "h 0(clip)prcmd}if}put @SD/eoclip{:eoclip @GD/@nulldev get not{0 1(newpath)prcm"
 "d prpath 0(eoclip)prcmd}if}put @SD/shfill{begin currentdict/ShadingType known "
-"currentdict/ColorSpace known and currentdict/DataSource known and currentdict/"
-"Function known not and ShadingType 4 ge{DataSource type/arraytype eq{<</Device"
-"Gray 1/DeviceRGB 3/DeviceCMYK 4/bgknown currentdict/Background known/bbknown c"
-"urrentdict/BBox known>>begin currentdict ColorSpace known{ShadingType ColorSpa"
-"ce load bgknown{1 Background aload pop}{0}ifelse bbknown{1 BBox aload pop}{0}i"
-"felse ShadingType 5 eq{VerticesPerRow}if DataSource aload length 4 add bgknown"
-"{ColorSpace load add}if bbknown{4 add}if ShadingType 5 eq{1 add}if(shfill)prcm"
-"d}if end}if}if end}put @SD/image{dup type/dicttype eq{dup}{<</Width 6 index/He"
-"ight 7 index/colorimg false>>}ifelse @execimg}put @SD/colorimage{<<2 index{/Wi"
-"dth 2 index 8 add index/Height 4 index 9 add index}{/Width 8 index/Height 9 in"
-"dex}ifelse/colorimg true>>@execimg}put/@imgbase(./)def/@imgdevice(jpeg)def/@ex"
-"ecimg{@GD/@imgcnt 2 copy .knownget{1 add}{1}ifelse put begin<</imgid @GD/@imgc"
-"nt get/ispng @imgdevice 0 3 getinterval(png)eq dup/suffix exch{(.png)}{(.jpg)}"
-"ifelse/colorimg currentdict/colorimg .knownget dup{pop}if/colordev 1 index cur"
-"rentcolorspace dup length 1 ne exch 0 get/DeviceGray ne or or>>begin @imgdevic"
-"e(png)ne @imgdevice(jpeg)ne and{@imgdevice cvn}{colordev{ispng{/png16m}{/jpeg}"
-"ifelse}{ispng{/pnggray}{/jpeggray}ifelse}ifelse}ifelse devicedict exch known{:"
-"gsave matrix currentmatrix/currentcolorspace sysexec<</OutputDevice @imgdevice"
-"/OutputFile @imgbase imgid 20 string cvs strconcat suffix strconcat/PageSize[W"
-"idth Height]/UseFastColor true ispng{@imgdevice(pngmonod)eq{/MinFeatureSize wh"
-"ere{pop/MinFeatureSize MinFeatureSize}if}if}{/JPEGQ where{pop/JPEGQ JPEGQ}if}i"
-"felse>>:setpagedevice/setcolorspace sysexec/setmatrix sysexec[Width 0 0 Height"
-" neg 0 Height]/setmatrix sysexec colorimg{:colorimage}{:image}ifelse/copypage "
-"sysexec<</OutputDevice @imgdevice/OutputFile()>>:setpagedevice :grestore imgid"
-" Width Height 3(image)prcmd}{pop colorimg{:colorimage}{:image}ifelse}ifelse en"
-"d end}def/@rect{4 -2 roll moveto exch dup 0 rlineto exch 0 exch rlineto neg 0 "
-"rlineto closepath}bind def/@rectcc{4 -2 roll moveto 2 copy 0 lt exch 0 lt xor{"
-"dup 0 exch rlineto exch 0 rlineto neg 0 exch rlineto}{exch dup 0 rlineto exch "
-"0 exch rlineto neg 0 rlineto}ifelse closepath}bind def @SD/rectclip{:newpath d"
-"up type/arraytype eq{aload length 4 idiv{@rectcc}repeat}{@rectcc}ifelse clip :"
-"newpath}put @SD/rectfill{:gsave :newpath dup type/arraytype eq{aload length 4 "
-"idiv{@rectcc}repeat}{@rectcc}ifelse fill :grestore}put @SD/rectstroke{gsave :n"
-"ewpath dup type/arraytype eq{aload length 4 idiv{@rect}repeat}{@rect}ifelse st"
-"roke grestore}put false setglobal @SD readonly pop/initclip 0 defpr/clippath 0"
-" defpr/sysexec{@SD exch get exec}def/adddot{dup length 1 add string dup 0 46 p"
-"ut dup 3 -1 roll 1 exch putinterval}def/setlinewidth{dup/setlinewidth sysexec "
-"1(setlinewidth)prcmd}def/setlinecap 1 defpr/setlinejoin 1 defpr/setmiterlimit "
-"1 defpr/setdash{mark 3 1 roll 2 copy/setdash sysexec exch aload length 1 add -"
-"1 roll counttomark(setdash)prcmd pop}def/@setpagedevice{pop<<>>:setpagedevice "
-"matrix setmatrix newpath 0(setpagedevice)prcmd}def/@checknulldev{@GD/@nulldev "
-"get{currentpagedevice maxlength 0 ne{@GD/@nulldev false put 0 1(setnulldevice)"
-"prcmd}if}if}def/prcolor{currentcolorspace @setcolorspace currentrgbcolor 3(set"
-"rgbcolor)prcmd}def/printgstate{@dodraw @GD/@nulldev get not and{matrix current"
-"matrix aload pop 6(setmatrix)prcmd applyscalevals currentlinewidth 1(setlinewi"
-"dth)prcmd currentlinecap 1(setlinecap)prcmd currentlinejoin 1(setlinejoin)prcm"
-"d currentmiterlimit 1(setmiterlimit)prcmd revision dup 952 lt{pop}{.currentble"
-"ndmode .setblendmode 952 eq{.currentopacityalpha .setopacityalpha .currentshap"
-"ealpha .setshapealpha}{.currentalphaisshape{1}{0}ifelse 1(setalphaisshape)prcm"
-"d .currentstrokeconstantalpha 1(setstrokeconstantalpha)prcmd .currentfillconst"
-"antalpha 1(setfillconstantalpha)prcmd}ifelse}ifelse prcolor currentdash mark 3"
-" 1 roll exch aload length 1 add -1 roll counttomark(setdash)prcmd pop}if}def/s"
-"trconcat{exch dup length 2 index length add string dup dup 4 2 roll copy lengt"
-"h 4 -1 roll putinterval}def/setgstate{/setgstate sysexec printgstate}def/save{"
-"@UD begin/@saveID vmstatus pop pop def end :save @saveID 1(save)prcmd}def/rest"
-"ore{:restore @checknulldev printgstate @UD/@saveID known{@UD begin @saveID end"
-"}{0}ifelse 1(restore)prcmd}def/gsave 0 defpr/grestore{:grestore @checknulldev "
-"printgstate 0(grestore)prcmd}def/grestoreall{:grestoreall @checknulldev setsta"
-"te 0(grestoreall)prcmd}def/rotate{dup type/arraytype ne @dodraw and{dup 1(rota"
-"te)prcmd}if/rotate sysexec applyscalevals}def/scale{dup type/arraytype ne @dod"
-"raw and{2 copy 2(scale)prcmd}if/scale sysexec applyscalevals}def/translate{dup"
-" type/arraytype ne @dodraw and{2 copy 2(translate)prcmd}if/translate sysexec}d"
-"ef/setmatrix{dup/setmatrix sysexec @dodraw{aload pop 6(setmatrix)prcmd applysc"
-"alevals}{pop}ifelse}def/initmatrix{matrix setmatrix}def/concat{matrix currentm"
-"atrix matrix concatmatrix setmatrix}def/makepattern{gsave<</mx 3 -1 roll>>begi"
-"n<</XUID[1000000 @patcnt]>>copy mx/makepattern sysexec dup begin PatternType 2"
-" lt{PatternType @patcnt BBox aload pop XStep YStep PaintType mx aload pop 15(m"
-"akepattern)prcmd :newpath matrix setmatrix dup PaintProc 0 1(makepattern)prcmd"
-" @GD/@patcnt @patcnt 1 add put}if end end grestore}def/setpattern{dup begin Pa"
-"tternType end 1 eq{begin PaintType 1 eq{XUID aload pop exch pop 1}{:gsave[curr"
-"entcolorspace aload length -1 roll pop]/setcolorspace sysexec/setcolor sysexec"
-" XUID aload pop exch pop currentrgbcolor :grestore 4}ifelse(setpattern)prcmd c"
-"urrentcolorspace 0 get/Pattern ne{[/Pattern currentcolorspace]/setcolorspace s"
-"ysexec}if currentcolorspace @setcolorspace end}{/setpattern sysexec}ifelse}def"
-"/setcolor{dup type/dicttype eq{setpattern}{/setcolor sysexec/currentrgbcolor s"
-"ysexec setrgbcolor}ifelse}def/setcolorspace{dup/setcolorspace sysexec @setcolo"
-"rspace}def/@setcolorspace{dup type/arraytype eq{0 get}if/Pattern eq{1}{0}ifels"
-"e 1(setcolorspace)prcmd}def/setgray 1 defpr/setcmykcolor 4 defpr/sethsbcolor 3"
-" defpr/setrgbcolor 3 defpr/.setalphaisshape{@SD/.setalphaisshape known{dup/.se"
-"talphaisshape sysexec}if{1}{0}ifelse 1(setalphaisshape)prcmd}bind def/.setfill"
-"constantalpha{@SD/.setfillconstantalpha known{dup/.setfillconstantalpha sysexe"
-"c}if 1(setfillconstantalpha)prcmd}bind def/.setstrokeconstantalpha{@SD/.setstr"
-"okeconstantalpha known{dup/.setstrokeconstantalpha sysexec}if 1(setstrokeconst"
-"antalpha)prcmd}bind def/.setopacityalpha{false .setalphaisshape dup .setfillco"
-"nstantalpha .setstrokeconstantalpha}bind def/.setshapealpha{true .setalphaissh"
-"ape dup .setfillconstantalpha .setstrokeconstantalpha}bind def/.setblendmode{d"
-"up/.setblendmode sysexec<</Normal 0/Compatible 0/Multiply 1/Screen 2/Overlay 3"
-"/SoftLight 4/HardLight 5/ColorDodge 6/ColorBurn 7/Darken 8/Lighten 9/Differenc"
-"e 10/Exclusion 11/Hue 12/Saturation 13/Color 14/Luminosity 15/CompatibleOverpr"
-"int 16>>exch get 1(setblendmode)prcmd}def/@pdfpagecount{(r)file runpdfbegin pd"
-"fpagecount runpdfend}def/@pdfpagebox{(r)file runpdfbegin dup dup 1 lt exch pdf"
-"pagecount gt or{pop}{pdfgetpage/MediaBox pget pop aload pop}ifelse runpdfend}d"
-"ef DELAYBIND{.bindnow}if ";
+"currentdict/ColorSpace known and{ShadingType 4 ge{currentdict/DataSource known"
+" currentdict/Function known not and{DataSource type/arraytype eq{<</DeviceGray"
+" 1/DeviceRGB 3/DeviceCMYK 4/bgknown currentdict/Background known/bbknown curre"
+"ntdict/BBox known>>begin currentdict ColorSpace known{ShadingType ColorSpace l"
+"oad bgknown{1 Background aload pop}{0}ifelse bbknown{1 BBox aload pop}{0}ifels"
+"e ShadingType 5 eq{VerticesPerRow}if DataSource aload length 4 add bgknown{Col"
+"orSpace load add}if bbknown{4 add}if ShadingType 5 eq{1 add}if(shfill)prcmd}if"
+" end}if}if}{ShadingType 2 eq ShadingType 3 eq or currentdict/Coords known and "
+"currentdict/Function known and{@shgrad}if}ifelse}if end}put @SD/image{dup type"
+"/dicttype eq{dup}{<</Width 6 index/Height 7 index/colorimg false>>}ifelse @exe"
+"cimg}put @SD/colorimage{<<2 index{/Width 2 index 8 add index/Height 4 index 9 "
+"add index}{/Width 8 index/Height 9 index}ifelse/colorimg true>>@execimg}put/@i"
+"mgbase(./)def/@imgdevice(jpeg)def/@execimg{@GD/@imgcnt 2 copy .knownget{1 add}"
+"{1}ifelse put begin<</imgid @GD/@imgcnt get/ispng @imgdevice 0 3 getinterval(p"
+"ng)eq dup/suffix exch{(.png)}{(.jpg)}ifelse/colorimg currentdict/colorimg .kno"
+"wnget dup{pop}if/colordev 1 index currentcolorspace dup length 1 ne exch 0 get"
+"/DeviceGray ne or or>>begin @imgdevice(png)ne @imgdevice(jpeg)ne and{@imgdevic"
+"e cvn}{colordev{ispng{/png16m}{/jpeg}ifelse}{ispng{/pnggray}{/jpeggray}ifelse}"
+"ifelse}ifelse devicedict exch known{:gsave matrix currentmatrix/currentcolorsp"
+"ace sysexec<</OutputDevice @imgdevice/OutputFile @imgbase imgid 20 string cvs "
+"strconcat suffix strconcat/PageSize[Width Height]/UseFastColor true ispng{@img"
+"device(pngmonod)eq{/MinFeatureSize where{pop/MinFeatureSize MinFeatureSize}if}"
+"if}{/JPEGQ where{pop/JPEGQ JPEGQ}if}ifelse>>:setpagedevice/setcolorspace sysex"
+"ec/setmatrix sysexec[Width 0 0 Height neg 0 Height]/setmatrix sysexec colorimg"
+"{:colorimage}{:image}ifelse/copypage sysexec<</OutputDevice @imgdevice/OutputF"
+"ile()>>:setpagedevice :grestore imgid Width Height 3(image)prcmd}{pop colorimg"
+"{:colorimage}{:image}ifelse}ifelse end end}def/@shgrad{Function dup type/dictt"
+"ype eq{@shgradok}{pop false}ifelse{<</DeviceGray 1/DeviceRGB 3/DeviceCMYK 4/bg"
+"known currentdict/Background known/bbknown currentdict/BBox known/ext currentd"
+"ict/Extend known{Extend}{[false false]}ifelse/dom currentdict/Domain known{Dom"
+"ain}{[0 1]}ifelse>>begin currentdict ColorSpace known{mark ShadingType ColorSp"
+"ace load bgknown{1 Background aload pop}{0}ifelse bbknown{1 BBox aload pop}{0}"
+"ifelse Coords aload pop ext{{1}{0}ifelse}forall dom aload pop Function @shgrad"
+"fns counttomark(shfill)prcmd pop}if end}if}def/@shgradok{dup/FunctionType get "
+"dup 2 eq{pop pop true}{3 eq{/Functions get true exch{/FunctionType get 2 eq an"
+"d}forall}{pop false}ifelse}ifelse}def/@shgradfn{5 -1 roll begin N currentdict/"
+"C0 known{C0}{[0]}ifelse aload pop currentdict/C1 known{C1}{[1]}ifelse aload po"
+"p end}def/@shgradfns{dup/FunctionType get 2 eq{1 exch dup/Domain get aload pop"
+" 2 copy @shgradfn}{10 dict begin/F exch def/B[F/Domain get 0 get F/Bounds get "
+"aload pop F/Domain get 1 get]def F/Functions get length 0 1 2 index 1 sub{/I e"
+"xch def F/Functions get I get B I get B I 1 add get F/Encode get I 2 mul get F"
+"/Encode get I 2 mul 1 add get @shgradfn}for end}ifelse}def/@rect{4 -2 roll mov"
+"eto exch dup 0 rlineto exch 0 exch rlineto neg 0 rlineto closepath}bind def/@r"
+"ectcc{4 -2 roll moveto 2 copy 0 lt exch 0 lt xor{dup 0 exch rlineto exch 0 rli"
+"neto neg 0 exch rlineto}{exch dup 0 rlineto exch 0 exch rlineto neg 0 rlineto}"
+"ifelse closepath}bind def @SD/rectclip{:newpath dup type/arraytype eq{aload le"
+"ngth 4 idiv{@rectcc}repeat}{@rectcc}ifelse clip :newpath}put @SD/rectfill{:gsa"
+"ve :newpath dup type/arraytype eq{aload length 4 idiv{@rectcc}repeat}{@rectcc}"
+"ifelse fill :grestore}put @SD/rectstroke{gsave :newpath dup type/arraytype eq{"
+"aload length 4 idiv{@rect}repeat}{@rect}ifelse stroke grestore}put false setgl"
+"obal @SD readonly pop/initclip 0 defpr/clippath 0 defpr/sysexec{@SD exch get e"
+"xec}def/adddot{dup length 1 add string dup 0 46 put dup 3 -1 roll 1 exch putin"
+"terval}def/setlinewidth{dup/setlinewidth sysexec 1(setlinewidth)prcmd}def/setl"
+"inecap 1 defpr/setlinejoin 1 defpr/setmiterlimit 1 defpr/setdash{mark 3 1 roll"
+" 2 copy/setdash sysexec exch aload length 1 add -1 roll counttomark(setdash)pr"
+"cmd pop}def/@setpagedevice{pop<<>>:setpagedevice matrix setmatrix newpath 0(se"
+"tpagedevice)prcmd}def/@checknulldev{@GD/@nulldev get{currentpagedevice maxleng"
+"th 0 ne{@GD/@nulldev false put 0 1(setnulldevice)prcmd}if}if}def/prcolor{curre"
+"ntcolorspace @setcolorspace currentrgbcolor 3(setrgbcolor)prcmd}def/printgstat"
+"e{@dodraw @GD/@nulldev get not and{matrix currentmatrix aload pop 6(setmatrix)"
+"prcmd applyscalevals currentlinewidth 1(setlinewidth)prcmd currentlinecap 1(se"
+"tlinecap)prcmd currentlinejoin 1(setlinejoin)prcmd currentmiterlimit 1(setmite"
+"rlimit)prcmd revision dup 952 lt{pop}{.currentblendmode .setblendmode 952 eq{."
+"currentopacityalpha .setopacityalpha .currentshapealpha .setshapealpha}{.curre"
+"ntalphaisshape{1}{0}ifelse 1(setalphaisshape)prcmd .currentstrokeconstantalpha"
+" 1(setstrokeconstantalpha)prcmd .currentfillconstantalpha 1(setfillconstantalp"
+"ha)prcmd}ifelse}ifelse prcolor currentdash mark 3 1 roll exch aload length 1 a"
+"dd -1 roll counttomark(setdash)prcmd pop}if}def/strconcat{exch dup length 2 in"
+"dex length add string dup dup 4 2 roll copy length 4 -1 roll putinterval}def/s"
+"etgstate{/setgstate sysexec printgstate}def/save{@UD begin/@saveID vmstatus po"
+"p pop def end :save @saveID 1(save)prcmd}def/restore{:restore @checknulldev pr"
+"intgstate @UD/@saveID known{@UD begin @saveID end}{0}ifelse 1(restore)prcmd}de"
+"f/gsave 0 defpr/grestore{:grestore @checknulldev printgstate 0(grestore)prcmd}"
+"def/grestoreall{:grestoreall @checknulldev setstate 0(grestoreall)prcmd}def/ro"
+"tate{dup type/arraytype ne @dodraw and{dup 1(rotate)prcmd}if/rotate sysexec ap"
+"plyscalevals}def/scale{dup type/arraytype ne @dodraw and{2 copy 2(scale)prcmd}"
+"if/scale sysexec applyscalevals}def/translate{dup type/arraytype ne @dodraw an"
+"d{2 copy 2(translate)prcmd}if/translate sysexec}def/setmatrix{dup/setmatrix sy"
+"sexec @dodraw{aload pop 6(setmatrix)prcmd applyscalevals}{pop}ifelse}def/initm"
+"atrix{matrix setmatrix}def/concat{matrix currentmatrix matrix concatmatrix set"
+"matrix}def/makepattern{gsave<</mx 3 -1 roll>>begin<</XUID[1000000 @patcnt]>>co"
+"py mx/makepattern sysexec dup begin PatternType 2 lt{PatternType @patcnt BBox "
+"aload pop XStep YStep PaintType mx aload pop 15(makepattern)prcmd :newpath mat"
+"rix setmatrix dup PaintProc 0 1(makepattern)prcmd @GD/@patcnt @patcnt 1 add pu"
+"t}if end end grestore}def/setpattern{dup begin PatternType end 1 eq{begin Pain"
+"tType 1 eq{XUID aload pop exch pop 1}{:gsave[currentcolorspace aload length -1"
+" roll pop]/setcolorspace sysexec/setcolor sysexec XUID aload pop exch pop curr"
+"entrgbcolor :grestore 4}ifelse(setpattern)prcmd currentcolorspace 0 get/Patter"
+"n ne{[/Pattern currentcolorspace]/setcolorspace sysexec}if currentcolorspace @"
+"setcolorspace end}{/setpattern sysexec}ifelse}def/setcolor{dup type/dicttype e"
+"q{setpattern}{/setcolor sysexec/currentrgbcolor sysexec setrgbcolor}ifelse}def"
+"/setcolorspace{dup/setcolorspace sysexec @setcolorspace}def/@setcolorspace{dup"
+" type/arraytype eq{0 get}if/Pattern eq{1}{0}ifelse 1(setcolorspace)prcmd}def/s"
+"etgray 1 defpr/setcmykcolor 4 defpr/sethsbcolor 3 defpr/setrgbcolor 3 defpr/.s"
+"etalphaisshape{@SD/.setalphaisshape known{dup/.setalphaisshape sysexec}if{1}{0"
+"}ifelse 1(setalphaisshape)prcmd}bind def/.setfillconstantalpha{@SD/.setfillcon"
+"stantalpha known{dup/.setfillconstantalpha sysexec}if 1(setfillconstantalpha)p"
+"rcmd}bind def/.setstrokeconstantalpha{@SD/.setstrokeconstantalpha known{dup/.s"
+"etstrokeconstantalpha sysexec}if 1(setstrokeconstantalpha)prcmd}bind def/.seto"
+"pacityalpha{false .setalphaisshape dup .setfillconstantalpha .setstrokeconstan"
+"talpha}bind def/.setshapealpha{true .setalphaisshape dup .setfillconstantalpha"
+" .setstrokeconstantalpha}bind def/.setblendmode{dup/.setblendmode sysexec<</No"
+"rmal 0/Compatible 0/Multiply 1/Screen 2/Overlay 3/SoftLight 4/HardLight 5/Colo"
+"rDodge 6/ColorBurn 7/Darken 8/Lighten 9/Difference 10/Exclusion 11/Hue 12/Satu"
+"ration 13/Color 14/Luminosity 15/CompatibleOverprint 16>>exch get 1(setblendmo"
+"de)prcmd}def/@pdfpagecount{(r)file runpdfbegin pdfpagecount runpdfend}def/@pdf"
+"mediabox{dup dup 1 lt exch pdfpagecount gt or{pop}{pdfgetpage/MediaBox pget po"
+"p aload pop}ifelse}def/@pdfpagebox{(r)file runpdfbegin @pdfmediabox runpdfend}"
+"def/@pdfopen{(r)file runpdfbegin/process_trailer_attrs where{pop process_trail"
+"er_attrs}if}def/@pdfpage{<</PDFScanRules true>>setuserparams dup/Page# exch st"
+"ore pdfgetpage pdfshowpage<</PDFScanRules null>>setuserparams}def/@pdfclose{ru"
+"npdfend}def DELAYBIND{.bindnow}if ";
 
@@ -40,13 +40,10 @@ void HeadTable::updateGlobalBbox (int16_t xmin, int16_t ymin, int16_t xmax, int1
 /** Returns the number of seconds elapsed since 1.1.1904 00:00:00 until now.
  *  @return number of seconds separated in upper and lower dword of a 64-bit value */
 static pair<uint32_t,uint32_t> seconds_since_1904 () {
-	auto now = chrono::system_clock::now();
-	time_t now_time = chrono::system_clock::to_time_t(now);
-	struct tm *comp = gmtime(&now_time);
-	util::Date date1(1904, 1, 1);
-	util::Date date2(comp->tm_year+1900, comp->tm_mon+1, comp->tm_mday);
-	uint64_t days = date2 - date1 - 1;
-	uint64_t seconds = ((days*24 + comp->tm_hour)*60 + comp->tm_min)*60 + comp->tm_sec;
+	// Fonts can be written concurrently, so we don't use the non-reentrant gmtime()
+	// but add the seconds between 1.1.1904 and 1.1.1970 (24107 days) to the UNIX time.
+	time_t now_time = chrono::system_clock::to_time_t(chrono::system_clock::now());
+	uint64_t seconds = uint64_t(now_time) + uint64_t(24107)*24*60*60;
 	return {uint32_t(seconds >> 32), uint32_t(seconds & 0xffffffff)};
 }
 
@@ -57,8 +57,8 @@ string TableBuffer::name () const {
 
 /** Tries to compress the buffer data. If the size of the compressed buffer data is
  *  greater or equal than the size of the uncompressed data, the buffer stays uncompressed.
- *  @returns true if the data was compressed */
-void TableBuffer::compress () {
+ *  @param[in] level zlib compression level (0-9) */
+void TableBuffer::compress (int level) {
 	if (_data.size() < 16)
 		return;
 	uLong compressedSize = compressBound(_data.size());
@@ -67,7 +67,7 @@ void TableBuffer::compress () {
 	// Only use the compressed data if it actually leads to a size reduction. Otherwise, use the original table data.
 	auto source = reinterpret_cast<const Bytef*>(_data.data());
 	auto target = reinterpret_cast<Bytef*>(&compressedData[0]);
-	if (compress2(target, &compressedSize, source, _unpaddedSize, Z_BEST_COMPRESSION) == Z_OK && compressedSize < _unpaddedSize) {
+	if (compress2(target, &compressedSize, source, _unpaddedSize, level) == Z_OK && compressedSize < _unpaddedSize) {
 		_compressedSize = compressedSize;
 		_data = std::move(compressedData);
 		_data.resize((compressedSize+3) & ~3, 0);  // reduce buffer to padded compressed size
@@ -18,6 +18,7 @@
 ** along with this program; if not, see <http://www.gnu.org/licenses/>. **
 *************************************************************************/
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <fstream>
@@ -26,17 +27,19 @@
 #include <woff2/encode.h>
 #include "TTFWriter.hpp"
 #include "../Font.hpp"
+#include "../ThreadPool.hpp"
 #include "../utility.hpp"
 
 using namespace std;
 using namespace ttf;
 
+int TTFWriter::COMPRESSION_LEVEL = 11;
 #ifdef TTFDEBUG
 bool TTFWriter::CREATE_PS_GLYPH_OUTLINES;
 #endif
 
 
-TTFWriter::TTFWriter (const PhysicalFont &font, const set<int> &chars) :
+TTFWriter::TTFWriter (const PhysicalFont &font, const CharSet &chars) :
 	_font(font),
 	_tracerCallback(),
 	_tables({&_cmap, &_glyf, &_hmtx, &_hhea, &_loca, &_maxp, &_name, &_os2, &_post, &_head})  // mandatory tables
@@ -211,6 +214,7 @@ static bool ttf_to_woff2 (const string &buffer, ostream &os) {
 	string output(output_size, 0);
 	uint8_t* output_data = reinterpret_cast<uint8_t*>(&output[0]);
 	woff2::WOFF2Params params;
+	params.brotli_quality = max(0, min(11, TTFWriter::COMPRESSION_LEVEL));
 	if (woff2::ConvertTTFToWOFF2(input_data, buffer.size(), output_data, &output_size, params)) {
 		output.resize(output_size);
 		copy(output.begin(), output.end(), ostream_iterator<uint8_t>(os));
@@ -327,8 +331,26 @@ static bool ttf_to_woff (list<TableBuffer> &&buffers, ostream &os) {
 	});
 	buffers.pop_front();  // remove TTF header
 	buffers.pop_front();  // remove TTF table records
-	for (TableBuffer &buffer : buffers)
-		buffer.compress();
+	// The tables are compressed independently. Large ones (usually glyf and cmap
+	// of fonts with many glyphs) are compressed concurrently unless the font is
+	// already written by a worker thread (see SVGTree::append()), which would
+	// start another pool of threads per font.
+	const size_t minParallelSize = 0x10000;
+	const int level = max(0, min(9, TTFWriter::COMPRESSION_LEVEL));
+	auto numLarge = std::count_if(buffers.begin(), buffers.end(), [&](const TableBuffer &buf) {
+		return buf.paddedSize() >= minParallelSize;
+	});
+	bool parallel = numLarge > 1 && !ThreadPool::inWorkerThread();
+	ThreadPool pool(parallel ? min(unsigned(numLarge), ThreadPool::defaultNumThreads()) : 1);
+	vector<future<void>> futures;
+	for (TableBuffer &buffer : buffers) {
+		if (buffer.paddedSize() >= minParallelSize)
+			futures.push_back(pool.enqueue([&buffer, level]() {buffer.compress(level);}));
+		else
+			buffer.compress(level);
+	}
+	for (auto &future : futures)
+		future.get();
 	size_t woffSize = std::accumulate(buffers.begin(), buffers.end(), size_t(0), [](size_t sum, const TableBuffer &buf) {
 		return sum + buf.paddedSize();
 	});
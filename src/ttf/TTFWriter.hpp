@@ -20,7 +20,6 @@
 
 #pragma once
 
-#include <set>
 #include <vector>
 #include "CmapTable.hpp"
 #include "GlyfTable.hpp"
@@ -34,6 +33,7 @@
 #include "PostTable.hpp"
 #include "VheaTable.hpp"
 #include "VmtxTable.hpp"
+#include "../CharSet.hpp"
 #include "../GFGlyphTracer.hpp"
 #include "../RangeMap.hpp"
 
@@ -43,7 +43,7 @@ namespace ttf {
 
 class TTFWriter {
 	public:
-		TTFWriter (const PhysicalFont &font, const std::set<int> &chars);
+		TTFWriter (const PhysicalFont &font, const CharSet &chars);
 		bool writeTTF (std::ostream &os);
 		bool writeWOFF (std::ostream &os);
 		bool writeWOFF2 (std::ostream &os);
@@ -80,6 +80,7 @@ class TTFWriter {
 				_head.setLongOffsetFormat();
 		}
 
+		static int COMPRESSION_LEVEL;  ///< compression level of WOFF and WOFF2 data (0-11)
 #ifdef TTFDEBUG
 		static bool CREATE_PS_GLYPH_OUTLINES;
 #endif
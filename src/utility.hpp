@@ -30,6 +30,7 @@
 #include <functional>
 #include <memory>
 #include <sstream>
+#include <streambuf>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -246,6 +247,31 @@ class Date {
 		int _year, _month, _day;  // _month and _day are 0-based
 };
 
+
+/** Stream buffer reading the characters directly from a memory block. It allows
+ *  to access a character sequence through an std::istream without copying it.
+ *  The memory block must exist as long as the stream buffer is in use. */
+class CharStreamBuffer : public std::streambuf {
+	public:
+		CharStreamBuffer (const char *buf, size_t size, size_t pos=0) {
+			char *first = const_cast<char*>(buf);
+			setg(first, first+pos, first+size);
+		}
+
+	protected:
+		pos_type seekoff (off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			char *pos = (dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr()) + off;
+			if (!(which & std::ios_base::in) || pos < eback() || pos > egptr())
+				return pos_type(off_type(-1));
+			setg(eback(), pos, egptr());
+			return pos_type(off_type(pos-eback()));
+		}
+
+		pos_type seekpos (pos_type pos, std::ios_base::openmode which) override {
+			return seekoff(off_type(pos), std::ios_base::beg, which);
+		}
+};
+
 } // namespace util
 
 #endif
@@ -0,0 +1,112 @@
+/*************************************************************************
+** CMapCacheTest.cpp                                                    **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include "CMap.hpp"
+#include "CMapCache.hpp"
+#include "CMapReader.hpp"
+
+using namespace std;
+
+
+class CMapCacheTest : public ::testing::Test {
+	protected:
+		CMapCacheTest () {
+			istringstream iss(cmapsrc);
+			CMapReader reader;
+			auto cmapPtr = reader.read(iss, "Test-Map");
+			cmap.reset(dynamic_cast<SegmentedCMap*>(cmapPtr.release()));
+		}
+
+		static const char *cmapsrc;
+		const vector<uint8_t> srchash = {1, 2, 3, 4, 5, 6, 7, 8};
+		unique_ptr<SegmentedCMap> cmap;
+};
+
+
+const char *CMapCacheTest::cmapsrc =
+"/CIDInit /ProcSet findresource begin\n"
+"12 dict begin\n"
+"begincmap\n"
+"/CIDSystemInfo 3 dict dup begin\n"
+"  /Registry (Adobe) def\n"
+"  /Ordering (Japan1) def\n"
+"  /Supplement 6 def\n"
+"end def\n"
+"/CMapName /Test-Map def\n"
+"/CMapType 1 def\n"
+"/WMode 1 def\n"
+"3 begincidchar\n"
+"<1000> 50\n"
+"<1005> 60\n"
+"<1008> 70\n"
+"endcidchar\n"
+"2 begincidrange\n"
+"<1234> <1240> 100\n"
+"<1300> <1302> 200\n"
+"endcidrange\n"
+"endcmap\n"
+"CMapName currentdict /CMap defineresource pop\n";
+
+
+TEST_F(CMapCacheTest, writeAndRead) {
+	ASSERT_NE(cmap, nullptr);
+	ostringstream oss;
+	ASSERT_TRUE(CMapCache::write(*cmap, srchash, oss));
+	istringstream iss(oss.str());
+	auto cached = CMapCache::read("Test-Map", srchash, iss);
+	ASSERT_NE(cached, nullptr);
+	EXPECT_STREQ(cached->name(), "Test-Map");
+	EXPECT_EQ(cached->getROString(), "Adobe-Japan1");
+	EXPECT_TRUE(cached->vertical());
+	EXPECT_TRUE(cached->mapsToCID());
+	EXPECT_EQ(cached->numCIDRanges(), cmap->numCIDRanges());
+	EXPECT_EQ(cached->numBFRanges(), 0u);
+	for (uint32_t c=0xff0; c < 0x1310; c++)
+		EXPECT_EQ(cached->cid(c), cmap->cid(c)) << "c=" << c;
+}
+
+
+TEST_F(CMapCacheTest, outdated) {
+	ASSERT_NE(cmap, nullptr);
+	ostringstream oss;
+	ASSERT_TRUE(CMapCache::write(*cmap, srchash, oss));
+	istringstream iss1(oss.str());
+	EXPECT_EQ(CMapCache::read("Test-Map", {1, 2, 3, 4, 5, 6, 7, 9}, iss1), nullptr);
+	istringstream iss2(oss.str());
+	EXPECT_EQ(CMapCache::read("Other-Map", srchash, iss2), nullptr);
+}
+
+
+TEST_F(CMapCacheTest, corrupted) {
+	ASSERT_NE(cmap, nullptr);
+	ostringstream oss;
+	ASSERT_TRUE(CMapCache::write(*cmap, srchash, oss));
+	string data = oss.str();
+	data[data.length()-2] ^= 0x10;
+	istringstream iss1(data);
+	EXPECT_EQ(CMapCache::read("Test-Map", srchash, iss1), nullptr);
+	istringstream iss2(oss.str().substr(0, 20));
+	EXPECT_EQ(CMapCache::read("Test-Map", srchash, iss2), nullptr);
+	istringstream iss3("");
+	EXPECT_EQ(CMapCache::read("Test-Map", srchash, iss3), nullptr);
+}
@@ -21,8 +21,13 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include "CMap.hpp"
+#include "CMapCache.hpp"
 #include "CMapManager.hpp"
+#include "FileFinder.hpp"
+#include "FileSystem.hpp"
+#include "Font.hpp"
 #include "Message.hpp"
+#include "XXHashFunction.hpp"
 
 
 TEST(CMapManagerTest, lookup_buildin) {
@@ -63,6 +68,33 @@ TEST(CMapManagerTest, lookup_file) {
 }
 
 
+class MyCMapManager : public CMapManager {
+	public:
+		using CMapManager::load;
+};
+
+
+TEST(CMapManagerTest, load_cached) {
+	PhysicalFont::CACHE_PATH = ".";
+	const std::string cachefile = CMapCache::filepath("ot1.cmap", ".");
+	FileSystem::remove(cachefile);
+	MyCMapManager manager;
+	auto cmap = manager.load("ot1.cmap");  // parse CMap file and create cache file
+	ASSERT_NE(cmap, nullptr);
+	EXPECT_TRUE(FileSystem::exists(cachefile));
+	std::ifstream ifs(FileFinder::instance().lookup("ot1.cmap", "cmap", false));
+	XXH64HashFunction hashfunc;
+	hashfunc.update(ifs);
+	EXPECT_NE(CMapCache::read("ot1.cmap", hashfunc.digestBytes(), "."), nullptr);
+	auto cached = manager.load("ot1.cmap");  // read cache file
+	ASSERT_NE(cached, nullptr);
+	for (uint32_t c=0; c <= 0x80; c++)
+		EXPECT_EQ(cached->bfcode(c), cmap->bfcode(c)) << "c=" << c;
+	FileSystem::remove(cachefile);
+	PhysicalFont::CACHE_PATH.clear();
+}
+
+
 TEST(CMapManagerTest, lookup_fail) {
 	Message::LEVEL = 0;  // avoid warning messages
 	CMapManager &manager = CMapManager::instance();
@@ -88,3 +88,18 @@ TEST(CalculatorTest, units) {
 	EXPECT_DOUBLE_EQ(calc.eval("5cm/1cm"), 5.0);
 	EXPECT_DOUBLE_EQ(calc.eval("5cm"), 5/2.54*72);
 }
+
+
+TEST(CalculatorTest, compile) {
+	Calculator calc;
+	calc.setVariable("c", 3);
+	Calculator::Expression expr = calc.compile("2a+b*c-(a%b)", {"a", "b"});
+	EXPECT_EQ(expr.eval({1, 2}), 7);
+	EXPECT_EQ(expr.eval({4, 3}), 16);
+	calc.setVariable("c", 4);  // value of c was compiled into the expression
+	EXPECT_EQ(expr.eval({1, 2}), 7);
+	EXPECT_EQ(calc.compile("-(2*c)/4").eval(), -2);
+	EXPECT_THROW(expr.eval({1}), CalculatorException);     // missing slot value
+	EXPECT_THROW(calc.compile("1/a", {"a"}).eval({0}), CalculatorException);
+	EXPECT_THROW(calc.compile("a+d", {"a"}), CalculatorException);  // undefined variable
+}
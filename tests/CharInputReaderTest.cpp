@@ -0,0 +1,199 @@
+/*************************************************************************
+** CharInputReaderTest.cpp                                              **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include "InputReader.hpp"
+
+using std::map;
+using std::string;
+
+TEST(CharInputReaderTest, get) {
+	string str = "abcdefghijklmnopqrstuvwxyz";
+	CharInputReader in(str);
+	for (int i=0; i < 26; i++) {
+		ASSERT_FALSE(in.eof());
+		EXPECT_EQ(in.get(), 'a'+i);
+	}
+	EXPECT_TRUE(in.eof());
+	EXPECT_EQ(in.get(), -1);
+	EXPECT_EQ(in.peek(), -1);
+}
+
+
+TEST(CharInputReaderTest, peek) {
+	const char *str = "abcdefghijklmnopqrstuvwxyz";
+	CharInputReader in(str, 10);
+	EXPECT_EQ(in.peek(), 'a');
+	for (int i=0; i < 10; i++)
+		EXPECT_EQ(in.peek(i), 'a'+i);
+	EXPECT_EQ(in.peek(10), -1);
+	in.skip(8);
+	EXPECT_EQ(in.peek(1), 'j');
+	EXPECT_EQ(in.peek(2), -1);
+	in.skip(5);
+	EXPECT_TRUE(in.eof());
+}
+
+
+TEST(CharInputReaderTest, read) {
+	string str = "abcdefghijk";
+	CharInputReader in(str);
+	char buf[10];
+	EXPECT_EQ(in.read(buf, 8), 8);
+	EXPECT_EQ(string(buf, 8), "abcdefgh");
+	EXPECT_EQ(in.read(buf, 8), 3);
+	EXPECT_EQ(string(buf, 3), "ijk");
+	EXPECT_EQ(in.read(buf, 8), 0);
+}
+
+
+TEST(CharInputReaderTest, check) {
+	string str = "abcdefghij";
+	CharInputReader in(str);
+	EXPECT_TRUE(in.check('a'));
+	EXPECT_TRUE(in.check("abc", false));
+	EXPECT_TRUE(in.check("abc", true));
+	EXPECT_FALSE(in.check("abc", true));
+	EXPECT_TRUE(in.check("defghij", true));
+	EXPECT_TRUE(in.eof());
+	EXPECT_FALSE(in.check("x"));
+}
+
+
+TEST(CharInputReaderTest, find) {
+	string str = "abcd efgh ijklmn abc";
+	CharInputReader in(str);
+	EXPECT_EQ(in.find('x'), -1);
+	EXPECT_EQ(in.find('c'), 2);
+	EXPECT_EQ(in.find(' '), 4);
+	in.skip(3);
+	EXPECT_EQ(in.find('c'), 16);
+}
+
+
+TEST(CharInputReaderTest, parseInt) {
+	string str = "1234,-5,+6,10.-";
+	CharInputReader in(str);
+	int n;
+	EXPECT_TRUE(in.parseInt(n));
+	EXPECT_EQ(n, 1234);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_TRUE(in.parseInt(n));
+	EXPECT_EQ(n, -5);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_TRUE(in.parseInt(n));
+	EXPECT_EQ(n, 6);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_TRUE(in.parseInt(n));
+	EXPECT_EQ(n, 10);
+	EXPECT_EQ(in.get(), '.');
+	EXPECT_FALSE(in.parseInt(n));
+	EXPECT_EQ(in.get(), '-');
+}
+
+
+TEST(CharInputReaderTest, parseDouble) {
+	string str = "1234,-5,6.12,-3.1415,-0.5,-.1,12e2, 7E-1,10.-";
+	CharInputReader in(str);
+	double d;
+	EXPECT_EQ(in.parseDouble(d), 'i');
+	EXPECT_EQ(d, 1234.0);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'i');
+	EXPECT_EQ(d, -5.0);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, 6.12);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, -3.1415);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, -0.5);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, -0.1);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, 1200);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_DOUBLE_EQ(d, 0.7);
+	EXPECT_EQ(in.get(), ',');
+	EXPECT_EQ(in.parseDouble(d), 'f');
+	EXPECT_EQ(d, 10.0);
+	EXPECT_EQ(in.peek(), '-');
+	EXPECT_FALSE(in.parseDouble(d));
+	EXPECT_EQ(in.get(), '-');
+	EXPECT_EQ(in.getDouble(), 0);
+}
+
+
+TEST(CharInputReaderTest, getString) {
+	string str = "abcd efgh \"ij'klm\"n abcdef '012\"34'xyz  word1 ;rest of line  \nnext";
+	CharInputReader in(str);
+	EXPECT_EQ(in.getString(), "abcd");
+	EXPECT_EQ(in.getString(), "efgh");
+	EXPECT_EQ(in.getQuotedString("\""), "ij'klm");
+	EXPECT_EQ(in.getQuotedString("\""), "");
+	EXPECT_EQ(in.getString(4), "n ab");
+	EXPECT_EQ(in.getQuotedString(nullptr), "cdef");
+	EXPECT_EQ(in.getQuotedString("\"'"), "012\"34");
+	EXPECT_EQ(in.getString(" "), "xyz");
+	EXPECT_EQ(in.getWord(), "word");
+	EXPECT_EQ(in.getInt(), 1);
+	EXPECT_EQ(in.getPunct(), ';');
+	EXPECT_EQ(in.getLine(), "rest of line");
+	EXPECT_EQ(in.getString(), "next");
+	EXPECT_TRUE(in.eof());
+}
+
+
+TEST(CharInputReaderTest, nonASCII) {
+	// bytes >= 0x80 must be returned as non-negative values
+	string str = "\xC3\xA4 <text>gr\xC3\xBC\xC3\x9F</text>  \n\xE2\x82\xAC;rest";
+	CharInputReader in(str);
+	EXPECT_EQ(in.peek(), 0xC3);
+	EXPECT_EQ(in.peek(1), 0xA4);
+	EXPECT_EQ(in.get(), 0xC3);
+	EXPECT_EQ(in.get(), 0xA4);
+	EXPECT_EQ(in.getLine(), "<text>gr\xC3\xBC\xC3\x9F</text>");
+	EXPECT_EQ(in.get(), '\n');
+	EXPECT_TRUE(in.check("\xE2\x82\xAC", false));
+	EXPECT_EQ(in.getString(";"), "\xE2\x82\xAC");
+	EXPECT_EQ(in.get(), ';');
+	EXPECT_EQ(in.getString(), "rest");
+	EXPECT_TRUE(in.eof());
+}
+
+
+TEST(CharInputReaderTest, attribs) {
+	string str = "aaa='1' bbb='2' c-c-c='3' d e='value'";
+	CharInputReader in(str);
+	map<string,string> attr;
+	EXPECT_EQ(in.parseAttributes(attr, false, "'"), 5);
+	EXPECT_EQ(attr["aaa"], "1");
+	EXPECT_EQ(attr["bbb"], "2");
+	EXPECT_EQ(attr["c-c-c"], "3");
+	EXPECT_EQ(attr["e"], "value");
+	EXPECT_TRUE(attr.at("d").empty());
+}
@@ -0,0 +1,115 @@
+/*************************************************************************
+** CharSetTest.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+#include "CharSet.hpp"
+
+using namespace std;
+
+
+static vector<int> to_vector (const CharSet &charset) {
+	return vector<int>(charset.begin(), charset.end());
+}
+
+
+TEST(CharSetTest, empty) {
+	CharSet charset;
+	EXPECT_TRUE(charset.empty());
+	EXPECT_EQ(charset.size(), 0u);
+	EXPECT_TRUE(charset.begin() == charset.end());
+	EXPECT_FALSE(charset.contains(0));
+	EXPECT_FALSE(charset.contains(-1));
+}
+
+
+TEST(CharSetTest, insert) {
+	CharSet charset;
+	EXPECT_TRUE(charset.insert(65));
+	EXPECT_TRUE(charset.insert(0));
+	EXPECT_TRUE(charset.insert(63));
+	EXPECT_TRUE(charset.insert(64));
+	EXPECT_FALSE(charset.insert(65));
+	EXPECT_FALSE(charset.insert(0));
+	EXPECT_EQ(charset.size(), 4u);
+	EXPECT_TRUE(charset.contains(0));
+	EXPECT_TRUE(charset.contains(63));
+	EXPECT_TRUE(charset.contains(64));
+	EXPECT_TRUE(charset.contains(65));
+	EXPECT_FALSE(charset.contains(1));
+	EXPECT_FALSE(charset.contains(1000));
+	EXPECT_EQ(to_vector(charset), vector<int>({0, 63, 64, 65}));
+}
+
+
+TEST(CharSetTest, sparse) {
+	CharSet charset{0x110000, -5, 10, 0x7fffffff, -100, 0x10ffff};
+	EXPECT_EQ(charset.size(), 6u);
+	EXPECT_TRUE(charset.contains(-5));
+	EXPECT_TRUE(charset.contains(0x7fffffff));
+	EXPECT_FALSE(charset.insert(-5));
+	EXPECT_FALSE(charset.insert(0x110000));
+	EXPECT_EQ(to_vector(charset), vector<int>({-100, -5, 10, 0x10ffff, 0x110000, 0x7fffffff}));
+
+	CharSet negatives{-1, -2};
+	EXPECT_EQ(to_vector(negatives), vector<int>({-2, -1}));
+}
+
+
+TEST(CharSetTest, insertSet) {
+	CharSet charset1{1, 2, 200, -3};
+	CharSet charset2{2, 3, 1000, -3, 0x200000};
+	charset1.insert(charset2);
+	EXPECT_EQ(charset1.size(), 7u);
+	EXPECT_EQ(to_vector(charset1), vector<int>({-3, 1, 2, 3, 200, 1000, 0x200000}));
+	charset2.insert(CharSet());
+	EXPECT_EQ(charset2.size(), 5u);
+}
+
+
+TEST(CharSetTest, compare) {
+	CharSet charset1{1, 2, 3};
+	CharSet charset2{3, 2, 1};
+	EXPECT_EQ(charset1, charset2);
+	charset2.insert(5000);
+	EXPECT_NE(charset1, charset2);
+	charset1.insert(5000);
+	EXPECT_EQ(charset1, charset2);
+	charset1.clear();
+	EXPECT_TRUE(charset1.empty());
+	EXPECT_EQ(charset1, CharSet());
+	charset2.clear();
+	charset2.insert(1);
+	EXPECT_NE(charset1, charset2);
+}
+
+
+TEST(CharSetTest, iterate) {
+	set<int> chars;
+	CharSet charset;
+	for (int i=0; i < 20000; i++) {
+		int c = (i*7919) % 70000;
+		chars.insert(c);
+		charset.insert(c);
+	}
+	EXPECT_EQ(charset.size(), chars.size());
+	EXPECT_EQ(to_vector(charset), vector<int>(chars.begin(), chars.end()));
+}
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include "ColorSpecialHandler.hpp"
+#include "InputReader.hpp"
 #include "SpecialActions.hpp"
 
 using namespace std;
@@ -208,3 +209,25 @@ TEST_F(ColorSpecialTest, errors) {
 	EXPECT_THROW(handler.process("", iss, actions), SpecialException);
 }
 
+
+
+TEST_F(ColorSpecialTest, processText) {
+	string special = "push rgb 1 0 1";
+	CharInputReader ir1(special);
+	EXPECT_TRUE(handler.processText("", ir1, actions));
+	EXPECT_TRUE(actions.equals(0xff00ff));
+	EXPECT_EQ(handler.stackSize(), 1u);
+	special = "set fill gray 0.2";
+	CharInputReader ir2(special);
+	handler.processText("", ir2, actions);
+	EXPECT_TRUE(actions.equals(0x333333, 0xff00ff));
+	EXPECT_EQ(handler.stackSize(), 1u);
+	special = "gray 0.4";
+	CharInputReader ir3(special);
+	handler.processText("", ir3, actions);
+	EXPECT_TRUE(actions.equals(0x666666));
+	EXPECT_EQ(handler.stackSize(), 1u);
+	special = "rgb 1 x 0";
+	CharInputReader ir4(special);
+	EXPECT_THROW(handler.processText("", ir4, actions), SpecialException);
+}
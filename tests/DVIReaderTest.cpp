@@ -70,8 +70,8 @@ class LoggingDVIReader : public DVIReader {
 			_os << "pre " << int(id) << ", " << numer << ", " << denom << ", " <<  mag << ", '" << comment << "'";
 		}
 
-		void dviPost (uint16_t stdepth, uint16_t pages, uint32_t pw, uint32_t ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) override {
-			_os << "post " << stdepth << ", " << pages << ", " << pw << ", " << ph << ", " <<  mag << ", " <<  num << ", " << den << ", " <<  lbopofs;
+		void dviPost (uint16_t stdepth, uint16_t pages, double pw, double ph, uint32_t mag, uint32_t num, uint32_t den, uint32_t lbopofs) override {
+			_os << "post " << stdepth << ", " << pages << ", " << XMLString(pw) << ", " << XMLString(ph) << ", " <<  mag << ", " <<  num << ", " << den << ", " <<  lbopofs;
 		}
 
 		void dviPostPost (uint8_t id, uint32_t postOffset) override {
@@ -520,7 +520,7 @@ TEST(DVIReaderTest, dvi_v2) {
 		"pop [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
 		"pop [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
 		"eop [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
-		"post 10, 1, 405, 630, 1000, 25400000, 473628672, 42 [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
+		"post 10, 1, 405.479, 630.635, 1000, 25400000, 473628672, 42 [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
 		"fontdef 7, 1274110073, cmr10 [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
 		"postpost 2, 953 [h=0, v=630.635, x=0, y=0, w=0, z=0, d=0]",
 	};
@@ -577,7 +577,7 @@ TEST(DVIReaderTest, dvi_v3) {
 		"pop [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
 		"pop [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
 		"eop [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
-		"post 5, 1, 451, 703, 1000, 25400000, 473628672, 42 [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
+		"post 5, 1, 451.34, 703.125, 1000, 25400000, 473628672, 42 [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
 		"fontdef 7, 1274110073, cmr10 [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
 		"postpost 3, 195 [h=0, v=703.125, x=0, y=0, w=0, z=0, d=0]",
 	};
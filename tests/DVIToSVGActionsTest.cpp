@@ -0,0 +1,138 @@
+/*************************************************************************
+** DVIToSVGActionsTest.cpp                                              **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "DVIToSVG.hpp"
+#include "DVIToSVGActions.hpp"
+#include "SVGOutput.hpp"
+#include "SVGTree.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+
+/** Returns the bytes of a DVI file without any pages. */
+static string empty_dvi () {
+	const unsigned char bytes[] = {
+		247, 2, 1, 131, 146, 192, 28, 59, 0, 0, 0, 0, 3, 232, 0,  // pre
+		248, 255, 255, 255, 255, 1, 131, 146, 192, 28, 59, 0, 0, 0, 0, 3, 232,  // post
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+		249, 0, 0, 0, 15, 2, 223, 223, 223, 223  // post_post
+	};
+	return string(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+
+class DVIToSVGActionsTest : public ::testing::Test {
+	protected:
+		DVIToSVGActionsTest () : _dviStream(empty_dvi()), _dvisvg(_dviStream, _out), _actions(_dvisvg, _svg) {}
+
+		void SetUp () override {
+			DVIToSVGActions::MERGE_RULES = true;
+			SVGTree::RELATIVE_PATH_CMDS = false;
+			_actions.beginPage(1, {});
+		}
+
+		void TearDown () override {
+			DVIToSVGActions::MERGE_RULES = false;
+		}
+
+		/** Returns the serialized child nodes of the current page. */
+		string pageContent () const {
+			ostringstream oss;
+			for (const XMLNode *node=_svg.pageNode()->firstChild(); node; node=node->next())
+				node->write(oss);
+			return oss.str();
+		}
+
+	protected:
+		istringstream _dviStream;
+		SVGOutput _out;
+		DVIToSVG _dvisvg;
+		SVGTree _svg;
+		DVIToSVGActions _actions;
+};
+
+
+TEST_F(DVIToSVGActionsTest, mergeRules) {
+	_actions.setRule(10, 20, 2, 30);
+	_actions.setRule(10, 40, 2, 30);
+	_actions.setRule(50, 40, 5, 1);
+	EXPECT_EQ(pageContent(), "<path d='M10 18H40V20H10ZM10 38H40V40H10ZM50 35H51V40H50Z'/>");
+}
+
+
+TEST_F(DVIToSVGActionsTest, colorChange) {
+	_actions.setRule(10, 20, 2, 30);
+	_actions.setFillColor(Color(1.0, 0.0, 0.0));
+	_actions.setRule(10, 40, 2, 30);
+	_actions.setRule(50, 40, 5, 1);
+	_actions.setFillColor(Color::BLACK);
+	_actions.setRule(0, 10, 1, 1);
+	EXPECT_EQ(pageContent(),
+		"<path d='M10 18H40V20H10Z'/>"
+		"<path d='M10 38H40V40H10ZM50 35H51V40H50Z' fill='#f00'/>"
+		"<path d='M0 9H1V10H0Z'/>");
+}
+
+
+TEST_F(DVIToSVGActionsTest, matrixChange) {
+	_actions.setRule(10, 20, 2, 30);
+	_actions.setMatrix(Matrix(1).translate(5, 5));
+	_actions.setRule(10, 40, 2, 30);
+	_actions.setRule(50, 40, 5, 1);
+	_actions.setMatrix(Matrix(1));
+	_actions.setRule(0, 10, 1, 1);
+	EXPECT_EQ(pageContent(),
+		"<path d='M10 18H40V20H10Z'/>"
+		"<path d='M10 38H40V40H10ZM50 35H51V40H50Z' transform='matrix(1 0 0 1 5 5)'/>"
+		"<path d='M0 9H1V10H0Z'/>");
+}
+
+
+TEST_F(DVIToSVGActionsTest, interveningContent) {
+	_actions.setRule(10, 20, 2, 30);
+	_svg.appendToPage(util::make_unique<SVGElement>("g"));
+	_actions.setRule(10, 40, 2, 30);
+	_actions.setRule(50, 40, 5, 1);
+	EXPECT_EQ(pageContent(), "<path d='M10 18H40V20H10Z'/><g/><path d='M10 38H40V40H10ZM50 35H51V40H50Z'/>");
+}
+
+
+TEST_F(DVIToSVGActionsTest, unmerged) {
+	DVIToSVGActions::MERGE_RULES = false;
+	_actions.setRule(10, 20, 2, 30);
+	_actions.setRule(10, 40, 2, 30);
+	EXPECT_EQ(pageContent(),
+		"<rect x='10' y='18' height='2' width='30'/>"
+		"<rect x='10' y='38' height='2' width='30'/>");
+}
+
+
+TEST_F(DVIToSVGActionsTest, reset) {
+	_actions.setRule(10, 20, 2, 30);
+	_svg.reset();
+	_actions.reset();
+	_svg.newPage(2);
+	_actions.setRule(10, 40, 2, 30);
+	EXPECT_EQ(pageContent(), "<path d='M10 38H40V40H10Z'/>");
+}
@@ -0,0 +1,155 @@
+/*************************************************************************
+** DVIToSVGTest.cpp                                                     **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "DVIToSVG.hpp"
+#include "DVIToSVGActions.hpp"
+#include "Message.hpp"
+#include "SVGOutput.hpp"
+#include "StreamWriter.hpp"
+
+using namespace std;
+
+
+/** Returns the bytes of a DVI file with a single page containing a 30u x 20u rule
+ *  placed at (10u, 50u). The page size given in the postamble is 200u x 100u.
+ *  @param[in] num numerator of the DVI unit
+ *  @param[in] den denominator of the DVI unit
+ *  @param[in] u length unit u in DVI units */
+static string single_rule_dvi (uint32_t num, uint32_t den, uint32_t u) {
+	ostringstream oss;
+	StreamWriter sw(oss);
+	sw.writeUnsigned(247, 1);        // pre
+	sw.writeUnsigned(2, 1);
+	sw.writeUnsigned(num, 4);
+	sw.writeUnsigned(den, 4);
+	sw.writeUnsigned(1000, 4);       // mag
+	sw.writeUnsigned(0, 1);          // empty comment
+	sw.writeUnsigned(139, 1);        // bop
+	sw.writeUnsigned(1, 4);
+	for (int i=0; i < 9; i++)
+		sw.writeUnsigned(0, 4);
+	sw.writeSigned(-1, 4);
+	sw.writeUnsigned(160, 1);        // down4
+	sw.writeUnsigned(50*u, 4);
+	sw.writeUnsigned(146, 1);        // right4
+	sw.writeUnsigned(10*u, 4);
+	sw.writeUnsigned(137, 1);        // put_rule
+	sw.writeUnsigned(20*u, 4);
+	sw.writeUnsigned(30*u, 4);
+	sw.writeUnsigned(140, 1);        // eop
+	auto postOffset = uint32_t(oss.tellp());
+	sw.writeUnsigned(248, 1);        // post
+	sw.writeUnsigned(15, 4);         // offset of bop
+	sw.writeUnsigned(num, 4);
+	sw.writeUnsigned(den, 4);
+	sw.writeUnsigned(1000, 4);
+	sw.writeUnsigned(100*u, 4);      // page height
+	sw.writeUnsigned(200*u, 4);      // page width
+	sw.writeUnsigned(1, 2);          // stack depth
+	sw.writeUnsigned(1, 2);          // number of pages
+	sw.writeUnsigned(249, 1);        // post_post
+	sw.writeUnsigned(postOffset, 4);
+	sw.writeUnsigned(2, 1);
+	sw.writeUnsigned(0xDFDFDFDF, 4);
+	return oss.str();
+}
+
+
+class DVIToSVGTest : public ::testing::Test {
+	protected:
+		void SetUp () override {
+			Message::LEVEL = 0;  // avoid progress messages
+		}
+
+		class StringOutput : public SVGOutputBase {
+			public:
+				ostream& getPageStream (int, int, const HashTriple&) const override {
+					_oss.str("");
+					return _oss;
+				}
+				FilePath filepath (int, int, const HashTriple&) const override {return FilePath();}
+				void finish () override {}
+				string str () const {return _oss.str();}
+
+			private:
+				mutable ostringstream _oss;
+		};
+
+		/** Converts the test page using the given --bbox format and returns the
+		 *  value of the viewBox attribute of the resulting SVG document.
+		 *  @param[in] format bounding box format (see option --bbox)
+		 *  @param[in] texUnits if true, the DVI file uses TeX's units (1sp) and the
+		 *    lengths of the test page are given in pt instead of bp */
+		string viewBox (const string &format, bool texUnits=false) {
+			istringstream dviStream(texUnits ? single_rule_dvi(25400000, 473628672, 65536) : single_rule_dvi(254000, 72, 1));
+			StringOutput out;
+			DVIToSVG dvisvg(dviStream, out);
+			dvisvg.setPageSize(format);
+			dvisvg.convert("1");
+			string svg = out.str();
+			size_t pos = svg.find("viewBox='");
+			if (pos == string::npos)
+				return "";
+			pos += 9;
+			return svg.substr(pos, svg.find('\'', pos)-pos);
+		}
+};
+
+
+TEST_F(DVIToSVGTest, bboxContent) {
+	EXPECT_EQ(viewBox("min"), "10 30 30 20");
+	EXPECT_EQ(viewBox("preview"), "10 30 30 20");
+	EXPECT_EQ(viewBox("papersize"), "10 30 30 20");
+}
+
+
+TEST_F(DVIToSVGTest, bboxDvi) {
+	EXPECT_EQ(viewBox("dvi"), "-75 -10 200 100");
+	EXPECT_EQ(viewBox("dvi", true), "-74.719801 -9.96264 199.252802 99.626401");
+}
+
+
+TEST_F(DVIToSVGTest, bboxNone) {
+	EXPECT_EQ(viewBox("none"), "");
+}
+
+
+TEST_F(DVIToSVGTest, bboxPageSize) {
+	EXPECT_EQ(viewBox("a4"), "-72 -72 595.275591 841.889764");
+	EXPECT_EQ(viewBox("a4-l"), "-72 -72 841.889764 595.275591");
+}
+
+
+TEST_F(DVIToSVGTest, bboxLengths) {
+	EXPECT_EQ(viewBox("5bp"), "5 25 40 30");
+	EXPECT_EQ(viewBox("10bp 5bp"), "0 25 50 30");
+	EXPECT_EQ(viewBox("0bp 0bp 100bp 50bp"), "0 0 100 50");
+}
+
+
+TEST_F(DVIToSVGTest, bboxInvalid) {
+	// invalid formats leave the bounding box of the page content unchanged
+	EXPECT_EQ(viewBox("1bp 2bp 3bp"), "10 30 30 20");
+	EXPECT_EQ(viewBox("foo"), "10 30 30 20");
+	EXPECT_EQ(viewBox("5xy"), "10 30 30 20");
+}
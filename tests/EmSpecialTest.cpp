@@ -201,3 +201,24 @@ TEST_F(EmSpecialTest, lineto) {
 	);
 }
 
+
+
+TEST_F(EmSpecialTest, mergeLines) {
+	SVGTree::MERGE_LINES = true;
+	recorder.setStrokeColor(Color(1.0, 0.0, 0.0));
+	handler.processSpecial("linewidth 2bp");
+	for (int i=0; i < 3; i++) {
+		recorder.setX(10*i);
+		handler.processSpecial(i == 0 ? "moveto" : "lineto");
+	}
+	recorder.setX(30);
+	handler.processSpecial("linewidth 4bp");
+	handler.processSpecial("lineto");
+	SVGTree::MERGE_LINES = false;
+	EXPECT_EQ(recorder.getPageXML(),
+		"<g id='page1'>\n"
+		"<path d='M0 0H10M10 0H20' fill='none' stroke-width='2' stroke='#f00'/>\n"
+		"<path d='M20 0H30' fill='none' stroke-width='4' stroke='#f00'/>\n"
+		"</g>"
+	);
+}
@@ -0,0 +1,59 @@
+/*************************************************************************
+** EventStreamTest.cpp                                                  **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <limits>
+#include "BoundingBox.hpp"
+#include "EventStream.hpp"
+
+using namespace std;
+
+
+TEST(EventStreamTest, quote) {
+	EXPECT_EQ(EventStream::quote(""), "\"\"");
+	EXPECT_EQ(EventStream::quote("abc"), "\"abc\"");
+	EXPECT_EQ(EventStream::quote("a\"b\\c"), "\"a\\\"b\\\\c\"");
+	EXPECT_EQ(EventStream::quote("a\nb\tc"), "\"a\\nb\\tc\"");
+	EXPECT_EQ(EventStream::quote(string("\x01\x1f", 2)), "\"\\u0001\\u001f\"");
+}
+
+
+TEST(EventStreamTest, event) {
+	EventStream::Event event("page-finished");
+	event.add("page", 5).add("file", "out.svg").add("success", true).add("bbox", BoundingBox(1, 2, 11, 22));
+	EXPECT_EQ(event.toJSON(), "{\"event\":\"page-finished\",\"page\":5,\"file\":\"out.svg\",\"success\":true,\"bbox\":[1,2,10,20]}");
+}
+
+
+TEST(EventStreamTest, nonFinite) {
+	EventStream::Event event("page-finished");
+	event.add("a", 1.5).add("b", numeric_limits<double>::infinity()).add("c", -numeric_limits<double>::infinity());
+	event.add("d", numeric_limits<double>::quiet_NaN()).add("e", numeric_limits<float>::quiet_NaN());
+	event.add("bbox", BoundingBox(0, 0, numeric_limits<double>::infinity(), 2));
+	EXPECT_EQ(event.toJSON(), "{\"event\":\"page-finished\",\"a\":1.5,\"b\":null,\"c\":null,\"d\":null,\"e\":null,\"bbox\":[0,0,null,2]}");
+}
+
+
+TEST(EventStreamTest, open) {
+	EXPECT_FALSE(EventStream::instance().open("fd:"));
+	EXPECT_FALSE(EventStream::instance().open("fd:x"));
+	EXPECT_FALSE(EventStream::instance().open("fd:-1"));
+	EXPECT_FALSE(EventStream::enabled());
+}
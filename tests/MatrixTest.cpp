@@ -233,6 +233,27 @@ TEST(MatrixTest, parse) {
 }
 
 
+TEST(MatrixTest, compiledTransformation) {
+	Calculator calc;
+	calc.setVariable("pt", 1);
+	const string cmds = "T2pt,y R90 S2";
+	CompiledTransformation trans(cmds, calc, {"ux", "uy", "w", "h", "y"});
+	for (double v : {0.0, 1.0, 2.5}) {
+		calc.setVariable("ux", v);
+		calc.setVariable("uy", 2*v);
+		calc.setVariable("w", 3*v);
+		calc.setVariable("h", 4*v);
+		calc.setVariable("y", 5*v);
+		EXPECT_EQ(trans.eval({v, 2*v, 3*v, 4*v, 5*v}), Matrix(cmds, calc));
+	}
+	EXPECT_EQ(CompiledTransformation("T1,2 R90", calc, {"ux", "uy", "w", "h"}).eval({0, 0, 2, 4}), Matrix({0, -1, 1, 1, 0, 2, 0, 0, 1}));
+	EXPECT_TRUE(CompiledTransformation("", calc).empty());
+	EXPECT_TRUE(CompiledTransformation("", calc).eval().isIdentity());
+	EXPECT_THROW(CompiledTransformation("KXa", calc, {"a"}).eval({90}), ParserException);
+	EXPECT_THROW(CompiledTransformation("R45", Calculator()), CalculatorException);  // undefined variables
+}
+
+
 TEST(MatrixTest, write) {
 	ostringstream oss;
 	Matrix m(3);
@@ -0,0 +1,111 @@
+/*************************************************************************
+** MemoryMonitorTest.cpp                                                **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "MemoryMonitor.hpp"
+#include "Profiler.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+class MemoryMonitorTest : public ::testing::Test {
+	protected:
+		void SetUp () override {
+			MemoryMonitor::ENABLED = MemoryMonitor::available();
+		}
+
+		void TearDown () override {
+			MemoryMonitor::ENABLED = false;
+			MemoryMonitor::setPageLimit(0);
+			Profiler::ENABLED = false;
+			Profiler::instance().reset();
+		}
+};
+
+
+TEST_F(MemoryMonitorTest, usage) {
+	if (!MemoryMonitor::available())
+		return;
+	MemoryMonitor::beginPage();
+	uint64_t usage = MemoryMonitor::usage();
+	{
+		vector<char> vec(1 << 20);
+		EXPECT_GE(MemoryMonitor::usage(), usage + (1 << 20));
+	}
+	EXPECT_LT(MemoryMonitor::usage(), usage + (1 << 20));
+	EXPECT_GE(MemoryMonitor::pagePeak(), uint64_t(1 << 20));
+	MemoryMonitor::beginPage();
+	EXPECT_LT(MemoryMonitor::pagePeak(), uint64_t(1 << 20));
+}
+
+
+TEST_F(MemoryMonitorTest, pageLimit) {
+	if (!MemoryMonitor::available())
+		return;
+	MemoryMonitor::setPageLimit(1 << 20);
+	MemoryMonitor::beginPage();
+	EXPECT_NO_THROW(MemoryMonitor::checkPageLimit());
+	auto vec = util::make_unique<vector<char>>(2 << 20);
+	EXPECT_THROW(MemoryMonitor::checkPageLimit(), PageMemoryException);
+	vec.reset();
+	EXPECT_NO_THROW(MemoryMonitor::checkPageLimit());
+	MemoryMonitor::setPageLimit(0);
+	vec = util::make_unique<vector<char>>(2 << 20);
+	EXPECT_NO_THROW(MemoryMonitor::checkPageLimit());
+}
+
+
+TEST_F(MemoryMonitorTest, profiler) {
+	if (!MemoryMonitor::available())
+		return;
+	Profiler::ENABLED = true;
+	Profiler::instance().reset();
+	MemoryMonitor::beginPage();
+	Profiler::instance().beginPage(1);
+	{
+		Profiler::Scope outer("outer");
+		vector<char> vec1(1 << 16);
+		{
+			Profiler::Scope inner("inner");
+			vector<char> vec2(1 << 18);
+		}
+	}
+	Profiler::instance().endPage();
+	ostringstream oss;
+	Profiler::instance().writeReport(oss, true);
+	string json = oss.str();
+	// allocations must be attributed to the innermost scope
+	size_t pos = json.find("\"outer\":{");
+	ASSERT_NE(pos, string::npos);
+	pos = json.find("\"allocated\":", pos);
+	ASSERT_NE(pos, string::npos);
+	uint64_t allocated = stoull(json.substr(pos+12));
+	EXPECT_GE(allocated, uint64_t(1 << 16));
+	EXPECT_LT(allocated, uint64_t(1 << 18));
+	pos = json.find("\"inner\":{");
+	ASSERT_NE(pos, string::npos);
+	pos = json.find("\"allocated\":", pos);
+	ASSERT_NE(pos, string::npos);
+	EXPECT_GE(stoull(json.substr(pos+12)), uint64_t(1 << 18));
+	EXPECT_NE(json.find("\"heap_peak\":"), string::npos);
+}
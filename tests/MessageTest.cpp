@@ -0,0 +1,76 @@
+/*************************************************************************
+** MessageTest.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "Message.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+class MessageTest : public ::testing::Test {
+	protected:
+		void SetUp () override {
+			_rdbuf = cerr.rdbuf(_oss.rdbuf());
+		}
+
+		void TearDown () override {
+			cerr.rdbuf(_rdbuf);
+		}
+
+		string output () const {return _oss.str();}
+
+	private:
+		ostringstream _oss;
+		streambuf *_rdbuf=nullptr;
+};
+
+
+TEST_F(MessageTest, numbers) {
+	Message::mstream() << 42 << ' ' << -7L << ' ' << 123456789012ULL << ' ' << size_t(5) << '\n';
+	Message::mstream() << 2.5 << ' ' << 1e-7 << ' ' << 1234567.0 << ' ' << 0.1f << '\n';
+	EXPECT_EQ(output(), "42 -7 123456789012 5\n2.5 1e-07 1.23457e+06 0.1\n");
+}
+
+
+TEST_F(MessageTest, workerThreads) {
+	{
+		ThreadPool pool(4);
+		for (int i=0; i < 8; i++) {
+			pool.enqueue([i]() {
+				// let later tasks finish first
+				this_thread::sleep_for(chrono::milliseconds(2*(8-i)));
+				Message::mstream() << "task " << i;
+				Message::mstream() << ", line 1\n";
+				Message::mstream() << "task " << i << ", line 2\n";
+			});
+		}
+		if (pool.numThreads() > 1) {
+			EXPECT_EQ(output(), "");
+		}
+	}
+	ostringstream expected;
+	for (int i=0; i < 8; i++)
+		expected << "task " << i << ", line 1\ntask " << i << ", line 2\n";
+	EXPECT_EQ(output(), expected.str());
+}
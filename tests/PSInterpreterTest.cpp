@@ -19,11 +19,19 @@
 *************************************************************************/
 
 #include <gtest/gtest.h>
+#include "BoundingBox.hpp"
+#include "FileSystem.hpp"
+#include "Ghostscript.hpp"
 #include "PSInterpreter.hpp"
 
+#include <fstream>
 #include <sstream>
 #include <vector>
 
+#ifndef BUILDDIR
+#define BUILDDIR "."
+#endif
+
 using namespace std;
 
 class PSTestActions : public PSActions {
@@ -192,3 +200,128 @@ TEST(PSInterpreterTest, matrix) {
 	psi.execute("10 100 translate 30 rotate matrix currentmatrix setmatrix ");
 	EXPECT_EQ(actions.result(), "translate 10 100;rotate 30;applyscalevals 1 1 0.866025;setmatrix 0.866025 0.5 -0.5 0.866025 10 100;applyscalevals 1 1 0.866025;");
 }
+
+
+/** Writes a PDF file with one page per given media box. Each page contains a stroked line.
+ *  @param[in] fname name of the file to create
+ *  @param[in] boxes media boxes of the pages */
+static void write_pdf (const string &fname, const vector<BoundingBox> &boxes) {
+	vector<string> objects{
+		"<</Type/Catalog/Pages 2 0 R>>",
+		"",  // page tree, assigned below
+		"<</Length 15>>stream\n0 0 m 50 50 l S\nendstream"
+	};
+	string kids;
+	for (const BoundingBox &box : boxes) {
+		ostringstream oss;
+		oss << "<</Type/Page/Parent 2 0 R/Contents 3 0 R/MediaBox["
+			<< box.minX() << ' ' << box.minY() << ' ' << box.maxX() << ' ' << box.maxY() << "]>>";
+		objects.push_back(oss.str());
+		kids += to_string(objects.size())+" 0 R ";
+	}
+	objects[1] = "<</Type/Pages/Kids["+kids+"]/Count "+to_string(boxes.size())+">>";
+	ostringstream pdf;
+	pdf << "%PDF-1.4\n";
+	vector<size_t> offsets;
+	for (size_t i=0; i < objects.size(); i++) {
+		offsets.push_back(size_t(pdf.tellp()));
+		pdf << i+1 << " 0 obj\n" << objects[i] << "\nendobj\n";
+	}
+	size_t xrefOffset = size_t(pdf.tellp());
+	pdf << "xref\n0 " << objects.size()+1 << "\n0000000000 65535 f \n";
+	for (size_t offset : offsets) {
+		string offsetstr = to_string(offset);
+		pdf << string(10-offsetstr.length(), '0') << offsetstr << " 00000 n \n";
+	}
+	pdf << "trailer\n<</Size " << objects.size()+1 << "/Root 1 0 R>>\nstartxref\n" << xrefOffset << "\n%%EOF\n";
+	ofstream ofs(fname, ios::binary);
+	ofs << pdf.str();
+}
+
+
+TEST(PSInterpreterTest, pdfOpen) {
+	PSTestActions actions;
+	PSInterpreter psi(&actions);
+	if (!psi.supportsPDF())  // Ghostscript not available or unable to process PDF files
+		return;
+	string fname = BUILDDIR"/pdfopen-test.pdf";
+	write_pdf(fname, {BoundingBox(0, 0, 100, 200), BoundingBox(10, 20, 300, 400)});
+	EXPECT_FALSE(psi.pdfIsOpen(fname));
+	psi.pdfOpen(fname);
+	EXPECT_TRUE(psi.pdfIsOpen(fname));
+	EXPECT_EQ(psi.pdfPageCount(fname), 2);
+	EXPECT_EQ(psi.pdfPageBox(fname, 1), BoundingBox(0, 0, 100, 200));
+	EXPECT_EQ(psi.pdfPageBox(fname, 2), BoundingBox(10, 20, 300, 400));
+	EXPECT_FALSE(psi.pdfPageBox(fname, 3).valid());
+
+	// render the pages of the open file
+	for (int pageno : {2, 1}) {
+		actions.clear();
+		psi.execute("\n"+to_string(pageno)+" @pdfpage ");
+		EXPECT_NE(actions.result().find("stroke"), string::npos) << "page " << pageno;
+	}
+	psi.pdfClose();
+	EXPECT_FALSE(psi.pdfIsOpen(fname));
+
+	// retrieve the page data without keeping the file open
+	EXPECT_EQ(psi.pdfPageCount(fname), 2);
+	EXPECT_EQ(psi.pdfPageBox(fname, 2), BoundingBox(10, 20, 300, 400));
+	FileSystem::remove(fname);
+}
+
+
+TEST(PSInterpreterTest, limitBufferedCode) {
+	if (!Ghostscript().available())
+		return;
+	PSTestActions actions;
+	PSInterpreter psi(&actions);
+	psi.execute("1 0 0 setrgbcolor ", false);  // collected but not yet executed
+	EXPECT_EQ(actions.result(), "");
+	psi.limit(22);
+	EXPECT_FALSE(psi.execute("0 0 moveto "));
+	EXPECT_EQ(actions.result(), "setrgbcolor 1 0 0;");  // collected code is not counted
+	actions.clear();
+	// the remaining 11 bytes are processed, the rest is ignored
+	EXPECT_TRUE(psi.execute("5 5 lineto undefinedoperator", false));
+	EXPECT_FALSE(psi.execute("stroke ", false));  // no limit active, code is collected
+	psi.flush();
+	EXPECT_EQ(actions.result(), "setcolorspace 0;setrgbcolor 1 0 0;newpath 0;moveto 0 0;lineto 5 5;stroke;");
+}
+
+
+TEST(PSInterpreterTest, largeChunks) {
+	if (!Ghostscript().available())
+		return;
+	PSTestActions actions;
+	PSInterpreter psi(&actions);
+	string code = "0 0 moveto ";
+	while (code.length() < 0x30000)
+		code += "% padding comment to exceed the maximal chunk size\n";
+	code += "10 10 lineto stroke ";
+	psi.execute("0 0 1 setrgbcolor ", false);
+	psi.execute(code);
+	EXPECT_EQ(actions.result(), "setrgbcolor 0 0 1;setcolorspace 0;setrgbcolor 0 0 1;newpath 0;moveto 0 0;lineto 10 10;stroke;");
+	actions.clear();
+
+	// the limit spans several chunks
+	psi.limit(code.length());
+	EXPECT_TRUE(psi.execute(code + "undefinedoperator"));
+	EXPECT_EQ(actions.result(), "setcolorspace 0;setrgbcolor 0 0 1;newpath 0;moveto 0 0;lineto 10 10;stroke;");
+	actions.clear();
+
+	istringstream iss(code);
+	psi.limit(code.length()-20);  // skip "10 10 lineto stroke "
+	EXPECT_TRUE(psi.execute(iss));
+	psi.execute("5 5 lineto stroke ");
+	EXPECT_EQ(actions.result(), "setcolorspace 0;setrgbcolor 0 0 1;newpath 0;moveto 0 0;lineto 5 5;stroke;");
+}
+
+
+TEST(PSInterpreterTest, errorInBufferedCode) {
+	if (!Ghostscript().available())
+		return;
+	PSInterpreter psi;
+	// the error is reported when the collected code is passed to Ghostscript
+	EXPECT_NO_THROW(psi.execute("0 0 moveto undefinedoperator ", false));
+	EXPECT_THROW(psi.execute("1 1 lineto "), PSException);
+}
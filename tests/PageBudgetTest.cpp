@@ -0,0 +1,84 @@
+/*************************************************************************
+** PageBudgetTest.cpp                                                   **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <sstream>
+#include "PageBudget.hpp"
+#include "SVGTree.hpp"
+
+using namespace std;
+
+class PageBudgetTest : public ::testing::Test {
+	protected:
+		void TearDown () override {
+			PageBudget::setTimeout(0);
+			PageBudget::beginPage();
+		}
+};
+
+
+TEST_F(PageBudgetTest, unlimited) {
+	PageBudget::setTimeout(0);
+	PageBudget::beginPage();
+	this_thread::sleep_for(chrono::milliseconds(2));
+	EXPECT_FALSE(PageBudget::exceeded());
+	EXPECT_EQ(PageBudget::degradations(), 0u);
+	EXPECT_EQ(PageBudget::degradationString(), "");
+}
+
+
+TEST_F(PageBudgetTest, timeout) {
+	PageBudget::setTimeout(100);
+	PageBudget::beginPage();
+	EXPECT_FALSE(PageBudget::exceeded());
+	PageBudget::setTimeout(0.001);
+	PageBudget::beginPage();
+	this_thread::sleep_for(chrono::milliseconds(5));
+	EXPECT_TRUE(PageBudget::exceeded());
+	PageBudget::beginPage();
+	EXPECT_FALSE(PageBudget::exceeded());
+}
+
+
+TEST_F(PageBudgetTest, degrade) {
+	PageBudget::beginPage();
+	EXPECT_TRUE(PageBudget::degrade(PageBudget::NO_OPTIMIZER));
+	EXPECT_FALSE(PageBudget::degrade(PageBudget::NO_OPTIMIZER));
+	EXPECT_EQ(PageBudget::degradationString(), "optimizer");
+	EXPECT_TRUE(PageBudget::degrade(PageBudget::COARSE_SHADINGS));
+	EXPECT_EQ(PageBudget::degradations(), unsigned(PageBudget::COARSE_SHADINGS | PageBudget::NO_OPTIMIZER));
+	EXPECT_EQ(PageBudget::degradationString(), "shadings,optimizer");
+	PageBudget::beginPage();
+	EXPECT_EQ(PageBudget::degradations(), 0u);
+}
+
+
+TEST_F(PageBudgetTest, reportDegradations) {
+	PageBudget::beginPage();
+	PageBudget::degrade(PageBudget::COARSE_SHADINGS);
+	SVGTree svg;
+	svg.newPage(1);
+	PageBudget::reportDegradations(svg, 1);
+	ostringstream oss;
+	svg.write(oss);
+	EXPECT_NE(oss.str().find("<!-- page degraded due to time limit: shadings -->"), string::npos);
+}
@@ -131,6 +131,23 @@ TEST(PairTest, ortho) {
 }
 
 
+TEST(PairTest, dot) {
+	ASSERT_EQ(dot(DPair(0,0), DPair(2,3)), 0);
+	ASSERT_EQ(dot(DPair(1,0), DPair(0,1)), 0);
+	ASSERT_EQ(dot(DPair(2,3), DPair(4,5)), 23);
+	ASSERT_EQ(dot(DPair(2,3), DPair(-3,2)), 0);
+	ASSERT_EQ(dot(DPair(-2,3), DPair(-2,3)), 13);
+}
+
+
+TEST(PairTest, det) {
+	ASSERT_EQ(det(DPair(1,0), DPair(0,1)), 1);
+	ASSERT_EQ(det(DPair(0,1), DPair(1,0)), -1);
+	ASSERT_EQ(det(DPair(2,3), DPair(4,5)), -2);
+	ASSERT_EQ(det(DPair(2,3), DPair(4,6)), 0);
+}
+
+
 TEST(PairTest, write) {
 	ostringstream oss;
 	DPair p(3,4);
@@ -0,0 +1,211 @@
+/*************************************************************************
+** PreScanDVIReaderTest.cpp                                             **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BoundingBox.hpp"
+#include "DVIActions.hpp"
+#include "PreScanDVIReader.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+/** Creates a minimal DVI file with a sequence of pages containing the given specials. */
+class DVIBuilder {
+	public:
+		DVIBuilder () {
+			_bytes += char(247);  // pre
+			_bytes += char(2);
+			putUnsigned(25400000, 4);
+			putUnsigned(473628672, 4);
+			putUnsigned(1000, 4);
+			_bytes += char(0);
+		}
+
+		void addPage (const vector<string> &specials) {
+			uint32_t bop = uint32_t(_bytes.size());
+			_bytes += char(139);
+			for (int i=0; i < 10; i++)
+				putUnsigned(i == 0 ? ++_numPages : 0, 4);
+			putUnsigned(_lastBop, 4);
+			_lastBop = bop;
+			for (const string &special : specials) {
+				_bytes += char(141);  // push
+				_bytes += char(132);  // set_rule
+				putUnsigned(1000, 4);
+				putUnsigned(2000, 4);
+				_bytes += char(142);  // pop
+				_bytes += char(242);  // xxx4
+				putUnsigned(uint32_t(special.length()), 4);
+				_bytes += special;
+			}
+			_bytes += char(140);  // eop
+		}
+
+		string finish () {
+			uint32_t post = uint32_t(_bytes.size());
+			_bytes += char(248);
+			putUnsigned(_lastBop, 4);
+			putUnsigned(25400000, 4);
+			putUnsigned(473628672, 4);
+			putUnsigned(1000, 4);
+			putUnsigned(0, 4);
+			putUnsigned(0, 4);
+			putUnsigned(1, 2);
+			putUnsigned(_numPages, 2);
+			_bytes += char(249);
+			putUnsigned(post, 4);
+			_bytes += char(2);
+			_bytes.append(4, char(223));
+			while (_bytes.size() % 4)
+				_bytes += char(223);
+			return _bytes;
+		}
+
+	protected:
+		void putUnsigned (uint32_t val, int n) {
+			for (int i=n-1; i >= 0; i--)
+				_bytes += char((val >> (8*i)) & 0xff);
+		}
+
+	private:
+		string _bytes;
+		uint32_t _numPages=0;
+		uint32_t _lastBop=0xffffffff;
+};
+
+
+/** Records all specials starting with "pre:" together with the current page number. */
+class RecordingActions : public DVIActions {
+	public:
+		void special (const string &s, double, bool preprocessing) override {
+			if (preprocessing)
+				specials.emplace_back(reader->currentPageNumber(), s);
+		}
+
+		bool needsPreprocessing (const string &s) const override {
+			return s.compare(0, 4, "pre:") == 0;
+		}
+
+		BoundingBox& bbox () override {return _bbox;}
+
+		BasicDVIReader *reader=nullptr;
+		vector<pair<unsigned,string>> specials;
+
+	private:
+		BoundingBox _bbox;
+};
+
+
+/** Provides access to the chunk-wise scanning with a given number of threads. */
+class ChunkedPreScanDVIReader : public PreScanDVIReader {
+	public:
+		ChunkedPreScanDVIReader (istream &is, DVIActions *actions) : PreScanDVIReader(is, actions) {}
+
+		void scan (unsigned numThreads) {
+			executePostPost();
+			vector<uint32_t> bopOffsets = collectBopOffsets();
+			ThreadPool pool(numThreads);
+			scanChunks(bopOffsets, pool);
+		}
+};
+
+
+static string create_dvi (unsigned numPages) {
+	DVIBuilder builder;
+	for (unsigned pageno=1; pageno <= numPages; pageno++) {
+		vector<string> specials{"color push Red", "color pop"};
+		if (pageno % 3 == 0)
+			specials.emplace_back("pre:a"+to_string(pageno));
+		if (pageno % 5 == 0) {
+			specials.emplace_back("pre:b"+to_string(pageno));
+			specials.emplace_back("pre:c"+to_string(pageno));
+		}
+		builder.addPage(specials);
+	}
+	return builder.finish();
+}
+
+
+TEST(PreScanDVIReaderTest, index) {
+	string dvi = create_dvi(20);
+	istringstream iss(dvi);
+	RecordingActions actions;
+	PreScanDVIReader reader(iss, &actions);
+	actions.reader = &reader;
+	reader.executeAllPages();
+	const PreScanDVIReader::SpecialIndex &index = reader.specialIndex();
+	ASSERT_EQ(index.size(), 14u);
+	ASSERT_EQ(actions.specials.size(), 14u);
+	for (size_t i=0; i < index.size(); i++) {
+		const auto &entry = index[i];
+		// the offsets must point to the special text
+		EXPECT_EQ(dvi.substr(entry.offset, entry.length), actions.specials[i].second);
+		EXPECT_EQ(entry.pageno, actions.specials[i].first);
+	}
+	EXPECT_EQ(actions.specials[0], make_pair(3u, string("pre:a3")));
+	EXPECT_EQ(actions.specials[1], make_pair(5u, string("pre:b5")));
+	EXPECT_EQ(actions.specials[2], make_pair(5u, string("pre:c5")));
+	EXPECT_EQ(actions.specials[3], make_pair(6u, string("pre:a6")));
+	EXPECT_EQ(actions.specials.back(), make_pair(20u, string("pre:c20")));
+	EXPECT_EQ(reader.currentPageNumber(), 20u);
+}
+
+
+TEST(PreScanDVIReaderTest, noPreprocessing) {
+	string dvi = create_dvi(10);
+	istringstream iss(dvi);
+	DVIActions *actions = nullptr;
+	PreScanDVIReader reader(iss, actions);
+	reader.executeAllPages();
+	EXPECT_TRUE(reader.specialIndex().empty());
+	EXPECT_EQ(reader.currentPageNumber(), 10u);
+}
+
+
+TEST(PreScanDVIReaderTest, chunks) {
+	string dvi = create_dvi(200);
+	size_t minChunkSize = PreScanDVIReader::MIN_CHUNK_SIZE;
+	size_t maxChunkSize = PreScanDVIReader::MAX_CHUNK_SIZE;
+	PreScanDVIReader::MIN_CHUNK_SIZE = 100;
+	PreScanDVIReader::MAX_CHUNK_SIZE = 500;
+	RecordingActions actions;
+	istringstream iss1(dvi);
+	ChunkedPreScanDVIReader reader1(iss1, &actions);
+	reader1.scan(1);
+	istringstream iss2(dvi);
+	ChunkedPreScanDVIReader reader2(iss2, &actions);
+	reader2.scan(4);
+	PreScanDVIReader::MIN_CHUNK_SIZE = minChunkSize;
+	PreScanDVIReader::MAX_CHUNK_SIZE = maxChunkSize;
+	const PreScanDVIReader::SpecialIndex &index1 = reader1.specialIndex();
+	const PreScanDVIReader::SpecialIndex &index2 = reader2.specialIndex();
+	ASSERT_EQ(index1.size(), 66u+2*40u);
+	ASSERT_EQ(index1.size(), index2.size());
+	for (size_t i=0; i < index1.size(); i++) {
+		EXPECT_EQ(index1[i].pageno, index2[i].pageno);
+		EXPECT_EQ(index1[i].offset, index2[i].offset);
+		EXPECT_EQ(index1[i].length, index2[i].length);
+		EXPECT_EQ(dvi.compare(index2[i].offset, 4, "pre:"), 0);
+	}
+	EXPECT_TRUE(actions.specials.empty());  // specials are only passed by executeAllPages()
+}
@@ -0,0 +1,109 @@
+/*************************************************************************
+** ProfilerTest.cpp                                                     **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include "Profiler.hpp"
+
+using namespace std;
+
+class ProfilerTest : public ::testing::Test {
+	protected:
+		void SetUp () override {
+			Profiler::ENABLED = true;
+			Profiler::instance().reset();
+		}
+
+		void TearDown () override {
+			Profiler::ENABLED = false;
+			Profiler::instance().reset();
+		}
+
+		static string report (bool json) {
+			ostringstream oss;
+			Profiler::instance().writeReport(oss, json);
+			return oss.str();
+		}
+};
+
+
+TEST_F(ProfilerTest, disabled) {
+	Profiler::ENABLED = false;
+	{
+		Profiler::Scope scope("phase");
+	}
+	Profiler::instance().addCount("counter", 10);
+	string json = report(true);
+	EXPECT_EQ(json.find("{\"pages\":[],"), 0u);
+	EXPECT_NE(json.find("\"phases\":{},\"counters\":{}}"), string::npos);
+}
+
+
+TEST_F(ProfilerTest, pages) {
+	Profiler::instance().beginPage(1);
+	for (int i=0; i < 3; i++)
+		Profiler::Scope scope("phase1");
+	Profiler::instance().addCount("counter", 10);
+	Profiler::instance().endPage();
+	Profiler::instance().beginPage(2);
+	{
+		Profiler::Scope scope("phase1", "sub");
+	}
+	Profiler::instance().addCount("counter", 5);
+	Profiler::instance().endPage();
+	{
+		Profiler::Scope scope("phase2");
+	}
+	string text = report(false);
+	EXPECT_NE(text.find("page 1: "), string::npos);
+	EXPECT_NE(text.find("page 2: "), string::npos);
+	EXPECT_NE(text.find("total: "), string::npos);
+	string json = report(true);
+	EXPECT_NE(json.find("{\"page\":1,"), string::npos);
+	EXPECT_NE(json.find("\"phase1\":{\"time\":"), string::npos);
+	EXPECT_NE(json.find("\"calls\":3}"), string::npos);
+	EXPECT_NE(json.find("\"counters\":{\"counter\":10}"), string::npos);
+	EXPECT_NE(json.find("{\"page\":2,"), string::npos);
+	EXPECT_NE(json.find("\"phase1:sub\":{\"time\":"), string::npos);
+	EXPECT_NE(json.find("\"counters\":{\"counter\":5}"), string::npos);
+	EXPECT_NE(json.find("\"counters\":{\"counter\":15}"), string::npos);  // total
+	EXPECT_NE(json.find("\"phase2\":{\"time\":"), string::npos);
+}
+
+
+TEST_F(ProfilerTest, nested) {
+	Profiler::instance().beginPage(1);
+	{
+		Profiler::Scope outer("outer");
+		Profiler::Scope inner("inner");
+		this_thread::sleep_for(chrono::milliseconds(20));
+	}
+	Profiler::instance().endPage();
+	string json = report(true);
+	// the time of the inner scope must not be added to the outer one
+	size_t pos = json.find("\"outer\":{\"time\":");
+	ASSERT_NE(pos, string::npos);
+	EXPECT_LT(stod(json.substr(pos+16)), 0.01);
+	pos = json.find("\"inner\":{\"time\":");
+	ASSERT_NE(pos, string::npos);
+	EXPECT_GE(stod(json.substr(pos+16)), 0.015);
+}
@@ -0,0 +1,127 @@
+/*************************************************************************
+** PsSpecialHandlerTest.cpp                                             **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include "FileSystem.hpp"
+#include "PsSpecialHandler.hpp"
+#include "SVGTree.hpp"
+#include "XMLNode.hpp"
+
+using namespace std;
+
+
+class MyPsSpecialHandler : public PsSpecialHandler {
+	public:
+		using PsSpecialHandler::bitmapID;
+};
+
+
+class PsSpecialHandlerTest : public ::testing::Test {
+	protected:
+		void TearDown () override {
+			XMLNode::KEEP_ENCODED_FILES = false;
+			for (const char *fname : {"bmp1.tmp", "bmp2.tmp", "bmp3.tmp", "bmp4.tmp", "bmp5.tmp"})
+				FileSystem::remove(fname);
+		}
+
+		static void writeFile (const char *fname, const string &contents) {
+			ofstream ofs(fname, ios::binary);
+			ofs << contents;
+		}
+
+		/** Returns the number of image elements present in the defs section. */
+		static int numImages (const SVGTree &svg) {
+			int count=0;
+			if (svg.defsNode()) {
+				for (const XMLNode *node : *svg.defsNode())
+					if (node->toElement() && node->toElement()->name() == "image")
+						count++;
+			}
+			return count;
+		}
+};
+
+
+TEST_F(PsSpecialHandlerTest, bitmapID) {
+	MyPsSpecialHandler handler;
+	SVGTree svg;
+	svg.newPage(1);
+	writeFile("bmp1.tmp", "bitmap data");
+	writeFile("bmp2.tmp", "bitmap data");
+	writeFile("bmp3.tmp", "other bitmap data");
+
+	string id1 = handler.bitmapID("bmp1.tmp", 10, 20, svg);
+	EXPECT_EQ(numImages(svg), 1);
+	const XMLElement *image = svg.defsNode()->getFirstDescendant("image", "id", id1.c_str());
+	ASSERT_NE(image, nullptr);
+	EXPECT_STREQ(image->getAttributeValue("width"), "10");
+	EXPECT_STREQ(image->getAttributeValue("height"), "20");
+	EXPECT_TRUE(FileSystem::exists("bmp1.tmp"));
+
+	// same contents: the existing image is referenced and the redundant file gets removed
+	EXPECT_EQ(handler.bitmapID("bmp2.tmp", 10, 20, svg), id1);
+	EXPECT_EQ(numImages(svg), 1);
+	EXPECT_FALSE(FileSystem::exists("bmp2.tmp"));
+	EXPECT_TRUE(FileSystem::exists("bmp1.tmp"));
+
+	// different contents: a new image is added
+	string id3 = handler.bitmapID("bmp3.tmp", 10, 20, svg);
+	EXPECT_NE(id3, id1);
+	EXPECT_EQ(numImages(svg), 2);
+	EXPECT_NE(svg.defsNode()->getFirstDescendant("image", "id", id3.c_str()), nullptr);
+	EXPECT_TRUE(FileSystem::exists("bmp3.tmp"));
+}
+
+
+TEST_F(PsSpecialHandlerTest, bitmapIDKeepFiles) {
+	MyPsSpecialHandler handler;
+	SVGTree svg;
+	svg.newPage(1);
+	XMLNode::KEEP_ENCODED_FILES = true;
+	writeFile("bmp1.tmp", "bitmap data");
+	writeFile("bmp2.tmp", "bitmap data");
+	EXPECT_EQ(handler.bitmapID("bmp1.tmp", 10, 20, svg), handler.bitmapID("bmp2.tmp", 10, 20, svg));
+	EXPECT_EQ(numImages(svg), 1);
+	// redundant files are kept if requested
+	EXPECT_TRUE(FileSystem::exists("bmp1.tmp"));
+	EXPECT_TRUE(FileSystem::exists("bmp2.tmp"));
+}
+
+
+TEST_F(PsSpecialHandlerTest, clearBitmapIDs) {
+	MyPsSpecialHandler handler;
+	SVGTree svg1;
+	svg1.newPage(1);
+	writeFile("bmp1.tmp", "bitmap data");
+	writeFile("bmp2.tmp", "bitmap data");
+	string id = handler.bitmapID("bmp1.tmp", 10, 20, svg1);
+	EXPECT_EQ(numImages(svg1), 1);
+
+	// after clearing the IDs, e.g. at the beginning of a new SVG document,
+	// the bitmap must be added to the defs section again
+	handler.clearBitmapIDs();
+	SVGTree svg2;
+	svg2.newPage(2);
+	EXPECT_EQ(handler.bitmapID("bmp2.tmp", 10, 20, svg2), id);
+	EXPECT_EQ(numImages(svg1), 1);
+	EXPECT_EQ(numImages(svg2), 1);
+	EXPECT_TRUE(FileSystem::exists("bmp2.tmp"));
+}
@@ -0,0 +1,109 @@
+/*************************************************************************
+** SVGTreeTest.cpp                                                      **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CharSet.hpp"
+#include "Font.hpp"
+#include "SVGTree.hpp"
+#include "ttf/TTFWriter.hpp"
+
+#ifndef SRCDIR
+#define SRCDIR "."
+#endif
+
+using namespace std;
+
+
+/** Appends the glyphs of the given fonts to a new SVG tree and returns the resulting SVG document.
+ *  @param[in] fontchars fonts together with the glyph indexes to append
+ *  @param[in] numPages number of pages to create, each containing the glyphs
+ *  @param[in] numThreads number of threads used to extract the glyph outlines */
+static string append_glyphs (const vector<SVGTree::FontChars> &fontchars, int numPages, unsigned numThreads) {
+	ostringstream oss;
+	SVGTree svg(numThreads);
+	for (int i=1; i <= numPages; i++) {
+		svg.reset();
+		svg.newPage(i);
+		svg.append(fontchars);
+		svg.write(oss);
+	}
+	return oss.str();
+}
+
+
+TEST(SVGTreeTest, parallelGlyphExtraction) {
+	NativeFontImpl font1(SRCDIR"/data/lmmono12-regular.otf", "lmmono12", 12);
+	NativeFontImpl font2(SRCDIR"/data/cmr10.pfb", "cmr10", 10);
+	CharSet chars1, chars2;
+	for (int i=2; i < 60; i++) {
+		chars1.insert(i);
+		chars2.insert(i+10);
+	}
+	vector<SVGTree::FontChars> fontchars{{&font1, &chars1}, {&font2, &chars2}, {&font1, &chars2}};
+	for (bool useFonts : {true, false}) {
+		bool prevUseFonts = SVGTree::USE_FONTS;
+		bool prevCreateUseElements = SVGTree::CREATE_USE_ELEMENTS;
+		SVGTree::USE_FONTS = useFonts;
+		SVGTree::CREATE_USE_ELEMENTS = !useFonts;  // embed the glyphs as path elements
+		string single = append_glyphs(fontchars, 3, 1);
+		string parallel = append_glyphs(fontchars, 3, 4);
+		SVGTree::USE_FONTS = prevUseFonts;
+		SVGTree::CREATE_USE_ELEMENTS = prevCreateUseElements;
+		EXPECT_NE(single.find(" d='"), string::npos);
+		EXPECT_EQ(parallel, single) << "useFonts=" << useFonts;
+	}
+}
+
+
+TEST(SVGTreeTest, parallelFontCompression) {
+	NativeFontImpl font1(SRCDIR"/data/lmmono12-regular.otf", "lmmono12", 12);
+	NativeFontImpl font2(SRCDIR"/data/cmr10.pfb", "cmr10", 10);
+	CharSet chars;
+	for (int i=2; i < 128; i++)
+		chars.insert(i);
+	vector<SVGTree::FontChars> fontchars{{&font1, &chars}, {&font2, &chars}};
+	bool prevUseFonts = SVGTree::USE_FONTS;
+	FontWriter::FontFormat prevFormat = SVGTree::FONT_FORMAT;
+	int prevLevel = ttf::TTFWriter::COMPRESSION_LEVEL;
+	SVGTree::USE_FONTS = true;
+	for (auto format : {FontWriter::FontFormat::TTF, FontWriter::FontFormat::WOFF, FontWriter::FontFormat::WOFF2}) {
+		SVGTree::FONT_FORMAT = format;
+		for (int level : {0, 2, 9, 11}) {
+			ttf::TTFWriter::COMPRESSION_LEVEL = level;
+			string single, parallel;
+			// the head tables contain the creation time, so compare fonts created in the same second
+			for (time_t start=0; start != time(nullptr);) {
+				start = time(nullptr);
+				single = append_glyphs(fontchars, 1, 1);
+				parallel = append_glyphs(fontchars, 1, 4);
+			}
+			if (single.find("@font-face") == string::npos)  // WOFF support disabled
+				break;
+			EXPECT_EQ(parallel, single) << "format=" << int(format) << ", level=" << level;
+		}
+	}
+	SVGTree::USE_FONTS = prevUseFonts;
+	SVGTree::FONT_FORMAT = prevFormat;
+	ttf::TTFWriter::COMPRESSION_LEVEL = prevLevel;
+}
@@ -0,0 +1,70 @@
+/*************************************************************************
+** ShadingAreaTest.cpp                                                  **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "ShadingArea.hpp"
+
+using namespace std;
+
+
+#define EXPECT_NEAR_PAIR(name, p1, p2, eps) \
+	{SCOPED_TRACE(name); expect_near_pair(p1, p2, eps);}
+
+
+static void expect_near_pair (const DPair &p1, const DPair &p2, double eps) {
+	EXPECT_NEAR(p1.x(), p2.x(), eps);
+	EXPECT_NEAR(p1.y(), p2.y(), eps);
+}
+
+
+TEST(ShadingAreaTest, axial) {
+	GraphicsPath<double> path;
+	const DPair p0(0, 0), p1(10, 0);
+	const bool extendBoth[] = {true, true};
+	const bool extendNone[] = {false, false};
+	const bool extendStart[] = {true, false};
+	// without a clipping path or page box, the extent of the shading is unknown
+	EXPECT_FALSE(axial_shading_area(p0, p1, extendBoth, {}, path));
+	EXPECT_FALSE(axial_shading_area(p0, p1, extendNone, {}, path));
+
+	vector<DPair> corners{DPair(-20, -5), DPair(30, -5), DPair(30, 5), DPair(-20, 5)};
+	ASSERT_TRUE(axial_shading_area(p0, p1, extendBoth, corners, path));
+	EXPECT_EQ(path.computeBBox(), BoundingBox(-20, -5, 30, 5));
+	ASSERT_TRUE(axial_shading_area(p0, p1, extendNone, corners, path));
+	EXPECT_EQ(path.computeBBox(), BoundingBox(0, -5, 10, 5));
+	ASSERT_TRUE(axial_shading_area(p0, p1, extendStart, corners, path));
+	EXPECT_EQ(path.computeBBox(), BoundingBox(-20, -5, 10, 5));
+	ASSERT_TRUE(axial_shading_area(p1, p0, extendStart, corners, path));
+	EXPECT_EQ(path.computeBBox(), BoundingBox(0, -5, 30, 5));
+
+	// area located beyond the end of the axis
+	corners = {DPair(20, -5), DPair(30, -5), DPair(30, 5), DPair(20, 5)};
+	EXPECT_FALSE(axial_shading_area(p0, p1, extendNone, corners, path));
+	ASSERT_TRUE(axial_shading_area(p0, p1, extendBoth, corners, path));
+	EXPECT_EQ(path.computeBBox(), BoundingBox(20, -5, 30, 5));
+
+	// diagonal axis: the painted rectangle is aligned to the axis and encloses the given area
+	corners = {DPair(0, 0), DPair(10, 0), DPair(10, 10), DPair(0, 10)};
+	ASSERT_TRUE(axial_shading_area(DPair(0, 0), DPair(10, 10), extendBoth, corners, path));
+	BoundingBox bbox = path.computeBBox();
+	EXPECT_NEAR_PAIR("min", DPair(bbox.minX(), bbox.minY()), DPair(-5, -5), 1e-9);
+	EXPECT_NEAR_PAIR("max", DPair(bbox.maxX(), bbox.maxY()), DPair(15, 15), 1e-9);
+}
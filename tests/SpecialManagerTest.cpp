@@ -29,11 +29,77 @@
 #include "NoPsSpecialHandler.hpp"
 #include "PapersizeSpecialHandler.hpp"
 #include "PdfSpecialHandler.hpp"
+#include "PsSpecialHandlerProxy.hpp"
+#include "SpecialActions.hpp"
 #include "TpicSpecialHandler.hpp"
 #include "utility.hpp"
 
 using namespace std;
 
+/** Handler recording the prefix and the argument of the processed specials. */
+class RecordingSpecialHandler : public SpecialHandler {
+	public:
+		const char* info () const override {return nullptr;}
+		const char* name () const override {return "recorder";}
+		vector<const char*> prefixes () const override {return {"rec", "rec:", "ps:", "ps::"};}
+
+		bool process (const string &prefix, istream &is, SpecialActions&) override {
+			auto pos = is.tellg();
+			string arg;
+			getline(is, arg, '\0');
+			// rewind the stream to check if seeking works
+			is.clear();
+			is.seekg(pos);
+			record = prefix + "|" + arg + "|" + char(is.get());
+			return true;
+		}
+
+		string record;
+};
+
+
+/** Handler logging the processed specials and the notifications about DVI events. */
+class EventRecordingHandler : public SpecialHandler {
+	public:
+		EventRecordingHandler (const char *name, unsigned events, string &log) : _name(name), _events(events), _log(log) {}
+		const char* info () const override {return nullptr;}
+		const char* name () const override {return _name;}
+		vector<const char*> prefixes () const override {return {_name};}
+		unsigned subscribedEvents () const override {return _events;}
+		bool process (const string&, istream&, SpecialActions&) override {_log += string(_name)+":special "; return true;}
+		void synchronize (SpecialActions&) override {_log += string(_name)+":sync ";}
+		void dviBeginPage (unsigned pageno, SpecialActions&) override {_log += string(_name)+":bop"+to_string(pageno)+" ";}
+		void dviEndPage (unsigned pageno, SpecialActions&) override {_log += string(_name)+":eop"+to_string(pageno)+" ";}
+		void dviMovedTo (double x, double y, SpecialActions&) override {_log += string(_name)+":move ";}
+
+	private:
+		const char *_name;
+		unsigned _events;
+		string &_log;
+};
+
+
+/** Handler that replaces itself by an EventRecordingHandler when processing its first special. */
+class ReplacingHandler : public SpecialHandler {
+	public:
+		explicit ReplacingHandler (string &log) : _log(log) {}
+		const char* info () const override {return nullptr;}
+		const char* name () const override {return "a";}
+		vector<const char*> prefixes () const override {return {"a"};}
+
+		bool process (const string &prefix, istream &is, SpecialActions &actions) override {
+			auto handler = util::make_unique<EventRecordingHandler>("a", 0, _log);
+			SpecialHandler *handlerPtr = handler.get();
+			SpecialManager::instance().unregisterHandler(this);
+			SpecialManager::instance().registerHandler(std::move(handler));
+			return handlerPtr->process(prefix, is, actions);
+		}
+
+	private:
+		string &_log;
+};
+
+
 class SpecialManagerTest : public ::testing::Test {
 	public:
 		SpecialManagerTest () {
@@ -86,3 +152,160 @@ TEST_F(SpecialManagerTest, info2) {
 		"tpic       TPIC specials\n";
 	EXPECT_EQ(oss.str(), expected);
 }
+
+
+TEST_F(SpecialManagerTest, dispatch) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	auto handlerPtr = util::make_unique<RecordingSpecialHandler>();
+	RecordingSpecialHandler *handler = handlerPtr.get();
+	sm.registerHandler(std::move(handlerPtr));
+	EmptySpecialActions actions;
+	EXPECT_TRUE(sm.process("rec abc", 1, actions));
+	EXPECT_EQ(handler->record, "rec|abc|a");
+	EXPECT_TRUE(sm.process("rec:  xyz", 1, actions));
+	EXPECT_EQ(handler->record, "rec:|  xyz| ");
+	EXPECT_TRUE(sm.process("ps: 1 2", 1, actions));
+	EXPECT_EQ(handler->record, "ps:| 1 2| ");
+	EXPECT_TRUE(sm.process("ps::[begin] 1 2", 1, actions));
+	EXPECT_EQ(handler->record, "ps::|[begin] 1 2|[");
+	EXPECT_FALSE(sm.process("re abc", 1, actions));
+	EXPECT_FALSE(sm.process("recx abc", 1, actions));
+	EXPECT_FALSE(sm.process("", 1, actions));
+	sm.unregisterHandler(handler);
+	EXPECT_FALSE(sm.process("rec abc", 1, actions));
+	sm.unregisterHandlers();
+}
+
+
+TEST_F(SpecialManagerTest, subscriptions) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	string log;
+	auto handlerPtr = util::make_unique<EventRecordingHandler>("a", SpecialHandler::EV_END_PAGE, log);
+	EventRecordingHandler *a = handlerPtr.get();
+	sm.registerHandler(std::move(handlerPtr));
+	handlerPtr = util::make_unique<EventRecordingHandler>("b", SpecialHandler::EV_BEGIN_PAGE|SpecialHandler::EV_END_PAGE, log);
+	EventRecordingHandler *b = handlerPtr.get();
+	sm.registerHandler(std::move(handlerPtr));
+	EmptySpecialActions actions;
+	EXPECT_FALSE(sm.trackingPosition());
+	sm.notifyBeginPage(1, actions);
+	sm.notifyPositionChange(0, 0, actions);
+	sm.notifyEndPage(1, actions);
+	EXPECT_EQ(log, "b:bop1 a:eop1 b:eop1 ");
+
+	// subscribers are notified in the order of their registration
+	log.clear();
+	sm.subscribe(b, SpecialHandler::EV_MOVE);
+	sm.subscribe(a, SpecialHandler::EV_MOVE|SpecialHandler::EV_BEGIN_PAGE);
+	sm.subscribe(a, SpecialHandler::EV_MOVE);
+	EXPECT_TRUE(sm.trackingPosition());
+	sm.notifyBeginPage(2, actions);
+	sm.notifyPositionChange(0, 0, actions);
+	EXPECT_EQ(log, "a:bop2 b:bop2 a:move b:move ");
+
+	log.clear();
+	sm.unsubscribe(a, SpecialHandler::EV_MOVE|SpecialHandler::EV_END_PAGE);
+	sm.unsubscribe(b, SpecialHandler::EV_MOVE);
+	EXPECT_FALSE(sm.trackingPosition());
+	sm.notifyPositionChange(0, 0, actions);
+	sm.notifyEndPage(2, actions);
+	EXPECT_EQ(log, "b:eop2 ");
+
+	// unregistered handlers can't subscribe
+	log.clear();
+	sm.unregisterHandler(b);
+	EventRecordingHandler c("c", SpecialHandler::EV_MOVE, log);
+	sm.subscribe(&c, SpecialHandler::EV_MOVE);
+	EXPECT_FALSE(sm.trackingPosition());
+	sm.notifyBeginPage(3, actions);
+	EXPECT_EQ(log, "a:bop3 ");
+	sm.unregisterHandlers();
+}
+
+
+TEST_F(SpecialManagerTest, synchronization) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	string log;
+	sm.registerHandler(util::make_unique<EventRecordingHandler>("a", 0, log));
+	sm.registerHandler(util::make_unique<EventRecordingHandler>("b", SpecialHandler::EV_END_PAGE, log));
+	sm.registerHandler(util::make_unique<EventRecordingHandler>("c", 0, log));
+	EmptySpecialActions actions;
+	sm.synchronize(actions);
+	EXPECT_EQ(log, "");  // no specials processed yet
+
+	// consecutive specials of a handler don't trigger a synchronization
+	sm.process("a", 1, actions);
+	sm.process("a", 1, actions);
+	sm.process("b", 1, actions);
+	sm.process("b", 1, actions);
+	EXPECT_EQ(log, "a:special a:special a:sync b:special b:special ");
+
+	// the handler about to process a special is excluded, the others are synchronized once
+	log.clear();
+	sm.process("a", 1, actions);
+	sm.process("c", 1, actions);
+	EXPECT_EQ(log, "b:sync a:special a:sync c:special ");
+
+	// synchronization before a DVI command and at the end of the page
+	log.clear();
+	sm.synchronize(actions);
+	sm.synchronize(actions);
+	sm.process("b", 1, actions);
+	sm.notifyEndPage(1, actions);
+	EXPECT_EQ(log, "c:sync b:special b:sync b:eop1 ");
+	log.clear();
+	sm.notifyEndPage(2, actions);
+	EXPECT_EQ(log, "b:eop2 ");
+	sm.unregisterHandlers();
+}
+
+
+TEST_F(SpecialManagerTest, replaceHandler) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	string log;
+	sm.registerHandler(util::make_unique<ReplacingHandler>(log));
+	sm.registerHandler(util::make_unique<EventRecordingHandler>("b", 0, log));
+	EmptySpecialActions actions;
+	// the replacement must be synchronized instead of the deleted handler
+	sm.process("a", 1, actions);
+	sm.process("b", 1, actions);
+	sm.process("a", 1, actions);
+	sm.synchronize(actions);
+	EXPECT_EQ(log, "a:special a:sync b:special b:sync a:special a:sync ");
+	sm.unregisterHandlers();
+}
+
+
+TEST_F(SpecialManagerTest, replacePsHandlerProxy) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	sm.registerHandler(util::make_unique<PsSpecialHandlerProxy>(false));
+	EmptySpecialActions actions;
+	// the proxy deletes itself and forwards the first special to the actual PS handler,
+	// so only the latter must be synchronized afterwards
+	EXPECT_TRUE(sm.process("ps: 0 0 moveto", 1, actions));
+	EXPECT_TRUE(sm.process("ps: 1 1 lineto", 1, actions));
+	sm.synchronize(actions);
+	sm.notifyEndPage(1, actions);
+	sm.unregisterHandlers();
+}
+
+
+TEST_F(SpecialManagerTest, positionTracking) {
+	SpecialManager &sm = SpecialManager::instance();
+	sm.unregisterHandlers();
+	sm.registerHandlers(handlers, "");
+	EmptySpecialActions actions;
+	EXPECT_FALSE(sm.trackingPosition());
+	// the html handler tracks the position while anchors are processed on the current page
+	sm.process("html:<a href=\"#target\">", 1, actions);
+	EXPECT_TRUE(sm.trackingPosition());
+	sm.process("html:</a>", 1, actions);
+	sm.notifyEndPage(1, actions);
+	EXPECT_FALSE(sm.trackingPosition());
+	sm.unregisterHandlers();
+}
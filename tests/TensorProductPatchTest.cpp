@@ -334,3 +334,42 @@ TEST_F(TensorProductPatchTest, fail) {
 	colors.resize(5);
 	EXPECT_THROW(cp.setColors(colors, 0, nullptr), ShadingException);
 }
+
+
+TEST_F(TensorProductPatchTest, linearGradient) {
+	Matrix matrix(1);
+	Color c1, c2;
+	EXPECT_FALSE(_patch.isLinearGradient(matrix, c1, c2));
+
+	// rectangular Coons patch with colors changing horizontally
+	vector<DPair> points{
+		DPair(0, 0), DPair(0, 20), DPair(0, 40), DPair(0, 60), DPair(10, 60), DPair(20, 60),
+		DPair(30, 60), DPair(30, 40), DPair(30, 20), DPair(30, 0), DPair(20, 0), DPair(10, 0)
+	};
+	const Color red(1.0, 0.0, 0.0), blue(0.0, 0.0, 1.0);
+	vector<Color> colors{red, red, blue, blue};
+	CoonsPatch cp1(points, colors, Color::ColorSpace::RGB, 0, nullptr);
+	ASSERT_TRUE(cp1.isLinearGradient(matrix, c1, c2));
+	EXPECT_EQ(matrix, Matrix({30, 0, 0, 0, 60, 0}));
+	EXPECT_EQ(c1, red);
+	EXPECT_EQ(c2, blue);
+
+	// same patch with colors changing vertically
+	colors = {red, blue, blue, red};
+	CoonsPatch cp2(points, colors, Color::ColorSpace::RGB, 0, nullptr);
+	ASSERT_TRUE(cp2.isLinearGradient(matrix, c1, c2));
+	EXPECT_EQ(matrix, Matrix({0, 30, 0, 60, 0, 0}));
+	EXPECT_EQ(c1, red);
+	EXPECT_EQ(c2, blue);
+
+	// bilinear color interpolation
+	colors = {red, blue, red, blue};
+	CoonsPatch cp3(points, colors, Color::ColorSpace::RGB, 0, nullptr);
+	EXPECT_FALSE(cp3.isLinearGradient(matrix, c1, c2));
+
+	// non-uniform parametrization of the lower edge
+	points[10] = DPair(25, 0);
+	colors = {red, red, blue, blue};
+	CoonsPatch cp4(points, colors, Color::ColorSpace::RGB, 0, nullptr);
+	EXPECT_FALSE(cp4.isLinearGradient(matrix, c1, c2));
+}
@@ -0,0 +1,75 @@
+/*************************************************************************
+** ThreadPoolTest.cpp                                                   **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+
+TEST(ThreadPoolTest, results) {
+	ThreadPool pool(4);
+	vector<future<int>> results;
+	for (int i=0; i < 100; i++)
+		results.emplace_back(pool.enqueue([](int n) {return n*n;}, i));
+	for (int i=0; i < 100; i++)
+		EXPECT_EQ(results[i].get(), i*i);
+}
+
+
+TEST(ThreadPoolTest, singleThread) {
+	ThreadPool pool(1);
+	EXPECT_EQ(pool.numThreads(), 0u);  // tasks are processed by the calling thread
+	auto result = pool.enqueue([]() {return this_thread::get_id();});
+	EXPECT_EQ(result.get(), this_thread::get_id());
+}
+
+
+TEST(ThreadPoolTest, wait) {
+	atomic<int> count(0);
+	{
+		ThreadPool pool(3);
+		for (int i=0; i < 50; i++)
+			pool.enqueue([&count]() {++count;});
+	}
+	// the destructor waits until all tasks have been processed
+	EXPECT_EQ(count, 50);
+}
+
+
+TEST(ThreadPoolTest, exception) {
+	ThreadPool pool(2);
+	auto result1 = pool.enqueue([]() -> int {throw runtime_error("task failed");});
+	auto result2 = pool.enqueue([]() {return 42;});
+	EXPECT_THROW(result1.get(), runtime_error);
+	EXPECT_EQ(result2.get(), 42);
+}
+
+
+TEST(ThreadPoolTest, inWorkerThread) {
+	EXPECT_FALSE(ThreadPool::inWorkerThread());
+	ThreadPool pool(2);
+	EXPECT_TRUE(pool.enqueue(&ThreadPool::inWorkerThread).get());
+	ThreadPool inlinePool(1);  // tasks are processed by the calling thread
+	EXPECT_FALSE(inlinePool.enqueue(&ThreadPool::inWorkerThread).get());
+}
@@ -161,6 +161,26 @@ TEST_F(TpicSpecialTest, stroke_polyline) {
 }
 
 
+TEST_F(TpicSpecialTest, merge_polylines) {
+	SVGTree::MERGE_LINES = true;
+	handler.processSpecial("pa", "0 0");
+	handler.processSpecial("pa", "1000 1000");
+	handler.processSpecial("pa", "1000 0");
+	handler.processSpecial("fp");
+	handler.processSpecial("pa", "0 1000");
+	handler.processSpecial("pa", "1000 2000");
+	handler.processSpecial("fp");
+	handler.processSpecial("pa", "0 0");
+	handler.processSpecial("pa", "0 1000");
+	handler.processSpecial("da", "0.1");
+	SVGTree::MERGE_LINES = false;
+	EXPECT_EQ(recorder.getXMLSnippet(),
+		"<path d='M0 0L72 72V0M0 72L72 144' fill='none' stroke-linecap='round' stroke='#000'/>"
+		"<path d='M0 0V72' fill='none' stroke-linecap='round' stroke='#000' stroke-dasharray='7.2'/>"
+	);
+}
+
+
 TEST_F(TpicSpecialTest, stroke_polygon) {
 	handler.processSpecial("pa", "0 0");
 	handler.processSpecial("pa", "1000 1000");
@@ -21,7 +21,9 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <memory>
+#include "FileSystem.hpp"
 #include "utility.hpp"
 #include "XMLNode.hpp"
 
@@ -372,6 +374,39 @@ TEST(XMLNodeTest, write) {
 }
 
 
+TEST(XMLNodeTest, embedDeferredFiles) {
+	const char *fname1 = "xmlnode1.tmp";
+	const char *fname2 = "xmlnode2.tmp";
+	ofstream(fname1) << "dvisvgm";
+	ofstream(fname2) << "XMLNode";
+	XMLElement root("root");
+	auto child1 = util::make_unique<XMLElement>("child");
+	auto child2 = util::make_unique<XMLElement>("child");
+	auto child3 = util::make_unique<XMLElement>("child");
+	child1->addAttribute("@href", string("data:text/plain;base64,")+fname1);
+	child2->addAttribute("@@href", string("data:text/plain;base64,")+fname2);
+	child3->addAttribute("@href", string("data:text/plain;base64,")+fname1);
+	child3->addAttribute("@attr", "value");
+	root.append(std::move(child1));
+	root.append(std::move(child2));
+	root.append(std::move(child3));
+	root.embedDeferredFiles();
+	EXPECT_FALSE(FileSystem::exists(fname1));
+	EXPECT_TRUE(FileSystem::exists(fname2));
+	ostringstream oss;
+	root.write(oss);
+	string str = oss.str();
+	str.erase(remove(str.begin(), str.end(), '\n'), str.end());
+	EXPECT_EQ(str,
+		"<root>"
+		"<child href='data:text/plain;base64,ZHZpc3ZnbQ=='/>"
+		"<child href='data:text/plain;base64,WE1MTm9kZQ=='/>"
+		"<child href='data:text/plain;base64,ZHZpc3ZnbQ==' attr='value'/>"
+		"</root>");
+	FileSystem::remove(fname2);
+}
+
+
 TEST(XMLNodeTest, cdata) {
 	XMLElement root("root");
 	auto cdataNode = util::make_unique<XMLCData>("text & <text>");
@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+# This file is part of the dvisvgm package and published under the
+# terms of the GNU General Public License version 3 or later.
+# See file COPYING for further details.
+# Copyright (C) 2024 Martin Gieseking <martin.gieseking@uos.de>
+
+# Creates the synthetic DVI files used by run-bench. The documents only depend
+# on font cmr10 (TFM and PFB taken from the test data directory), so they can be
+# converted without a TeX installation. All content is derived from a fixed
+# random seed in order to get reproducible workloads.
+#
+# usage: gencorpus.py <datadir> <outdir>
+
+import os
+import random
+import shutil
+import struct
+import sys
+
+PT = 65536       # TeX point in DVI units (sp)
+DESIGN_SIZE = 10*PT
+
+
+def tfm_info (fname):
+    """Returns the checksum and the character widths (fix_word) of a TFM file."""
+    with open(fname, 'rb') as f:
+        data = f.read()
+    lf, lh, bc, ec, nw = struct.unpack('>5H', data[0:10])
+    checksum = struct.unpack('>I', data[24:28])[0]
+    charinfo = 24+4*lh
+    widths = 24+4*(lh+ec-bc+1)
+    result = {}
+    for c in range(bc, ec+1):
+        index = data[charinfo+4*(c-bc)]
+        if index > 0:
+            result[c] = struct.unpack('>i', data[widths+4*index:widths+4*index+4])[0]
+    return checksum, result
+
+
+class DVIWriter:
+    """Writes a DVI file with a minimal set of commands."""
+    def __init__ (self, fname):
+        self.fname = fname
+        self.buf = bytearray([247, 2])
+        self.buf += struct.pack('>III', 25400000, 473628672, 1000)
+        self.buf += bytes([0])
+        self.fonts = {}
+        self.defined = set()
+        self.prevbop = -1
+        self.pages = 0
+        self.depth = self.maxdepth = 0
+
+    def define_font (self, num, name, checksum, size=DESIGN_SIZE):
+        self.fonts[num] = (name, checksum, size)
+
+    def _fnt_def (self, num):
+        name, checksum, size = self.fonts[num]
+        self.buf += bytes([243, num])+struct.pack('>IiiBB', checksum, size, DESIGN_SIZE, 0, len(name))+name.encode()
+
+    def bop (self):
+        bop = len(self.buf)
+        self.pages += 1
+        self.buf += bytes([139])+struct.pack('>10i', self.pages, *([0]*9))+struct.pack('>i', self.prevbop)
+        self.prevbop = bop
+
+    def eop (self):
+        self.buf += bytes([140])
+
+    def font (self, num):
+        if num not in self.defined:
+            self._fnt_def(num)
+            self.defined.add(num)
+        self.buf += bytes([171+num] if num < 64 else [235, num])
+
+    def char (self, c):
+        self.buf += bytes([c] if c < 128 else [128, c])
+
+    def right (self, dx):
+        self.buf += bytes([146])+struct.pack('>i', int(dx))
+
+    def down (self, dy):
+        self.buf += bytes([160])+struct.pack('>i', int(dy))
+
+    def push (self):
+        self.buf += bytes([141])
+        self.depth += 1
+        self.maxdepth = max(self.depth, self.maxdepth)
+
+    def pop (self):
+        self.buf += bytes([142])
+        self.depth -= 1
+
+    def set_rule (self, height, width):
+        self.buf += bytes([132])+struct.pack('>ii', int(height), int(width))
+
+    def put_rule (self, height, width):
+        self.buf += bytes([137])+struct.pack('>ii', int(height), int(width))
+
+    def special (self, text):
+        text = text.encode()
+        if len(text) < 256:
+            self.buf += bytes([239, len(text)])+text
+        else:
+            self.buf += bytes([242])+struct.pack('>I', len(text))+text
+
+    def close (self):
+        post = len(self.buf)
+        self.buf += bytes([248])+struct.pack('>iIIIiiHH', self.prevbop, 25400000, 473628672, 1000, 50*72*PT, 40*72*PT, self.maxdepth, self.pages)
+        for num in sorted(self.fonts):
+            self._fnt_def(num)
+        self.buf += bytes([249])+struct.pack('>i', post)+bytes([2])
+        self.buf += bytes([223]*(4+(4-(len(self.buf)+4) % 4) % 4))
+        with open(self.fname, 'wb') as f:
+            f.write(self.buf)
+
+
+def words (rnd, count):
+    for _ in range(count):
+        yield [rnd.randint(97, 122) for _ in range(rnd.randint(2, 9))]
+
+
+def text_line (dvi, rnd, numwords=12):
+    dvi.push()
+    for word in words(rnd, numwords):
+        for c in word:
+            dvi.char(c)
+        dvi.right(3.33*PT)
+    dvi.pop()
+    dvi.down(12*PT)
+
+
+def text_dense (outdir, checksum):
+    """one page densely filled with text"""
+    rnd = random.Random(1)
+    dvi = DVIWriter(os.path.join(outdir, 'text.dvi'))
+    dvi.define_font(0, 'cmr10', checksum)
+    dvi.bop()
+    dvi.font(0)
+    for _ in range(80):
+        text_line(dvi, rnd, 16)
+    dvi.eop()
+    dvi.close()
+
+
+def rules_tpic (outdir):
+    """one page with thousands of rules, tpic polylines and em:lines"""
+    rnd = random.Random(2)
+    dvi = DVIWriter(os.path.join(outdir, 'rules.dvi'))
+    dvi.bop()
+    for row in range(60):
+        dvi.push()
+        for col in range(60):
+            if col % 2:
+                dvi.set_rule(rnd.uniform(0.2, 4)*PT, rnd.uniform(0.2, 4)*PT)
+            else:
+                dvi.put_rule(rnd.uniform(0.2, 4)*PT, rnd.uniform(0.2, 4)*PT)
+            dvi.right(2*PT)
+        dvi.pop()
+        dvi.down(5*PT)
+    for i in range(500):
+        dvi.push()
+        dvi.right(rnd.uniform(0, 400)*PT)
+        dvi.special('pn {}'.format(rnd.randint(4, 20)))
+        for _ in range(6):
+            dvi.special('pa {} {}'.format(rnd.randint(0, 800), rnd.randint(0, 800)))
+        if i % 2:
+            dvi.special('sh 0.5')
+        dvi.special('fp')
+        dvi.pop()
+    for i in range(1, 1001):
+        dvi.push()
+        dvi.right(rnd.uniform(0, 400)*PT)
+        dvi.down(rnd.uniform(-300, 0)*PT)
+        dvi.special('em:point {}'.format(i))
+        dvi.pop()
+    for i in range(1, 1000):
+        dvi.special('em:line {},{},{}pt'.format(i, i+1, rnd.uniform(0.2, 1)))
+    dvi.eop()
+    dvi.close()
+
+
+def virtual_font (outdir, datadir, checksum, widths):
+    """one page of text typeset with a virtual font whose characters consist of several DVI commands"""
+    name = 'bvf10'
+    shutil.copyfile(os.path.join(datadir, 'cmr10.tfm'), os.path.join(outdir, name+'.tfm'))
+    vf = bytearray([247, 202, 0])+struct.pack('>Ii', checksum, 10 << 20)
+    vf += bytes([243, 0])+struct.pack('>IiiBB', checksum, 1 << 20, 10 << 20, 0, 5)+b'cmr10'
+    for c in sorted(widths):
+        w = widths[c]
+        # DVI lengths in VF packets are fix_words relative to the design size
+        packet = bytearray([141, c, 142, 141])        # push, set_char c, pop, push
+        packet += bytes([160])+struct.pack('>i', 1 << 16)      # down4
+        packet += bytes([137])+struct.pack('>ii', 1 << 14, w)  # put_rule
+        packet += bytes([142, 146])+struct.pack('>i', w)       # pop, right4
+        vf += bytes([len(packet), c])+struct.pack('>I', w & 0xffffff)[1:]+packet
+    vf += bytes([248]*(4-len(vf) % 4))
+    with open(os.path.join(outdir, name+'.vf'), 'wb') as f:
+        f.write(vf)
+    rnd = random.Random(3)
+    dvi = DVIWriter(os.path.join(outdir, 'vf.dvi'))
+    dvi.define_font(0, name, checksum)
+    dvi.bop()
+    dvi.font(0)
+    for _ in range(60):
+        text_line(dvi, rnd, 14)
+    dvi.eop()
+    dvi.close()
+
+
+def ps_paths (outdir):
+    """one page with thousands of simple PostScript paths"""
+    rnd = random.Random(4)
+    dvi = DVIWriter(os.path.join(outdir, 'pspaths.dvi'))
+    dvi.bop()
+    for _ in range(300):
+        code = []
+        for i in range(10):
+            pts = ' '.join('{:.2f}'.format(rnd.uniform(0, 500)) for _ in range(10))
+            color = ' '.join('{:.2f}'.format(rnd.random()) for _ in range(3))
+            p = pts.split()
+            code.append('newpath {} {} moveto {} {} lineto {} {} {} {} {} {} curveto closepath {} setrgbcolor {}'.format(
+                *p, color, 'fill' if i % 2 else 'stroke'))
+        dvi.special('ps: '+' '.join(code))
+    dvi.eop()
+    dvi.close()
+
+
+def mesh_shadings (outdir):
+    """one page with free-form triangle and Coons patch mesh shadings"""
+    rnd = random.Random(5)
+    dvi = DVIWriter(os.path.join(outdir, 'shading.dvi'))
+    dvi.bop()
+    n = 30
+    data = []
+    for i in range(n):
+        for j in range(n):
+            x, y = 10*i, 10*j
+            for vx, vy in ((x, y), (x+10, y), (x, y+10), (x+10, y), (x+10, y+10), (x, y+10)):
+                data.append('0 {} {} {:.3f} {:.3f} {:.3f}'.format(vx, vy, rnd.random(), rnd.random(), rnd.random()))
+    dvi.special('ps: gsave << /ShadingType 4 /ColorSpace /DeviceRGB /DataSource [{}] >> shfill grestore'.format(' '.join(data)))
+    n = 15
+    data = []
+    for i in range(n):
+        for j in range(n):
+            x, y = 310+20*i, 20*j
+            pts = [(x, y), (x, y+7), (x+3, y+13), (x, y+20), (x+7, y+20), (x+13, y+17), (x+20, y+20),
+                   (x+20, y+13), (x+17, y+7), (x+20, y), (x+13, y), (x+7, y+3)]
+            data.append('0 '+' '.join('{} {}'.format(*p) for p in pts)+' '+' '.join(
+                '{:.3f} {:.3f} {:.3f}'.format(rnd.random(), rnd.random(), rnd.random()) for _ in range(4)))
+    dvi.special('ps: gsave << /ShadingType 6 /ColorSpace /DeviceRGB /DataSource [{}] >> shfill grestore'.format(' '.join(data)))
+    dvi.eop()
+    dvi.close()
+
+
+def clip_paths (outdir):
+    """one page with many clipped graphics"""
+    rnd = random.Random(6)
+    dvi = DVIWriter(os.path.join(outdir, 'clip.dvi'))
+    dvi.bop()
+    for _ in range(40):
+        code = []
+        for _ in range(50):
+            x, y, r = rnd.uniform(0, 500), rnd.uniform(0, 500), rnd.uniform(5, 30)
+            code.append('gsave newpath {0:.2f} {1:.2f} {2:.2f} 0 360 arc clip newpath {3:.2f} {4:.2f} moveto {5:.2f} 0 rlineto 0 {5:.2f} rlineto '
+                        '{6:.2f} 0 rlineto closepath {7:.2f} setgray fill grestore'.format(x, y, r, x-r/2, y-r/2, 2*r, -2*r, rnd.random()))
+        dvi.special('ps: '+' '.join(code))
+    dvi.eop()
+    dvi.close()
+
+
+def book (outdir, checksum):
+    """many pages with text, rules and color specials"""
+    rnd = random.Random(7)
+    dvi = DVIWriter(os.path.join(outdir, 'book.dvi'))
+    dvi.define_font(0, 'cmr10', checksum)
+    for _ in range(100):
+        dvi.bop()
+        dvi.font(0)
+        dvi.push()
+        dvi.put_rule(0.4*PT, 345*PT)
+        dvi.pop()
+        dvi.down(14*PT)
+        for line in range(45):
+            if line % 9 == 0:
+                dvi.special('color push rgb {:.2f} {:.2f} {:.2f}'.format(rnd.random(), rnd.random(), rnd.random()))
+                text_line(dvi, rnd)
+                dvi.special('color pop')
+            else:
+                text_line(dvi, rnd)
+        dvi.eop()
+    dvi.close()
+
+
+def glyph_set (outdir, datadir, checksum):
+    """
+    Many fonts with all glyphs used. They are all mapped to the same font file
+    in order to simulate the subfonts of a CJK font with a large glyph set.
+    """
+    numfonts = 64
+    with open(os.path.join(outdir, 'glyphs.map'), 'w') as f:
+        for i in range(numfonts):
+            name = 'bcjk{:02d}'.format(i)
+            shutil.copyfile(os.path.join(datadir, 'cmr10.tfm'), os.path.join(outdir, name+'.tfm'))
+            f.write('{} CMR10 <cmr10.pfb\n'.format(name))
+    dvi = DVIWriter(os.path.join(outdir, 'glyphs.dvi'))
+    for i in range(numfonts):
+        dvi.define_font(i, 'bcjk{:02d}'.format(i), checksum)
+    for page in range(numfonts//8):
+        dvi.bop()
+        for i in range(8*page, 8*page+8):
+            dvi.font(i)
+            for c in range(0, 128, 32):
+                dvi.push()
+                for cc in range(c, c+32):
+                    dvi.char(cc)
+                dvi.pop()
+                dvi.down(12*PT)
+        dvi.eop()
+    dvi.close()
+
+
+if len(sys.argv) < 3:
+    print('usage: gencorpus.py <datadir> <outdir>')
+    sys.exit(1)
+
+datadir, outdir = sys.argv[1:3]
+os.makedirs(outdir, exist_ok=True)
+for fname in ('cmr10.tfm', 'cmr10.pfb'):
+    shutil.copyfile(os.path.join(datadir, fname), os.path.join(outdir, fname))
+checksum, widths = tfm_info(os.path.join(datadir, 'cmr10.tfm'))
+text_dense(outdir, checksum)
+rules_tpic(outdir)
+virtual_font(outdir, datadir, checksum, widths)
+ps_paths(outdir)
+mesh_shadings(outdir)
+clip_paths(outdir)
+book(outdir, checksum)
+glyph_set(outdir, datadir, checksum)
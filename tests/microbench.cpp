@@ -0,0 +1,190 @@
+/*************************************************************************
+** microbench.cpp                                                       **
+**                                                                      **
+** This file is part of dvisvgm -- a fast DVI to SVG converter          **
+** Copyright (C) 2005-2024 Martin Gieseking <martin.gieseking@uos.de>   **
+**                                                                      **
+** This program is free software; you can redistribute it and/or        **
+** modify it under the terms of the GNU General Public License as       **
+** published by the Free Software Foundation; either version 3 of       **
+** the License, or (at your option) any later version.                  **
+**                                                                      **
+** This program is distributed in the hope that it will be useful, but  **
+** WITHOUT ANY WARRANTY; without even the implied warranty of           **
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the         **
+** GNU General Public License for more details.                         **
+**                                                                      **
+** You should have received a copy of the GNU General Public License    **
+** along with this program; if not, see <http://www.gnu.org/licenses/>. **
+*************************************************************************/
+
+/* Microbenchmarks of some frequently called low-level functions. Each benchmark
+ * is repeated until it has run for at least the given minimum time. The results
+ * are reported as time and number of heap allocations per operation. The allocations
+ * are counted by the allocation functions of MemoryMonitor if they are available on
+ * the platform.
+ * usage: microbench [min. seconds per benchmark] [name filter] */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FontCache.hpp"
+#include "GraphicsPath.hpp"
+#include "InputBuffer.hpp"
+#include "InputReader.hpp"
+#include "MemoryMonitor.hpp"
+#include "XMLNode.hpp"
+#include "XMLString.hpp"
+#include "utility.hpp"
+
+using namespace std;
+
+/** Runs a benchmark and prints its results.
+ *  @param[in] name name of the benchmark
+ *  @param[in] ops number of operations performed by a single call of f
+ *  @param[in] minTime minimum time in seconds to run the benchmark
+ *  @param[in] f function performing the operations */
+template <typename F>
+static void run (const char *name, size_t ops, double minTime, F f) {
+	using Clock = chrono::steady_clock;
+	f();  // warm-up
+	uint64_t calls=0;
+	uint64_t allocs = MemoryMonitor::numAllocations();
+	uint64_t bytes = MemoryMonitor::allocatedBytes();
+	double time=0;
+	auto start = Clock::now();
+	do {
+		f();
+		calls++;
+		time = chrono::duration<double>(Clock::now()-start).count();
+	} while (time < minTime);
+	double numops = double(calls*ops);
+	cout << left << setw(28) << name << right << fixed
+		<< setw(12) << setprecision(1) << time*1e9/numops << " ns/op"
+		<< setw(10) << setprecision(2) << (MemoryMonitor::numAllocations()-allocs)/numops << " allocs/op"
+		<< setw(12) << setprecision(1) << (MemoryMonitor::allocatedBytes()-bytes)/numops << " bytes/op\n";
+}
+
+
+static bool selected (const char *name, const char *filter) {
+	return !filter || strstr(name, filter);
+}
+
+
+/** Reads the tokens of a sequence of "number int word" triples. */
+template <typename Reader>
+static void parse_tokens (Reader &ir) {
+	double x;
+	while (!ir.eof()) {
+		ir.parseDouble(x);
+		ir.skipSpace();
+		ir.getInt();
+		ir.skipSpace();
+		ir.getWord();
+		ir.skipSpace();
+	}
+}
+
+
+int main (int argc, char *argv[]) {
+	double minTime = argc > 1 ? atof(argv[1]) : 0.5;
+	const char *filter = argc > 2 ? argv[2] : nullptr;
+	MemoryMonitor::ENABLED = MemoryMonitor::COUNT_ALLOCATIONS = MemoryMonitor::available();
+	mt19937 rng(42);
+	uniform_real_distribution<double> dist(-1000, 1000);
+
+	if (selected("XMLString(double)", filter)) {
+		vector<double> values(1000);
+		for (double &val : values)
+			val = dist(rng);
+		size_t len=0;
+		run("XMLString(double)", values.size(), minTime, [&]() {
+			for (double val : values)
+				len += XMLString(val).length();
+		});
+	}
+	if (selected("GraphicsPath::writeSVG", filter)) {
+		GraphicsPath<double> path;
+		for (int i=0; i < 100; i++) {
+			path.moveto(dist(rng), dist(rng));
+			for (int j=0; j < 5; j++)
+				path.lineto(dist(rng), dist(rng));
+			for (int j=0; j < 3; j++)
+				path.cubicto(dist(rng), dist(rng), dist(rng), dist(rng), dist(rng), dist(rng));
+			path.closepath();
+		}
+		ostringstream oss;
+		run("GraphicsPath::writeSVG", 1, minTime, [&]() {
+			oss.str("");
+			path.writeSVG(oss, false);
+		});
+	}
+	if (selected("XMLElement::write", filter)) {
+		XMLElement root("g");
+		for (int i=0; i < 1000; i++) {
+			auto elem = util::make_unique<XMLElement>("use");
+			elem->addAttribute("x", dist(rng));
+			elem->addAttribute("y", dist(rng));
+			elem->addAttribute("xlink:href", "#g1-"+to_string(i%100));
+			root.append(std::move(elem));
+		}
+		ostringstream oss;
+		run("XMLElement::write", 1, minTime, [&]() {
+			oss.str("");
+			root.write(oss);
+		});
+	}
+	if (selected("FontCache::read", filter)) {
+		FontCache cache;
+		for (int c=0; c < 256; c++) {
+			Glyph glyph;
+			glyph.moveto(c, 0);
+			for (int i=0; i < 20; i++)
+				glyph.cubicto(c+i, i, c+2*i, 3*i, c+3*i, 2*i);
+			glyph.closepath();
+			cache.setGlyph(c, glyph);
+		}
+		ostringstream oss;
+		cache.write("benchfont", oss);
+		string data = oss.str();
+		run("FontCache::read", 1, minTime, [&]() {
+			FontCache readCache;
+			istringstream iss(data);
+			readCache.read("benchfont", iss);
+		});
+	}
+	if (selected("base64_copy", filter)) {
+		vector<char> bytes(64*1024);
+		for (char &c : bytes)
+			c = char(rng());
+		string result;
+		result.reserve(bytes.size()*4/3+4);
+		run("base64_copy (64 KB)", 1, minTime, [&]() {
+			result.clear();
+			util::base64_copy(bytes.begin(), bytes.end(), back_inserter(result));
+		});
+	}
+	if (selected("InputReader", filter)) {
+		ostringstream oss;
+		for (int i=0; i < 1000; i++)
+			oss << dist(rng) << ' ' << int(dist(rng)) << " moveto ";
+		string input = oss.str();
+		run("InputReader (parse)", 1000, minTime, [&]() {
+			StringInputBuffer ib(input);
+			BufferInputReader ir(ib);
+			parse_tokens(ir);
+		});
+		run("CharInputReader (parse)", 1000, minTime, [&]() {
+			CharInputReader ir(input);
+			parse_tokens(ir);
+		});
+	}
+	return 0;
+}